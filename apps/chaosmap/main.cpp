@@ -0,0 +1,81 @@
+#include <doubleswing/chaos_map.hpp>
+#include <doubleswing/image_io.hpp>
+
+#include "../common/engine_args.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: doubleswing_chaosmap [options] --out FILE(.png|.pfm|.f32)\n"
+        "  --width N --height N        grid size (default 512x512)\n"
+        "  --th1-min/--th1-max RAD     th1 range along x (default -pi..pi)\n"
+        "  --th2-min/--th2-max RAD     th2 range along y (default -pi..pi)\n"
+        "  --tmax S --dt S             horizon and step (default 10, 1/240)\n"
+        "  --l1 --l2 --m1 --m2 --g --damping\n"
+        "  --tile N --threads N        tile edge, worker count (0 = all cores)\n"
+        "  --backend auto|scalar|avx2|avx512\n"
+        "  --quiet                     no progress on stderr\n");
+}
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    if (args.has("help") || !args.has("out")) {
+        usage();
+        return args.has("help") ? 0 : 2;
+    }
+
+    ds::ChaosMapConfig cfg;
+    cfg.width   = args.count("width", cfg.width);
+    cfg.height  = args.count("height", cfg.height);
+    cfg.th1_min = args.num("th1-min", cfg.th1_min);
+    cfg.th1_max = args.num("th1-max", cfg.th1_max);
+    cfg.th2_min = args.num("th2-min", cfg.th2_min);
+    cfg.th2_max = args.num("th2-max", cfg.th2_max);
+    cfg.t_max   = args.num("tmax", cfg.t_max);
+    cfg.dt      = args.num("dt", cfg.dt);
+    cfg.tile    = args.count("tile", cfg.tile);
+    cfg.threads = static_cast<unsigned>(args.count("threads", cfg.threads));
+    cfg.p = params_from_args(args, cfg.p);
+    cfg.backend = backend_from_args(args);
+    const bool quiet = args.has("quiet");
+    if (!args.check()) return 2;
+    if (!(cfg.dt > 0.0)) {
+        std::fprintf(stderr, "--dt must be > 0\n");
+        return 2;
+    }
+
+    int last_pct = -1;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const ds::ChaosMap m = ds::chaos_map(cfg, [&](std::size_t done, std::size_t total) {
+        const int pct = int(100 * done / total);
+        if (quiet || pct == last_pct) return;
+        last_pct = pct;
+        std::fprintf(stderr, "\r%3d%% (%zu/%zu tiles)", pct, done, total);
+    });
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!quiet) std::fprintf(stderr, "\n%zux%zu in %.2f s\n", m.width, m.height, secs);
+
+    const std::string out = args.str("out");
+    bool ok;
+    if (ends_with(out, ".png"))      ok = ds::write_chaos_map_png(out, m);
+    else if (ends_with(out, ".f32")) ok = ds::write_raw_f32(out, m.width, m.height, m.flip_time.data());
+    else                             ok = ds::write_pfm(out, m.width, m.height, m.flip_time.data());
+
+    if (!ok) {
+        std::fprintf(stderr, "failed to write %s\n", out.c_str());
+        return 1;
+    }
+    return 0;
+}
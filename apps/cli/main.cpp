@@ -0,0 +1,288 @@
+// Headless batch runner: steps ds::Engine as fast as possible and streams samples.
+//
+// Every --every steps one record is written:
+//   t, th1, w1, th2, w2, x1, y1, x2, y2, ke, pe, e
+// CSV has a header line. Binary is a 16-byte header ("DSREC001", u32 field count,
+// u32 reserved) followed by little-endian float64 records. Memory use is one output
+// buffer regardless of run length. --format traj / trajq write only the states as a
+// trajectory file (trajectory.hpp), raw or quantized. --replay plays back a session
+// recording (replay.hpp) instead of simulating from the options.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/replay.hpp>
+#include <doubleswing/trajectory.hpp>
+
+#include "../common/engine_args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: doubleswing_cli [config-file] [options]\n"
+        "  --l1 --l2 --m1 --m2 --g --damping     params (default 1, 1, 1, 1, 9.80665, 0)\n"
+        "  --th1 --w1 --th2 --w2                 initial state (default th1 = th2 = 1)\n"
+        "  --dt S          step (default 1/240)\n"
+        "  --duration S    simulated time (default 10); or --steps N\n"
+        "  --every N       write every Nth step (default 1; 0 = final state only)\n"
+        "  --format csv|bin|traj|trajq (default csv)   --precision N (CSV digits 1-17, default 10)\n"
+        "  --out FILE      default stdout\n"
+        "  --integrator rk4|midpoint|gauss4   --trig libm|identities|polynomial\n"
+        "  --linear-tol X  closed-form normal modes while the small-swing error is <= X (e.g. 1e-6)\n"
+        "  --stats         print steps/s to stderr\n"
+        "  --replay FILE   play back a session recording (e.g. doubleswing_sfml --record);\n"
+        "                  --from N starts at step N, --steps N limits the output; csv|bin only\n"
+        "Config file: 'key = value' lines using the option names without dashes.\n");
+}
+
+constexpr int FIELDS = 12;
+
+// Fixed-size output buffer; flushed with one fwrite when full.
+class Sink {
+public:
+    Sink(std::FILE* f, bool binary, int precision)
+        : f(f), binary(binary), precision(precision) { buf.reserve(CAP); }
+
+    ~Sink() { flush(); }
+
+    void header() {
+        if (binary) {
+            char h[16] = { 'D', 'S', 'R', 'E', 'C', '0', '0', '1' };
+            const std::uint32_t n = FIELDS;
+            for (int i = 0; i < 4; ++i) h[8 + i] = char(n >> (8 * i));
+            put(h, sizeof h);
+        } else {
+            const char* line = "t,th1,w1,th2,w2,x1,y1,x2,y2,ke,pe,e\n";
+            put(line, std::strlen(line));
+        }
+    }
+
+    void record(const double* v) {
+        if (binary) {
+            unsigned char b[FIELDS * 8];
+            for (int i = 0; i < FIELDS; ++i) {
+                std::uint64_t u;
+                std::memcpy(&u, &v[i], 8);
+                for (int k = 0; k < 8; ++k) b[i * 8 + k] = static_cast<unsigned char>(u >> (8 * k));
+            }
+            put(b, sizeof b);
+        } else {
+            char line[FIELDS * 32];
+            int n = 0;
+            for (int i = 0; i < FIELDS; ++i)
+                n += std::snprintf(line + n, sizeof line - n, i ? ",%.*g" : "%.*g", precision, v[i]);
+            line[n++] = '\n';
+            put(line, std::size_t(n));
+        }
+    }
+
+    bool flush() {
+        if (!buf.empty() && std::fwrite(buf.data(), 1, buf.size(), f) != buf.size()) ok = false;
+        buf.clear();
+        return ok;
+    }
+
+    [[nodiscard]] bool good() const { return ok; }
+
+private:
+    static constexpr std::size_t CAP = 1 << 20;
+
+    std::FILE* f;
+    bool binary;
+    int precision;
+    bool ok = true;
+    std::vector<char> buf;
+
+    void put(const void* p, std::size_t n) {
+        if (buf.size() + n > CAP) flush();
+        const char* c = static_cast<const char*>(p);
+        buf.insert(buf.end(), c, c + n);
+    }
+};
+
+void sample(const ds::Engine& e, double t, double* v) {
+    v[0] = t;
+    v[1] = e.s.th1; v[2] = e.s.w1;
+    v[3] = e.s.th2; v[4] = e.s.w2;
+    e.bob_positions(v[5], v[6], v[7], v[8]);
+    const auto en = e.energy_breakdown();
+    v[9] = en.ke;
+    v[10] = en.pe;
+    v[11] = en.total();
+}
+
+void print_stats(std::uint64_t steps, double secs) {
+    std::fprintf(stderr, "%llu steps in %.3f s (%.0f steps/s)\n",
+                 static_cast<unsigned long long>(steps), secs, double(steps) / secs);
+}
+
+int run_trajectory(ds::Engine& e, const std::string& out, bool quantized, double dt,
+                   std::uint64_t steps, std::uint64_t every, bool stats) {
+    ds::TrajectoryOptions opt;
+    if (quantized) opt.encoding = ds::TrajEncoding::Quantized;
+
+    ds::TrajectoryWriter w;
+    bool ok = w.open(out, e.p, 0.0, dt * double(every), opt) && w.append(e.s);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 1; i <= steps && ok; ++i) {
+        e.step(dt);
+        if (i % every == 0) ok = w.append(e.s);
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (!w.close() || !ok) {
+        std::fprintf(stderr, "cannot write %s\n", out.c_str());
+        return 1;
+    }
+    if (stats) print_stats(steps, secs);
+    return 0;
+}
+
+// Samples a recording like a simulation run; t is the recorded elapsed time.
+int run_replay(const std::string& path, std::uint64_t from, std::uint64_t max_steps, std::FILE* f,
+               bool binary, int precision, std::uint64_t every, bool stats) {
+    ds::Replayer r;
+    if (!r.open(path)) {
+        std::fprintf(stderr, "cannot read recording %s\n", path.c_str());
+        return 1;
+    }
+    if (!r.complete()) std::fprintf(stderr, "%s is truncated; replaying its first %llu steps\n",
+                                    path.c_str(), static_cast<unsigned long long>(r.total_steps()));
+
+    r.seek(from);
+    const std::uint64_t left = r.total_steps() - r.step_index();
+    const std::uint64_t steps = std::min(max_steps, left);
+
+    double rec[FIELDS];
+    const auto t0 = std::chrono::steady_clock::now();
+    Sink sink(f, binary, precision);
+    sink.header();
+    sample(r.engine(), r.time(), rec);
+    sink.record(rec);
+    for (std::uint64_t i = 1; i <= steps && sink.good(); ++i) {
+        r.advance(1);
+        if ((every != 0 && i % every == 0) || (every == 0 && i == steps)) {
+            sample(r.engine(), r.time(), rec);
+            sink.record(rec);
+        }
+    }
+    if (!sink.flush()) {
+        std::fprintf(stderr, "write failed\n");
+        return 1;
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (stats) print_stats(steps, secs);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Args args(argc, argv);
+    if (args.has("help")) {
+        usage();
+        return 0;
+    }
+    if (!args.positional.empty() && !args.merge_file(args.positional)) {
+        std::fprintf(stderr, "cannot read config %s\n", args.positional.c_str());
+        return 2;
+    }
+
+    const ds::Params p = params_from_args(args, ds::Params{1.0, 1.0, 1.0, 1.0});
+    const ds::State s0 = state_from_args(args, ds::State{1.0, 0.0, 1.0, 0.0});
+
+    // Engine::step caps dt at 1/15 s; use the same value for the time axis
+    const double dt = std::min(args.num("dt", 1.0 / 240.0), 1.0 / 15.0);
+    const double duration = args.num("duration", 10.0);
+    const bool fixed_steps = args.has("steps");
+    const std::uint64_t max_steps = args.count("steps", 0);
+    const std::uint64_t every = args.count("every", 1);
+
+    const std::string format = args.str("format", "csv");
+    const bool binary = format == "bin";
+    const std::string out = args.str("out");
+    const std::uint64_t digits = args.count("precision", 10);
+    const bool stats = args.has("stats");
+    const bool replaying = args.has("replay");
+    const std::string replay = args.str("replay");
+    const std::uint64_t from = args.count("from", 0);
+
+    ds::Engine e(p, s0);
+    engine_options_from_args(args, e);
+    // a CSV field holds at most 17 significant digits (Sink's line buffer is sized for that)
+    if (digits < 1 || digits > 17) args.reject("precision", "1 to 17 digits");
+    const int precision = static_cast<int>(digits);
+    if (!(dt > 0.0))
+        args.reject("dt", "a step > 0");
+    else if (!(duration >= 0.0 && duration / dt < 1e18)) // NaN, negative, or a step count past uint64_t
+        args.reject("duration", "seconds >= 0, under 1e18 steps");
+    if (!args.check()) return 2;
+    if (format != "csv" && format != "bin" && format != "traj" && format != "trajq") {
+        std::fprintf(stderr, "--format must be csv, bin, traj or trajq\n");
+        return 2;
+    }
+    const std::uint64_t steps = fixed_steps ? max_steps : static_cast<std::uint64_t>(duration / dt + 0.5);
+
+    if (format == "traj" || format == "trajq") {
+        if (replaying) {
+            std::fprintf(stderr, "--replay writes csv or bin only\n");
+            return 2;
+        }
+        if (every == 0 || out.empty() || out == "-") {
+            std::fprintf(stderr, "--format %s needs --every > 0 and --out FILE\n", format.c_str());
+            return 2;
+        }
+        return run_trajectory(e, out, format == "trajq", dt, steps, every, stats);
+    }
+
+    std::FILE* f = out.empty() || out == "-" ? stdout : std::fopen(out.c_str(), binary ? "wb" : "w");
+    if (!f) {
+        std::fprintf(stderr, "cannot open %s\n", out.c_str());
+        return 1;
+    }
+
+    if (replaying) {
+        const int rc = run_replay(replay, from, fixed_steps ? max_steps : UINT64_MAX, f, binary, precision,
+                                  every, stats);
+        if (f != stdout && std::fclose(f) != 0) return 1;
+        return rc;
+    }
+
+    double rec[FIELDS];
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+        Sink sink(f, binary, precision);
+        sink.header();
+        sample(e, 0.0, rec);
+        sink.record(rec);
+
+        for (std::uint64_t i = 1; i <= steps; ++i) {
+            e.step(dt);
+            if ((every != 0 && i % every == 0) || (every == 0 && i == steps)) {
+                sample(e, double(i) * dt, rec);
+                sink.record(rec);
+                if (!sink.good()) break;
+            }
+        }
+
+        if (!sink.flush()) {
+            std::fprintf(stderr, "write failed\n");
+            if (f != stdout) std::fclose(f);
+            return 1;
+        }
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (stats) print_stats(steps, secs);
+
+    if (f != stdout && std::fclose(f) != 0) return 1;
+    return 0;
+}
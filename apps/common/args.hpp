@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+// Tiny "--key value" / "--flag" parser shared by the headless tools.
+// Every accessor marks its key as known; once a tool has read all its options,
+// check() reports the rest (misspelled or foreign options) and values that did not
+// parse, so a typo fails the run instead of silently using a default.
+class Args {
+public:
+    Args(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a.rfind("--", 0) != 0) { positional = a; continue; }
+            a = a.substr(2);
+            const auto eq = a.find('=');
+            if (eq != std::string::npos) {
+                kv[a.substr(0, eq)] = a.substr(eq + 1);
+            } else if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                kv[a] = argv[++i];
+            } else {
+                kv[a] = "";
+            }
+        }
+    }
+
+    // Adds "key = value" lines from a config file ('#' comments, blank lines ok).
+    // Keys already given on the command line win. Returns false if unreadable.
+    bool merge_file(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            line = line.substr(0, line.find('#'));
+            const auto eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            const std::string k = trim(line.substr(0, eq));
+            if (!k.empty() && !kv.count(k)) kv[k] = trim(line.substr(eq + 1));
+        }
+        return true;
+    }
+
+    bool has(const std::string& k) const {
+        seen.insert(k);
+        return kv.count(k) != 0;
+    }
+
+    std::string str(const std::string& k, const std::string& def = "") const {
+        const std::string* v = find(k);
+        return v ? *v : def;
+    }
+
+    double num(const std::string& k, double def) const {
+        const std::string* v = find(k);
+        if (!v) return def;
+        char* end = nullptr;
+        const double d = std::strtod(v->c_str(), &end);
+        if (v->empty() || *end != '\0') {
+            reject(k, "a number");
+            return def;
+        }
+        return d;
+    }
+
+    unsigned long long count(const std::string& k, unsigned long long def) const {
+        const std::string* v = find(k);
+        if (!v) return def;
+        char* end = nullptr;
+        const unsigned long long n = std::strtoull(v->c_str(), &end, 10);
+        // strtoull would wrap "-1" to a huge count
+        if (v->empty() || (*v)[0] == '-' || *end != '\0') {
+            reject(k, "a count");
+            return def;
+        }
+        return n;
+    }
+
+    // For values the caller parses itself (names, ranges): reported by check().
+    void reject(const std::string& k, const std::string& expected) const {
+        errors.insert("--" + k + ": expected " + expected + ", got '" + str(k) + "'");
+    }
+
+    // Prints every rejected value and every option nothing has read to stderr.
+    // Call after all options are read; false means the tool should exit 2.
+    bool check() const {
+        for (const std::string& e : errors) std::fprintf(stderr, "%s\n", e.c_str());
+        bool ok = errors.empty();
+        for (const auto& entry : kv) {
+            if (seen.count(entry.first)) continue;
+            std::fprintf(stderr, "unknown option --%s\n", entry.first.c_str());
+            ok = false;
+        }
+        return ok;
+    }
+
+    std::string positional;
+
+private:
+    std::map<std::string, std::string> kv;
+    mutable std::set<std::string> seen;   // keys some accessor asked for
+    mutable std::set<std::string> errors;
+
+    const std::string* find(const std::string& k) const {
+        seen.insert(k);
+        const auto it = kv.find(k);
+        return it == kv.end() ? nullptr : &it->second;
+    }
+
+    static std::string trim(const std::string& s) {
+        const auto b = s.find_first_not_of(" \t\r");
+        const auto e = s.find_last_not_of(" \t\r");
+        return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+    }
+};
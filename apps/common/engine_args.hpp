@@ -0,0 +1,86 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <doubleswing/ensemble.hpp>
+#include <doubleswing/sweep.hpp>
+
+#include "args.hpp"
+
+#include <cstdlib>
+#include <string>
+
+// Shared option names for the headless tools:
+//   --l1 --l2 --m1 --m2 --g --damping        Params
+//   --th1 --w1 --th2 --w2                    initial State
+//   --integrator rk4|midpoint|gauss4         Engine::integrator
+//   --trig libm|identities|polynomial        Engine::trig
+//   --linear-tol X                           Engine::linear_tol (0 = off)
+//   --backend auto|scalar|avx2|avx512        EnsembleEngine backend
+// and the value-or-range syntax of the grid tools ("v" or "min:max:count").
+// Unknown names are rejected through Args::reject, so they fail Args::check().
+
+inline ds::Params params_from_args(const Args& a, ds::Params p) {
+    p.l1 = a.num("l1", p.l1);
+    p.l2 = a.num("l2", p.l2);
+    p.m1 = a.num("m1", p.m1);
+    p.m2 = a.num("m2", p.m2);
+    p.g  = a.num("g", p.g);
+    p.damping = a.num("damping", p.damping);
+    return p;
+}
+
+inline ds::State state_from_args(const Args& a, ds::State s) {
+    s.th1 = a.num("th1", s.th1);
+    s.w1  = a.num("w1", s.w1);
+    s.th2 = a.num("th2", s.th2);
+    s.w2  = a.num("w2", s.w2);
+    return s;
+}
+
+inline void engine_options_from_args(const Args& a, ds::Engine& e) {
+    const std::string integ = a.str("integrator", "rk4");
+    if (integ == "rk4")           e.integrator = ds::Integrator::RK4;
+    else if (integ == "midpoint") e.integrator = ds::Integrator::ImplicitMidpoint;
+    else if (integ == "gauss4")   e.integrator = ds::Integrator::GaussLegendre4;
+    else a.reject("integrator", "rk4, midpoint or gauss4");
+
+    // absent: keep the engine's default
+    const std::string trig = a.str("trig");
+    if (trig == "libm")            e.trig = ds::TrigMode::Libm;
+    else if (trig == "identities") e.trig = ds::TrigMode::Identities;
+    else if (trig == "polynomial") e.trig = ds::TrigMode::Polynomial;
+    else if (a.has("trig"))        a.reject("trig", "libm, identities or polynomial");
+
+    e.linear_tol = a.num("linear-tol", 0.0);
+}
+
+inline ds::SimdBackend backend_from_args(const Args& a) {
+    const std::string be = a.str("backend", "auto");
+    if (be == "scalar") return ds::SimdBackend::Scalar;
+    if (be == "avx2")   return ds::SimdBackend::AVX2;
+    if (be == "avx512") return ds::SimdBackend::AVX512;
+    if (be != "auto") a.reject("backend", "auto, scalar, avx2 or avx512");
+    return ds::SimdBackend::Auto;
+}
+
+// "v" or "min:max:count" into axis (left alone if the option is absent); false if malformed
+inline bool axis_from_args(const Args& a, const char* key, ds::SweepAxis& axis) {
+    if (!a.has(key)) return true;
+    const std::string v = a.str(key);
+    const char* s = v.c_str();
+    char* end = nullptr;
+    const double lo = std::strtod(s, &end);
+    if (end == s) return false;
+    if (*end == '\0') {
+        axis = ds::SweepAxis(lo);
+        return true;
+    }
+    if (*end != ':') return false;
+    s = end + 1;
+    const double hi = std::strtod(s, &end);
+    if (end == s || *end != ':') return false;
+    s = end + 1;
+    const unsigned long long n = std::strtoull(s, &end, 10);
+    if (end == s || *end != '\0' || n == 0) return false;
+    axis = ds::SweepAxis(lo, hi, std::size_t(n));
+    return true;
+}
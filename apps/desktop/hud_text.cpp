@@ -0,0 +1,67 @@
+#include "hud_text.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+void HudText::set_font(const sf::Font* f, unsigned character_size, sf::Color c) {
+    font = f;
+    size = character_size;
+    color = c;
+    built[0] = '\0';
+    rebuild();
+}
+
+void HudText::printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(text, CAPACITY, fmt, ap);
+    va_end(ap);
+
+    if (std::strcmp(text, built) != 0) rebuild();
+}
+
+void HudText::rebuild() {
+    std::memcpy(built, text, CAPACITY);
+    quads.clear(); // keeps the vertex storage
+    if (!font) return;
+
+    // same layout as sf::Text: first baseline at one character size, advance + kerning
+    const float line = font->getLineSpacing(size);
+    float x = 0.f, y = float(size);
+    sf::Uint32 prev = 0;
+
+    for (const char* p = built; *p; ++p) {
+        const auto ch = sf::Uint32(static_cast<unsigned char>(*p));
+        if (ch == '\n') {
+            x = 0.f;
+            y += line;
+            prev = 0;
+            continue;
+        }
+        x += font->getKerning(prev, ch, size);
+        prev = ch;
+
+        const sf::Glyph& g = font->getGlyph(ch, size, false);
+        const float l = x + g.bounds.left, t = y + g.bounds.top;
+        const float r = l + g.bounds.width, b = t + g.bounds.height;
+        const float u0 = float(g.textureRect.left), v0 = float(g.textureRect.top);
+        const float u1 = u0 + float(g.textureRect.width), v1 = v0 + float(g.textureRect.height);
+
+        quads.append(sf::Vertex({l, t}, color, {u0, v0}));
+        quads.append(sf::Vertex({r, t}, color, {u1, v0}));
+        quads.append(sf::Vertex({l, b}, color, {u0, v1}));
+        quads.append(sf::Vertex({l, b}, color, {u0, v1}));
+        quads.append(sf::Vertex({r, t}, color, {u1, v0}));
+        quads.append(sf::Vertex({r, b}, color, {u1, v1}));
+
+        x += g.advance;
+    }
+}
+
+void HudText::draw(sf::RenderTarget& target, sf::Vector2f pos) const {
+    if (!font || quads.getVertexCount() == 0) return;
+    sf::RenderStates states(&font->getTexture(size));
+    states.transform.translate(pos);
+    target.draw(quads, states);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+
+// Text overlay without per-frame allocations: printf() formats into a fixed buffer,
+// and the glyph quads are rebuilt into a persistent vertex array only when the text
+// changes. Drawing is one call with the font's glyph texture. Glyphs are looked up
+// through sf::Font, which caches them after first use (ASCII only).
+class HudText {
+public:
+    // font must outlive the HudText; nullptr disables drawing
+    void set_font(const sf::Font* f, unsigned size, sf::Color color);
+
+    // replaces the text (truncated to the buffer)
+    void printf(const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    void draw(sf::RenderTarget& target, sf::Vector2f pos) const;
+
+private:
+    static constexpr std::size_t CAPACITY = 512;
+
+    const sf::Font* font = nullptr;
+    unsigned size = 16;
+    sf::Color color = sf::Color::Black;
+
+    char text[CAPACITY] = {};
+    char built[CAPACITY] = {}; // text the quads were built from
+    sf::VertexArray quads{sf::Triangles};
+
+    void rebuild();
+};
@@ -3,9 +3,27 @@
 #include <doubleswing/engine.hpp>
 #include <doubleswing/drag.hpp>
 
+#include "../common/args.hpp"
+#include "physics_thread.hpp"
 #include "sfml_app.hpp"
 
-int main() {
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+// doubleswing_sfml [--physics-hz N] [--trail N] [--drag-lead MS] [--record FILE]
+//   --physics-hz  fixed physics rate, default 2400 (60 .. 100000)
+//   --trail       points in bob 2's trail, default 20000 (0 = off; T toggles)
+//   --drag-lead   ms the dragged rod runs ahead of the mouse, default 0 (0 .. 50)
+//   --record      log the session for bit-exact replay (doubleswing_cli --replay FILE)
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double drag_lead = std::clamp(args.num("drag-lead", 0.0), 0.0, 50.0) * 1e-3;
+    const double physics_hz = args.num("physics-hz", 2400.0);
+    const std::string record = args.str("record");
+    const auto trail = static_cast<std::size_t>(args.count("trail", 20000));
+    if (!args.check()) return 2;
+
     // Window setup
     constexpr unsigned WIDTH  = 800;
     constexpr unsigned HEIGHT = 800;
@@ -30,11 +48,17 @@ int main() {
 
     ds::Engine engine(params, s0);
 
-    // Drag filters (frontend -> controls how we estimate omega from mouse)
-    ds::DragFilter drag1;
-    ds::DragFilter drag2;
+    // Drag estimators (frontend -> how we estimate omega and alpha from the mouse)
+    ds::DragEstimator drag1;
+    ds::DragEstimator drag2;
+    drag1.lead = drag2.lead = drag_lead;
+
+    // Physics steps on its own thread at a fixed rate, independent of vsync
+    PhysicsThread physics(engine, drag1, drag2, physics_hz);
+    if (!record.empty() && !physics.record(record))
+        std::fprintf(stderr, "cannot record to %s\n", record.c_str());
 
     // App wrapper (SFML frontend)
-    SfmlApp app(window, engine, drag1, drag2);
+    SfmlApp app(window, physics, trail);
     return app.run();
 }
@@ -0,0 +1,147 @@
+#include "physics_thread.hpp"
+
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// below this the pointer is taken as held still (bob 1 only): quantized samples of a
+// resting hand would otherwise shake bob 2 through omega and alpha
+constexpr double DRAG_DEADBAND = 0.05;  // rad/s
+
+} // namespace
+
+PhysicsThread::PhysicsThread(ds::Engine& eng, ds::DragEstimator& d1, ds::DragEstimator& d2, double rate_hz)
+    : engine(eng), drag1(d1), drag2(d2), p(eng.p),
+      step_dt(1.0 / std::clamp(rate_hz, 60.0, 100000.0)), epoch(Clock::now()), rec(eng, step_dt)
+{
+    publish(engine.s, 0.0, 0);
+}
+
+PhysicsThread::~PhysicsThread() { stop(); }
+
+void PhysicsThread::start() {
+    if (running.exchange(true)) return;
+    worker = std::thread([this] { loop(); });
+}
+
+void PhysicsThread::stop() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable()) worker.join();
+    rec.close();
+}
+
+double PhysicsThread::now() const {
+    return std::chrono::duration<double>(Clock::now() - epoch).count();
+}
+
+const PhysicsSnapshot& PhysicsThread::latest() {
+    snapshots.update();
+    return snapshots.front();
+}
+
+ds::State PhysicsThread::interpolate(const PhysicsSnapshot& snap, double t) {
+    if (snap.dt <= 0.0) return snap.cur;
+    const double a = std::clamp((t - (snap.time - snap.dt)) / snap.dt, 0.0, 1.0);
+    const ds::State& s0 = snap.prev;
+    const ds::State& s1 = snap.cur;
+    return {
+        ds::normalize_angle(s0.th1 + a * ds::unwrap_delta(s1.th1, s0.th1)), s0.w1 + a * (s1.w1 - s0.w1),
+        ds::normalize_angle(s0.th2 + a * ds::unwrap_delta(s1.th2, s0.th2)), s0.w2 + a * (s1.w2 - s0.w2),
+    };
+}
+
+void PhysicsThread::loop() {
+    // step k ends at time k * step_dt; `done` is the number of steps taken so far
+    std::uint64_t done = static_cast<std::uint64_t>(now() / step_dt);
+
+    while (running.load(std::memory_order_acquire)) {
+        PhysicsInput in;
+        while (inputs.pop(in)) apply(in);
+
+        const std::uint64_t due = static_cast<std::uint64_t>(now() / step_dt);
+        if (due > done + MAX_CATCH_UP) {
+            // a stall (debugger, suspended laptop): the sim slows down rather than spirals
+            dropped += due - MAX_CATCH_UP - done;
+            done = due - MAX_CATCH_UP;
+        }
+
+        if (due > done) {
+            ds::State prev = engine.s;
+            while (done < due) {
+                prev = engine.s;
+                step_once(double(done) * step_dt);
+                ++done;
+            }
+            publish(prev, double(done) * step_dt, done);
+        }
+
+        // wake for the next step; a late wake-up just runs a longer batch
+        std::this_thread::sleep_until(epoch + std::chrono::duration_cast<Clock::duration>(
+                                          std::chrono::duration<double>(double(done + 1) * step_dt)));
+    }
+}
+
+void PhysicsThread::apply(const PhysicsInput& in) {
+    switch (in.kind) {
+        case PhysicsInput::Kind::Grab1:
+            dragging = 1;
+            // start at the current angle to avoid a big first delta
+            drag1.reset(engine.s.th1, in.time);
+            break;
+        case PhysicsInput::Kind::Grab2:
+            dragging = 2;
+            drag2.reset(engine.s.th2, in.time);
+            break;
+        case PhysicsInput::Kind::Drag:
+            // filtered on the mouse sample's own timestamp, not the physics step
+            if (dragging == 1) drag1.update(in.theta, in.time);
+            if (dragging == 2) drag2.update(in.theta, in.time);
+            break;
+        case PhysicsInput::Kind::Release:
+            // no zero velocities for "fling" effect.
+            dragging = 0;
+            break;
+        case PhysicsInput::Kind::Reset:
+            rec.set_state(ds::State{ 0.0, 0.0, 0.0, 0.0 });
+            drag1.reset(engine.s.th1, in.time);
+            drag2.reset(engine.s.th2, in.time);
+            break;
+    }
+}
+
+void PhysicsThread::step_once(double t) {
+    // While dragging, the dragged angle follows the estimator at the step's start time t
+    // (between mouse samples it extrapolates); the rest of the state evolves normally.
+    if (dragging == 1) {
+        ds::DragEstimate e = drag1.at(t);
+        if (std::abs(e.omega) < DRAG_DEADBAND) e.omega = e.alpha = 0.0;
+        rec.step_drag_p1(e.theta, e.omega, e.alpha);
+    } else if (dragging == 2) {
+        const ds::DragEstimate e = drag2.at(t);
+        ds::State s = engine.s;
+        s.th2 = e.theta;
+        s.w2  = e.omega;
+        rec.set_state(s);
+        rec.step();
+        s = engine.s;
+        s.th2 = e.theta;
+        rec.set_state(s);
+    } else {
+        rec.step();
+    }
+}
+
+void PhysicsThread::publish(const ds::State& prev, double time, std::uint64_t steps) {
+    PhysicsSnapshot& s = snapshots.back();
+    s.prev = prev;
+    s.cur = engine.s;
+    s.time = time;
+    s.dt = step_dt;
+    s.energy = engine.energy_breakdown();
+    s.steps = steps;
+    s.dropped = dropped;
+    s.dragging = dragging;
+    snapshots.publish();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <doubleswing/drag.hpp>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/replay.hpp>
+
+#include "spsc_queue.hpp"
+#include "triple_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Mouse input from the render thread. Angles are already mapped to the dragged rod
+// (about the pivot for bob 1, about bob 1 for bob 2); time is PhysicsThread::now().
+struct PhysicsInput {
+    enum class Kind : std::uint8_t { Grab1, Grab2, Drag, Release, Reset };
+    Kind kind = Kind::Drag;
+    double theta = 0.0;
+    double time = 0.0;
+};
+
+// What the physics thread publishes after each batch of steps.
+struct PhysicsSnapshot {
+    ds::State prev{};   // state one step before cur
+    ds::State cur{};
+    double time = 0.0;  // PhysicsThread::now() at which cur is current
+    double dt = 0.0;
+    ds::EnergyBreakdown energy{}; // of cur
+    std::uint64_t steps = 0;      // index of cur's step on the fixed-rate timeline
+    std::uint64_t dropped = 0;    // steps skipped to recover from stalls
+    int dragging = 0;             // 0 none, 1 bob 1, 2 bob 2
+};
+
+// Steps an Engine at a fixed rate on its own thread, independent of the display.
+// The engine and drag estimators belong to the thread between start() and stop();
+// the render thread only sends PhysicsInput and reads snapshots.
+class PhysicsThread {
+public:
+    PhysicsThread(ds::Engine& eng, ds::DragEstimator& d1, ds::DragEstimator& d2, double rate_hz);
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    // Record the session (replay.hpp) from now on; call before start(). The file is
+    // closed by stop().
+    bool record(const std::string& path) { return rec.open(path); }
+
+    void start();
+    void stop();
+
+    // render thread: false if the queue is full (the event is dropped)
+    bool send(const PhysicsInput& in) { return inputs.push(in); }
+
+    // render thread: newest snapshot (stays valid until the next call)
+    const PhysicsSnapshot& latest();
+
+    // seconds since construction, on the clock both threads use
+    [[nodiscard]] double now() const;
+    [[nodiscard]] double dt() const { return step_dt; }
+    [[nodiscard]] const ds::Params& params() const { return p; }
+
+    // snap's state at time t (clamped to [time - dt, time]), angles interpolated the short way
+    static ds::State interpolate(const PhysicsSnapshot& snap, double t);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // after a stall longer than this many steps, drop the backlog instead of catching up
+    static constexpr std::uint64_t MAX_CATCH_UP = 256;
+
+    ds::Engine& engine;
+    ds::DragEstimator& drag1;
+    ds::DragEstimator& drag2;
+    const ds::Params p;
+    const double step_dt;
+    const Clock::time_point epoch;
+    ds::Recorder rec; // every engine change goes through here (only logs once recording)
+
+    SpscQueue<PhysicsInput, 256> inputs;
+    TripleBuffer<PhysicsSnapshot> snapshots;
+
+    std::atomic<bool> running{false};
+    std::thread worker;
+
+    // physics thread only
+    int dragging = 0;
+    std::uint64_t dropped = 0;
+
+    void loop();
+    void apply(const PhysicsInput& in);
+    void step_once(double t);
+    void publish(const ds::State& prev, double time, std::uint64_t steps);
+};
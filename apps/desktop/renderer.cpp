@@ -0,0 +1,82 @@
+#include "renderer.hpp"
+
+#include <doubleswing/util.hpp>
+#include <cmath>
+
+Trail::Trail(std::size_t capacity) : pts(capacity < 2 ? 2 : capacity) {}
+
+void Trail::push(double x, double y) {
+    pts[head] = sf::Vector2f(float(x), float(y));
+    head = head + 1 == pts.size() ? 0 : head + 1;
+    if (count < pts.size()) ++count;
+}
+
+PendulumRenderer::PendulumRenderer() {
+    for (std::size_t i = 0; i <= CIRCLE_SEGMENTS; ++i) {
+        const double a = 2.0 * ds::PI * double(i) / double(CIRCLE_SEGMENTS);
+        unit[i] = sf::Vector2f(float(std::cos(a)), float(std::sin(a)));
+    }
+}
+
+void PendulumRenderer::begin(sf::Vector2f pivot_px, float px_per_meter) {
+    pivot = pivot_px;
+    scale = px_per_meter;
+
+    // clear() keeps the vertex storage
+    trails.clear();
+    rods.clear();
+    disks.clear();
+
+    add_disk(pivot, 8.f, sf::Color(60, 200, 80));
+}
+
+void PendulumRenderer::add_trail(const Trail& trail, sf::Color color) {
+    const std::size_t n = trail.size();
+    if (n < 2) return;
+
+    const float alpha = float(color.a) / float(n - 1);
+    sf::Vector2f prev = to_px(trail.at(0).x, trail.at(0).y);
+    for (std::size_t i = 1; i < n; ++i) {
+        const sf::Vector2f cur = to_px(trail.at(i).x, trail.at(i).y);
+        sf::Color c0 = color, c1 = color;
+        c0.a = sf::Uint8(alpha * float(i - 1));
+        c1.a = sf::Uint8(alpha * float(i));
+        trails.append(sf::Vertex(prev, c0));
+        trails.append(sf::Vertex(cur, c1));
+        prev = cur;
+    }
+}
+
+void PendulumRenderer::add_pendulum(double x1, double y1, double x2, double y2) {
+    const sf::Vector2f p1 = to_px(x1, y1);
+    const sf::Vector2f p2 = to_px(x2, y2);
+    const sf::Color rod(50, 50, 50);
+
+    rods.append(sf::Vertex(pivot, rod));
+    rods.append(sf::Vertex(p1, rod));
+    rods.append(sf::Vertex(p1, rod));
+    rods.append(sf::Vertex(p2, rod));
+
+    add_disk(p1, 14.f, sf::Color::White);
+    add_disk(p2, 12.f, sf::Color::White);
+}
+
+void PendulumRenderer::draw(sf::RenderTarget& target) const {
+    if (trails.getVertexCount()) target.draw(trails);
+    if (rods.getVertexCount()) target.draw(rods);
+    if (disks.getVertexCount()) target.draw(disks);
+}
+
+void PendulumRenderer::add_disk(sf::Vector2f c, float r, sf::Color fill) {
+    // outline first, fill on top: one array, drawn in order
+    add_fan(c, r + 2.f, sf::Color::Black);
+    add_fan(c, r, fill);
+}
+
+void PendulumRenderer::add_fan(sf::Vector2f c, float r, sf::Color color) {
+    for (std::size_t i = 0; i < CIRCLE_SEGMENTS; ++i) {
+        disks.append(sf::Vertex(c, color));
+        disks.append(sf::Vertex(c + unit[i] * r, color));
+        disks.append(sf::Vertex(c + unit[i + 1] * r, color));
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity ring of past positions (metres, same frame as Engine::bob_positions).
+// Storage is allocated once; push() overwrites the oldest point when full.
+class Trail {
+public:
+    explicit Trail(std::size_t capacity);
+
+    void push(double x, double y);
+    void clear() { head = 0; count = 0; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] std::size_t capacity() const { return pts.size(); }
+
+    // i = 0 is the oldest point
+    [[nodiscard]] sf::Vector2f at(std::size_t i) const {
+        const std::size_t k = head + pts.size() - count + i;
+        return pts[k < pts.size() ? k : k - pts.size()];
+    }
+
+private:
+    std::vector<sf::Vector2f> pts;
+    std::size_t head = 0;  // next slot to write
+    std::size_t count = 0;
+};
+
+// Draws any number of pendulums and trails from three persistent vertex arrays
+// (trails, rods, disks), so a frame is three draw calls however many there are.
+// Vertex storage grows to the largest frame seen and is reused after that.
+//
+//   r.begin(pivot_px, px_per_meter);
+//   r.add_trail(trail, color);
+//   r.add_pendulum(x1, y1, x2, y2);   // metres, +y down
+//   r.draw(window);
+class PendulumRenderer {
+public:
+    PendulumRenderer();
+
+    void begin(sf::Vector2f pivot_px, float px_per_meter);
+
+    // segments fade from transparent (oldest) to color's alpha (newest)
+    void add_trail(const Trail& trail, sf::Color color);
+
+    void add_pendulum(double x1, double y1, double x2, double y2);
+
+    void draw(sf::RenderTarget& target) const;
+
+    [[nodiscard]] sf::Vector2f to_px(double x, double y) const {
+        return { pivot.x + float(x) * scale, pivot.y + float(y) * scale };
+    }
+
+private:
+    static constexpr std::size_t CIRCLE_SEGMENTS = 24;
+
+    sf::VertexArray trails{sf::Lines};
+    sf::VertexArray rods{sf::Lines};
+    sf::VertexArray disks{sf::Triangles};
+
+    std::array<sf::Vector2f, CIRCLE_SEGMENTS + 1> unit{}; // closed unit circle
+
+    sf::Vector2f pivot{};
+    float scale = 1.0f;
+
+    // filled circle with a 2 px outline (as sf::CircleShape with setOutlineThickness(2))
+    void add_disk(sf::Vector2f c, float r, sf::Color fill);
+    void add_fan(sf::Vector2f c, float r, sf::Color color);
+};
@@ -1,37 +1,56 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <doubleswing/engine.hpp>
-#include <doubleswing/drag.hpp>
+
+#include "hud_text.hpp"
+#include "physics_thread.hpp"
+#include "renderer.hpp"
+
+#include <cstddef>
+#include <vector>
 
 class SfmlApp {
 public:
-    SfmlApp(sf::RenderWindow& win, ds::Engine& eng, ds::DragFilter& d1, ds::DragFilter& d2);
+    // physics must not be started yet; run() starts and stops it.
+    // trail_points: length of bob 2's trail (0 starts with it off)
+    SfmlApp(sf::RenderWindow& win, PhysicsThread& physics, std::size_t trail_points);
     int run();
 
 private:
     sf::RenderWindow& window;
-    ds::Engine& engine;
-    ds::DragFilter& drag1;
-    ds::DragFilter& drag2;
+    PhysicsThread& physics;
 
     bool dragging1 = false;
     bool dragging2 = false;
 
+    // events drained by the last handle_events(), and when that was (physics.now())
+    std::vector<sf::Event> events;
+    double last_poll = 0.0;
+
+    // state drawn this frame: the latest snapshot interpolated to the render time,
+    // and its bob positions in pixels (used for hit tests until the next frame)
+    ds::State view{};
+    sf::Vector2f p1_px{}, p2_px{};
+
     // rendering/config
     float px_per_meter = 40.0f;
     sf::Vector2f pivot_px {400.0f, 400.0f};
 
+    PendulumRenderer renderer;
+    Trail trail;
+    bool show_trail;
+
     // UI
     sf::Font font;
-    sf::Text hud;
+    HudText hud;
 
     void handle_events();
-    void update(double dt);
+    void handle_event(const sf::Event& e, double time);
+    void update();
     void render();
 
     // helpers
-    sf::Vector2f bob1_px() const;
-    sf::Vector2f bob2_px() const;
     double theta_from_mouse_about_pivot(const sf::Vector2f& mouse) const;
     double theta_from_mouse_about_bob1(const sf::Vector2f& mouse) const;
+    void bob_positions(double& x1, double& y1, double& x2, double& y2) const;
 };
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer / single-consumer ring (N a power of two). push() fails
+// rather than blocks when full; each side caches the other's index so the shared
+// counters are only re-read when the ring looks full or empty.
+template <class T, std::size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // producer side
+    bool push(const T& v) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail_cache == N) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h - tail_cache == N) return false;
+        }
+        buf[h & (N - 1)] = v;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool pop(T& out) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head_cache) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t == head_cache) return false;
+        }
+        out = buf[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> head{0}; // written by the producer
+    std::size_t tail_cache = 0;                   // producer's copy of tail
+    alignas(64) std::atomic<std::size_t> tail{0}; // written by the consumer
+    std::size_t head_cache = 0;                   // consumer's copy of head
+    alignas(64) T buf[N]{};
+};
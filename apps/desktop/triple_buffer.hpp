@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Single-producer / single-consumer triple buffer. The producer fills back() and
+// publish()es it; the consumer calls update() and reads front(). Neither side ever
+// waits: the producer always has a free slot, and the consumer sees the newest
+// complete value (intermediate ones are dropped).
+template <class T>
+class TripleBuffer {
+public:
+    // producer side
+    T& back() { return slots[back_i].value; }
+    void publish() {
+        back_i = static_cast<std::uint8_t>(middle.exchange(back_i | FRESH, std::memory_order_acq_rel) & INDEX);
+    }
+
+    // consumer side: swaps in the latest published value; false if nothing new
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        front_i = static_cast<std::uint8_t>(middle.exchange(front_i, std::memory_order_acq_rel) & INDEX);
+        return true;
+    }
+    const T& front() const { return slots[front_i].value; }
+
+private:
+    static constexpr std::uint8_t INDEX = 3;
+    static constexpr std::uint8_t FRESH = 4;
+
+    // own cache line each, so the producer writing one never slows the reader of another
+    struct alignas(64) Slot { T value{}; };
+
+    Slot slots[3];
+    std::atomic<std::uint8_t> middle{1}; // index of the spare slot, plus FRESH once published
+    std::uint8_t back_i = 0;             // producer only
+    std::uint8_t front_i = 2;            // consumer only
+};
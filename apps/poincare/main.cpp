@@ -0,0 +1,186 @@
+// Poincare maps: many trajectories at once, writing only their section crossings.
+//
+// Initial states form a grid over th1, w1, th2, w2 (each a value or min:max:count).
+// With --energy E, w1 is instead solved from E for every grid point (w2 = 0), so all
+// orbits share one energy surface, the usual setup for a map; points whose potential
+// energy alone exceeds E are skipped.
+//
+// One record per crossing: run, t, th1, w1, th2, w2. CSV has a header line. Binary is
+// a 16-byte header ("DSPNC001", u32 field count, u32 reserved) followed by
+// little-endian float64 records, in run order.
+
+#include <doubleswing/poincare.hpp>
+
+#include "../common/engine_args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: doubleswing_poincare [config-file] [options]\n"
+        "  --l1 --l2 --m1 --m2 --g --damping   params (default 1, 1, 1, 1, 9.80665, 0)\n"
+        "  --th1 --w1 --th2 --w2               initial states, value or min:max:count\n"
+        "                                      (default th1 = 0, w1 = 0, th2 = -2:2:64, w2 = 0)\n"
+        "  --energy E      solve w1 from E per state (w2 = 0) instead of using --w1\n"
+        "  --section th1|th2 --at RAD --dir rising|falling|both   (default th1 = 0, rising)\n"
+        "  --dt S --tmax S --hits N            step, horizon per run, crossings per run (0 = all)\n"
+        "  --integrator rk4|midpoint|gauss4   --trig libm|identities|polynomial\n"
+        "  --threads N     worker count (0 = all cores)\n"
+        "  --format csv|bin (default csv)   --out FILE (default stdout)\n"
+        "  --quiet         no summary on stderr\n"
+        "Config file: 'key = value' lines using the option names without dashes.\n");
+}
+
+constexpr int FIELDS = 6;
+
+bool write_all(std::FILE* f, const std::vector<char>& buf) {
+    return buf.empty() || std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Args args(argc, argv);
+    if (args.has("help")) {
+        usage();
+        return 0;
+    }
+    if (!args.positional.empty() && !args.merge_file(args.positional)) {
+        std::fprintf(stderr, "cannot read config %s\n", args.positional.c_str());
+        return 2;
+    }
+
+    const ds::Params p = params_from_args(args, ds::Params{1.0, 1.0, 1.0, 1.0});
+
+    ds::SweepAxis th1(0.0), w1(0.0), th2(-2.0, 2.0, 64), w2(0.0);
+    const char* keys[4] = { "th1", "w1", "th2", "w2" };
+    ds::SweepAxis* axes[4] = { &th1, &w1, &th2, &w2 };
+    for (int i = 0; i < 4; ++i) {
+        if (!axis_from_args(args, keys[i], *axes[i])) {
+            std::fprintf(stderr, "--%s: expected a value or min:max:count\n", keys[i]);
+            return 2;
+        }
+    }
+
+    const bool on_energy = args.has("energy");
+    const double energy = args.num("energy", 0.0);
+
+    const std::string which = args.str("section", "th1");
+    const std::string dir_name = args.str("dir", "rising");
+    const double at = args.num("at", 0.0);
+
+    ds::PoincareConfig cfg;
+    cfg.dt       = args.num("dt", cfg.dt);
+    cfg.t_max    = args.num("tmax", cfg.t_max);
+    cfg.max_hits = args.count("hits", cfg.max_hits);
+
+    ds::Engine opts(p, ds::State{});
+    engine_options_from_args(args, opts);
+    cfg.integrator = opts.integrator;
+    cfg.trig = opts.trig;
+
+    const std::string format = args.str("format", "csv");
+    const bool binary = format == "bin";
+    const std::string out = args.str("out");
+    const auto threads = static_cast<unsigned>(args.count("threads", 0));
+    const bool quiet = args.has("quiet");
+
+    if (which != "th1" && which != "th2") args.reject("section", "th1 or th2");
+    if (dir_name != "rising" && dir_name != "falling" && dir_name != "both")
+        args.reject("dir", "rising, falling or both");
+    if (format != "csv" && format != "bin") args.reject("format", "csv or bin");
+    if (!(cfg.dt > 0.0))
+        args.reject("dt", "a step > 0");
+    else if (!(cfg.t_max >= 0.0 && cfg.t_max / std::min(cfg.dt, 1.0 / 15.0) < 1e18)) // NaN, negative, or too many steps
+        args.reject("tmax", "seconds >= 0, under 1e18 steps");
+    if (!args.check()) return 2;
+
+    const ds::CrossDir dir = dir_name == "falling" ? ds::CrossDir::Falling
+                           : dir_name == "both"    ? ds::CrossDir::Both
+                                                   : ds::CrossDir::Rising;
+    const ds::Section sec = which == "th1" ? ds::th1_section(at, dir) : ds::th2_section(at, dir);
+
+    // initial states, th2 fastest
+    std::vector<ds::State> s0;
+    for (std::size_t a = 0; a < th1.n; ++a)
+        for (std::size_t b = 0; b < (on_energy ? 1 : w1.n); ++b)
+            for (std::size_t c = 0; c < w2.n; ++c)
+                for (std::size_t d = 0; d < th2.n; ++d) {
+                    ds::State s{ th1.at(a), w1.at(b), th2.at(d), on_energy ? 0.0 : w2.at(c) };
+                    if (on_energy) {
+                        // E = KE + PE with w2 = 0: KE = (m1 + m2) l1^2 w1^2 / 2
+                        const double pe = ds::Engine(p, s).energy_breakdown().pe;
+                        if (pe > energy) continue;
+                        s.w1 = std::sqrt(2.0 * (energy - pe) / ((p.m1 + p.m2) * p.l1 * p.l1));
+                    }
+                    s0.push_back(s);
+                }
+    if (s0.empty()) {
+        std::fprintf(stderr, "no initial states (energy below every grid point?)\n");
+        return 2;
+    }
+
+    std::FILE* f = out.empty() || out == "-" ? stdout : std::fopen(out.c_str(), binary ? "wb" : "w");
+    if (!f) {
+        std::fprintf(stderr, "cannot open %s\n", out.c_str());
+        return 1;
+    }
+
+    std::vector<char> buf;
+    if (binary) {
+        char h[16] = { 'D', 'S', 'P', 'N', 'C', '0', '0', '1' };
+        for (int i = 0; i < 4; ++i) h[8 + i] = char(FIELDS >> (8 * i));
+        buf.assign(h, h + sizeof h);
+    } else {
+        const char* line = "run,t,th1,w1,th2,w2\n";
+        buf.assign(line, line + std::strlen(line));
+    }
+    bool ok = write_all(f, buf);
+
+    std::uint64_t crossings = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::size_t done = ds::poincare_batch(p, s0, sec, cfg,
+        [&](const ds::PoincareRun* runs, std::size_t n) {
+            buf.clear();
+            for (std::size_t r = 0; r < n; ++r) {
+                for (const ds::SectionHit& h : runs[r].hits) {
+                    const double v[FIELDS] = { double(runs[r].index), h.t, h.s.th1, h.s.w1, h.s.th2, h.s.w2 };
+                    if (binary) {
+                        for (const double x : v) {
+                            std::uint64_t u;
+                            std::memcpy(&u, &x, 8);
+                            for (int k = 0; k < 8; ++k) buf.push_back(char(u >> (8 * k)));
+                        }
+                    } else {
+                        char line[160];
+                        const int len = std::snprintf(line, sizeof line, "%zu,%.10g,%.12g,%.12g,%.12g,%.12g\n",
+                                                      runs[r].index, h.t, h.s.th1, h.s.w1, h.s.th2, h.s.w2);
+                        buf.insert(buf.end(), line, line + len);
+                    }
+                }
+                crossings += runs[r].hits.size();
+            }
+            return ok = ok && write_all(f, buf);
+        },
+        threads);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (!quiet)
+        std::fprintf(stderr, "%zu runs, %llu crossings in %.2f s\n", done, (unsigned long long)crossings, secs);
+
+    if (f != stdout && std::fclose(f) != 0) ok = false;
+    if (!ok || done != s0.size()) {
+        std::fprintf(stderr, "write failed\n");
+        return 1;
+    }
+    return 0;
+}
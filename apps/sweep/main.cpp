@@ -0,0 +1,172 @@
+// Parameter sweep: one Engine run per grid point over (l1, l2, m1, m2, g, damping),
+// spread across all cores, writing one table row of reductions per point.
+//
+// Columns: l1, l2, m1, m2, g, damping, max_w, energy_drift, flip_time, energy_ratio
+// (sweep.hpp has the definitions; a diverged run has max_w = inf). CSV has a header
+// line. Binary is a 16-byte header ("DSSWP001", u32 field count, u32 reserved)
+// followed by little-endian float32 records, in grid order (l1 fastest).
+
+#include <doubleswing/sweep.hpp>
+
+#include "../common/engine_args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: doubleswing_sweep [config-file] [options]\n"
+        "  --l1 --l2 --m1 --m2 --g --damping   value or min:max:count (default 1, 1, 1, 1, 9.80665, 0)\n"
+        "  --th1 --w1 --th2 --w2               initial state (default th1 = th2 = 1)\n"
+        "  --dt S --tmax S                     step and horizon (default 1/240, 10)\n"
+        "  --integrator rk4|midpoint|gauss4   --trig libm|identities|polynomial\n"
+        "  --wlimit W      stop a run as diverged past |w| = W (default 1e4)\n"
+        "  --threads N     worker count (0 = all cores)   --chunk N   points in flight (default 4096)\n"
+        "  --format csv|bin (default csv)   --out FILE (default stdout)\n"
+        "  --quiet         no progress on stderr\n"
+        "Config file: 'key = value' lines using the option names without dashes.\n");
+}
+
+constexpr int FIELDS = 10;
+
+void row(const ds::SweepPoint& r, double* v) {
+    v[0] = r.p.l1; v[1] = r.p.l2;
+    v[2] = r.p.m1; v[3] = r.p.m2;
+    v[4] = r.p.g;  v[5] = r.p.damping;
+    v[6] = r.diverged ? HUGE_VAL : r.max_w;
+    v[7] = r.energy_drift;
+    v[8] = r.flip_time;
+    v[9] = r.energy_ratio;
+}
+
+// Formats one chunk of rows and writes it with one fwrite.
+class Table {
+public:
+    Table(std::FILE* f, bool binary) : f(f), binary(binary) {}
+
+    bool header() {
+        if (binary) {
+            unsigned char h[16] = { 'D', 'S', 'S', 'W', 'P', '0', '0', '1' };
+            for (int i = 0; i < 4; ++i) h[8 + i] = static_cast<unsigned char>(FIELDS >> (8 * i));
+            return std::fwrite(h, 1, sizeof h, f) == sizeof h;
+        }
+        const char* line = "l1,l2,m1,m2,g,damping,max_w,energy_drift,flip_time,energy_ratio\n";
+        return std::fwrite(line, 1, std::strlen(line), f) == std::strlen(line);
+    }
+
+    bool write(const ds::SweepPoint* pts, std::size_t n) {
+        buf.clear();
+        double v[FIELDS];
+        for (std::size_t i = 0; i < n; ++i) {
+            row(pts[i], v);
+            if (binary) {
+                unsigned char b[FIELDS * 4];
+                for (int k = 0; k < FIELDS; ++k) {
+                    const float x = float(v[k]);
+                    std::uint32_t u;
+                    std::memcpy(&u, &x, 4);
+                    for (int j = 0; j < 4; ++j) b[k * 4 + j] = static_cast<unsigned char>(u >> (8 * j));
+                }
+                buf.insert(buf.end(), b, b + sizeof b);
+            } else {
+                char line[FIELDS * 24];
+                int len = 0;
+                for (int k = 0; k < FIELDS; ++k)
+                    len += std::snprintf(line + len, sizeof line - len, k ? ",%.7g" : "%.7g", v[k]);
+                line[len++] = '\n';
+                buf.insert(buf.end(), line, line + len);
+            }
+        }
+        return std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    }
+
+private:
+    std::FILE* f;
+    bool binary;
+    std::vector<char> buf;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Args args(argc, argv);
+    if (args.has("help")) {
+        usage();
+        return 0;
+    }
+    if (!args.positional.empty() && !args.merge_file(args.positional)) {
+        std::fprintf(stderr, "cannot read config %s\n", args.positional.c_str());
+        return 2;
+    }
+
+    ds::SweepConfig cfg;
+    const char* keys[6] = { "l1", "l2", "m1", "m2", "g", "damping" };
+    ds::SweepAxis* axes[6] = { &cfg.l1, &cfg.l2, &cfg.m1, &cfg.m2, &cfg.g, &cfg.damping };
+    for (int i = 0; i < 6; ++i) {
+        if (!axis_from_args(args, keys[i], *axes[i])) {
+            std::fprintf(stderr, "--%s: expected a value or min:max:count\n", keys[i]);
+            return 2;
+        }
+    }
+
+    cfg.s0      = state_from_args(args, cfg.s0);
+    cfg.dt      = args.num("dt", cfg.dt);
+    cfg.t_max   = args.num("tmax", cfg.t_max);
+    cfg.w_limit = args.num("wlimit", cfg.w_limit);
+    cfg.threads = static_cast<unsigned>(args.count("threads", cfg.threads));
+    cfg.chunk   = args.count("chunk", cfg.chunk);
+
+    ds::Engine opts(ds::Params{1.0, 1.0, 1.0, 1.0}, ds::State{});
+    engine_options_from_args(args, opts);
+    cfg.integrator = opts.integrator;
+    cfg.trig = opts.trig;
+
+    const std::string format = args.str("format", "csv");
+    const bool binary = format == "bin";
+    const std::string out = args.str("out");
+    const bool quiet = args.has("quiet");
+    if (format != "csv" && format != "bin") args.reject("format", "csv or bin");
+    if (!(cfg.dt > 0.0))
+        args.reject("dt", "a step > 0");
+    else if (!(cfg.t_max >= 0.0 && cfg.t_max / std::min(cfg.dt, 1.0 / 15.0) < 1e18)) // NaN, negative, or too many steps
+        args.reject("tmax", "seconds >= 0, under 1e18 steps");
+    if (!args.check()) return 2;
+
+    std::FILE* f = out.empty() || out == "-" ? stdout : std::fopen(out.c_str(), binary ? "wb" : "w");
+    if (!f) {
+        std::fprintf(stderr, "cannot open %s\n", out.c_str());
+        return 1;
+    }
+
+    int last_pct = -1;
+
+    Table table(f, binary);
+    bool ok = table.header();
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::size_t total = ds::sweep_size(cfg);
+    const std::size_t done = ds::sweep(cfg,
+        [&](const ds::SweepPoint* pts, std::size_t n) { return ok = ok && table.write(pts, n); },
+        [&](std::size_t d, std::size_t t) {
+            const int pct = int(100 * d / t);
+            if (quiet || pct == last_pct) return;
+            last_pct = pct;
+            std::fprintf(stderr, "\r%3d%% (%zu/%zu runs)", pct, d, t);
+        });
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!quiet) std::fprintf(stderr, "\n%zu runs in %.2f s\n", done, secs);
+
+    if (f != stdout && std::fclose(f) != 0) ok = false;
+    if (!ok || done != total) {
+        std::fprintf(stderr, "write failed\n");
+        return 1;
+    }
+    return 0;
+}
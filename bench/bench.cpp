@@ -0,0 +1,244 @@
+// Microbenchmarks for the physics core.
+//
+//   doubleswing_bench [--json FILE] [--iters N] [--reps N] [--max-threads N] [--quick]
+//
+// Prints a table to stdout (to stderr with --json -, so stdout is only the report).
+// With --json, also writes a machine-readable report:
+//   { "meta": {...},
+//     "cases":   [ { "name", "input", "ns_per_op", "iters" }, ... ],
+//     "scaling": [ { "engines", "threads", "ns_per_step", "steps_per_sec" }, ... ] }
+// Each case reports the median of --reps timed runs.
+
+#include <doubleswing/drag.hpp>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct CaseResult {
+    std::string name;
+    std::string input;
+    double ns_per_op;
+    std::size_t iters;
+};
+
+struct ScalingResult {
+    std::size_t engines;
+    unsigned threads;
+    double ns_per_step;
+    double steps_per_sec;
+};
+
+#if defined(__VERSION__)
+constexpr const char* COMPILER = __VERSION__;
+#else
+constexpr const char* COMPILER = "unknown";
+#endif
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+template <class F>
+double median_ns(std::size_t iters, int reps, F&& body) {
+    std::vector<double> t;
+    for (int r = 0; r < reps; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        body(iters);
+        const auto t1 = std::chrono::steady_clock::now();
+        t.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / double(iters));
+    }
+    std::sort(t.begin(), t.end());
+    return t[t.size() / 2];
+}
+
+// Input sets. Inputs are cycled through a small table so the branch predictor cannot
+// learn a single value.
+constexpr std::size_t TABLE = 1024;
+
+std::vector<ds::State> make_states(const std::string& kind, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> ang(-ds::PI, ds::PI), omega(-10.0, 10.0);
+    std::uniform_real_distribution<double> huge(-1e4, 1e4), tiny(-1e-9, 1e-9);
+    std::vector<ds::State> v(TABLE);
+    for (auto& s : v) {
+        if (kind == "huge_angles") {
+            s = { huge(rng), omega(rng), huge(rng), omega(rng) };
+        } else if (kind == "near_singular") {
+            // th1 ~= th2 with a vanishing m1 drives denom toward the eps clamp
+            const double th = ang(rng);
+            s = { th, omega(rng), th + tiny(rng), omega(rng) };
+        } else {
+            s = { ang(rng), omega(rng), ang(rng), omega(rng) };
+        }
+    }
+    return v;
+}
+
+ds::Params params_for(const std::string& kind) {
+    ds::Params p{1.0, 1.0, 1.0, 1.0};
+    if (kind == "near_singular") p.m1 = 1e-14;
+    return p;
+}
+
+std::string json_escape(const std::string& s) {
+    std::string o;
+    for (char c : s) {
+        if (c == '"' || c == '\\') o += '\\';
+        o += c;
+    }
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const bool quick = args.has("quick");
+    const auto iters = static_cast<std::size_t>(args.count("iters", quick ? 20000 : 200000));
+    const int reps = static_cast<int>(args.count("reps", quick ? 3 : 7));
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const auto max_threads = static_cast<unsigned>(args.count("max-threads", hw));
+    const std::string json = args.str("json");
+    const bool json_stdout = args.has("json") && (json.empty() || json == "-");
+    if (!args.check()) return 2;
+    if (iters == 0 || reps < 1 || max_threads == 0) {
+        std::fprintf(stderr, "--iters, --reps and --max-threads must be at least 1\n");
+        return 2;
+    }
+    std::FILE* const table = json_stdout ? stderr : stdout;
+
+    std::mt19937_64 rng(42);
+    std::vector<CaseResult> cases;
+    const double dt = 1.0 / 240.0;
+
+    auto record = [&](const std::string& name, const std::string& input, double ns) {
+        cases.push_back({ name, input, ns, iters });
+        std::fprintf(table, "%-22s %-14s %10.2f ns/op\n", name.c_str(), input.c_str(), ns);
+    };
+
+    for (const std::string kind : { "typical", "huge_angles", "near_singular" }) {
+        const auto states = make_states(kind, rng);
+        const ds::Params p = params_for(kind);
+
+        {
+            ds::Engine e(p, states[0]);
+            record("engine_step", kind, median_ns(iters, reps, [&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    e.s = states[i % TABLE];
+                    e.step(dt);
+                }
+                g_sink = e.s.th1;
+            }));
+        }
+        {
+            ds::Engine e(p, states[0]);
+            record("engine_step_drag_p1", kind, median_ns(iters, reps, [&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const ds::State& in = states[i % TABLE];
+                    e.s.th2 = in.th2;
+                    e.s.w2 = in.w2;
+                    e.step_drag_p1(dt, in.th1, in.w1, 0.0);
+                }
+                g_sink = e.s.th2;
+            }));
+        }
+        {
+            ds::Engine e(p, states[0]);
+            record("energy_breakdown", kind, median_ns(iters, reps, [&](std::size_t n) {
+                double acc = 0.0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    e.s = states[i % TABLE];
+                    acc += e.energy_breakdown().total();
+                }
+                g_sink = acc;
+            }));
+        }
+        {
+            ds::DragFilter f;
+            record("drag_filter_update", kind, median_ns(iters, reps, [&](std::size_t n) {
+                double acc = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                    acc += f.update(states[i % TABLE].th1, dt, 0.15, 10.0);
+                g_sink = acc;
+            }));
+        }
+        {
+            record("normalize_angle", kind, median_ns(iters, reps, [&](std::size_t n) {
+                double acc = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                    acc += ds::normalize_angle(states[i % TABLE].th2);
+                g_sink = acc;
+            }));
+        }
+    }
+
+    // Throughput scaling: independent engines split across a thread pool.
+    std::vector<ScalingResult> scaling;
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) thread_counts.push_back(t);
+    if (thread_counts.back() != max_threads) thread_counts.push_back(max_threads);
+
+    const std::size_t steps_per_engine = quick ? 50 : 200;
+    std::fprintf(table, "\n%-10s %-8s %12s %16s\n", "engines", "threads", "ns/step", "steps/s");
+
+    for (std::size_t engines : { std::size_t(1), std::size_t(64), std::size_t(1024), std::size_t(16384) }) {
+        for (unsigned threads : thread_counts) {
+            if (threads > engines) break;
+
+            ds::ThreadPool pool(threads);
+            const auto init = make_states("typical", rng);
+            std::vector<ds::Engine> es;
+            es.reserve(engines);
+            for (std::size_t i = 0; i < engines; ++i) es.emplace_back(params_for("typical"), init[i % TABLE]);
+
+            // one task per thread-sized chunk so scheduling cost stays out of the numbers
+            const std::size_t chunks = threads;
+            const std::size_t total_steps = engines * steps_per_engine;
+            const double ns = median_ns(total_steps, reps, [&](std::size_t) {
+                pool.parallel_for(chunks, [&](std::size_t c, unsigned) {
+                    const std::size_t b = engines * c / chunks, e = engines * (c + 1) / chunks;
+                    for (std::size_t k = 0; k < steps_per_engine; ++k)
+                        for (std::size_t i = b; i < e; ++i) es[i].step(dt);
+                });
+            });
+
+            scaling.push_back({ engines, threads, ns, 1e9 / ns });
+            std::fprintf(table, "%-10zu %-8u %12.2f %16.0f\n", engines, threads, ns, 1e9 / ns);
+        }
+    }
+
+    if (args.has("json")) {
+        std::FILE* f = json_stdout ? stdout : std::fopen(json.c_str(), "w");
+        if (!f) {
+            std::fprintf(stderr, "cannot write %s\n", json.c_str());
+            return 1;
+        }
+
+        std::fprintf(f, "{\n  \"meta\": {\"hardware_threads\": %u, \"iters\": %zu, \"reps\": %d, \"compiler\": \"%s\"},\n",
+                     hw, iters, reps, json_escape(COMPILER).c_str());
+        std::fprintf(f, "  \"cases\": [\n");
+        for (std::size_t i = 0; i < cases.size(); ++i) {
+            const auto& c = cases[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"input\": \"%s\", \"ns_per_op\": %.3f, \"iters\": %zu}%s\n",
+                         c.name.c_str(), c.input.c_str(), c.ns_per_op, c.iters, i + 1 < cases.size() ? "," : "");
+        }
+        std::fprintf(f, "  ],\n  \"scaling\": [\n");
+        for (std::size_t i = 0; i < scaling.size(); ++i) {
+            const auto& s = scaling[i];
+            std::fprintf(f, "    {\"engines\": %zu, \"threads\": %u, \"ns_per_step\": %.3f, \"steps_per_sec\": %.1f}%s\n",
+                         s.engines, s.threads, s.ns_per_step, s.steps_per_sec, i + 1 < scaling.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        if (f != stdout) std::fclose(f);
+    }
+    return 0;
+}
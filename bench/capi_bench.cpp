@@ -0,0 +1,207 @@
+// libdoubleswing's C ABI (doubleswing.h) against Engine, and the cost of crossing it.
+//
+//   doubleswing_capi_bench [--steps N] [--handles N] [--threads N]
+//
+// Checks that handles step bit for bit like an Engine, stay independent of each other,
+// that dsn_run / the bulk calls agree with single steps, and that bad arguments are
+// refused. Then times one call per step (what a scalar FFI loop pays) against
+// dsn_step_n, dsn_run and dsn_step_many, serial and on a pool. Exits non-zero on any
+// mismatch.
+
+#include <doubleswing/doubleswing.h>
+#include <doubleswing/engine.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr double FIXED_DT = 1.0 / 240.0;
+
+const double PARAMS[DSN_PARAMS_LEN] = {1.0, 1.3, 1.0, 1.7, 9.80665, 0.02};
+const double START[DSN_STATE_LEN] = {2.5, 0.3, -1.0, 4.0};
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+using Clock = std::chrono::steady_clock;
+
+double ns_since(Clock::time_point t0, std::size_t steps) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(steps);
+}
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("%-52s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) ++failures;
+}
+
+bool same_bits(const double* a, const double* b, std::size_t n) {
+    return std::memcmp(a, b, sizeof(double) * n) == 0;
+}
+
+ds::Engine reference(const double* s0, std::uint64_t steps) {
+    ds::Engine eng({PARAMS[0], PARAMS[1], PARAMS[2], PARAMS[3], PARAMS[4], PARAMS[5]},
+                   {s0[0], s0[1], s0[2], s0[3]});
+    for (std::uint64_t i = 0; i < steps; ++i) eng.step(FIXED_DT);
+    return eng;
+}
+
+bool matches(const dsn_engine* h, const ds::Engine& eng) {
+    const double ref[DSN_STATE_LEN] = {eng.s.th1, eng.s.w1, eng.s.th2, eng.s.w2};
+    double s[DSN_STATE_LEN];
+    dsn_get_state(h, s);
+    return same_bits(s, ref, DSN_STATE_LEN) && same_bits(dsn_output(h) + DSN_OUT_TH1, ref, DSN_STATE_LEN);
+}
+
+void correctness(std::uint64_t steps) {
+    check(dsn_abi_version() == DSN_ABI_VERSION, "ABI version");
+
+    const double other[DSN_STATE_LEN] = {-1.0, 0.0, 2.0, -1.5};
+    dsn_engine* a = dsn_create(PARAMS, START);
+    dsn_engine* b = dsn_create(PARAMS, other);
+    const double* out_a = dsn_output(a);
+
+    dsn_step_n(a, FIXED_DT, steps);
+    dsn_step_n(b, FIXED_DT, steps);
+    check(matches(a, reference(START, steps)) && matches(b, reference(other, steps)),
+          "dsn_step_n matches Engine bit for bit");
+    check(out_a == dsn_output(a) && out_a[DSN_OUT_X1] != dsn_output(b)[DSN_OUT_X1] &&
+              out_a[DSN_OUT_STEPS] == double(steps),
+          "output buffers are per handle");
+
+    // a trajectory in one call: every row is where single steps would be
+    dsn_set_state(a, START);
+    const std::uint64_t every = 7;
+    std::vector<double> rows((steps / every) * DSN_STATE_LEN);
+    const std::uint64_t n_rows = dsn_run(a, FIXED_DT, steps, every, rows.data());
+    const ds::Engine last_row = reference(START, n_rows * every);
+    const double ref_row[DSN_STATE_LEN] = {last_row.s.th1, last_row.s.w1, last_row.s.th2, last_row.s.w2};
+    check(n_rows == steps / every && same_bits(&rows[(n_rows - 1) * DSN_STATE_LEN], ref_row, DSN_STATE_LEN) &&
+              matches(a, reference(START, steps)),
+          "dsn_run rows match single steps");
+
+    // bulk: set, step serial and on a pool, read back
+    const std::size_t n = 64;
+    std::vector<dsn_engine*> serial(n), pooled(n);
+    std::vector<double> states(n * DSN_STATE_LEN), back(n * DSN_STATE_LEN), outs(n * DSN_OUT_LEN);
+    for (std::size_t i = 0; i < n; ++i) {
+        serial[i] = dsn_create(PARAMS, START);
+        pooled[i] = dsn_create(PARAMS, START);
+        for (int k = 0; k < DSN_STATE_LEN; ++k) states[i * DSN_STATE_LEN + k] = START[k] + 1e-3 * double(i * (k + 1));
+    }
+    dsn_set_states(serial.data(), n, states.data());
+    dsn_set_states(pooled.data(), n, states.data());
+    dsn_get_states(serial.data(), n, back.data());
+    check(same_bits(back.data(), states.data(), states.size()), "dsn_set_states / dsn_get_states round trip");
+
+    dsn_pool* pool = dsn_pool_create(4);
+    dsn_step_many(nullptr, serial.data(), n, FIXED_DT, 500);
+    dsn_step_many(pool, pooled.data(), n, FIXED_DT, 500);
+    dsn_get_states(serial.data(), n, states.data());
+    dsn_get_states(pooled.data(), n, back.data());
+    dsn_get_outputs(pooled.data(), n, outs.data());
+    bool outs_ok = true;
+    for (std::size_t i = 0; i < n; ++i)
+        outs_ok = outs_ok && same_bits(&outs[i * DSN_OUT_LEN], dsn_output(pooled[i]), DSN_OUT_LEN);
+    check(same_bits(back.data(), states.data(), states.size()) && outs_ok,
+          "dsn_step_many on a pool matches serial");
+    dsn_pool_destroy(pool);
+    for (std::size_t i = 0; i < n; ++i) {
+        dsn_destroy(serial[i]);
+        dsn_destroy(pooled[i]);
+    }
+
+    const double bad[DSN_PARAMS_LEN] = {1.0, 0.0, 1.0, 1.0, 9.8, 0.0};
+    check(dsn_create(bad, START) == nullptr && !dsn_set_params(a, bad) && !dsn_set_params(a, nullptr) &&
+              !dsn_step_n(a, 0.0, 1) && !dsn_step_n(a, 1.0, 1) && !dsn_set_integrator(a, 7) &&
+              dsn_run(a, FIXED_DT, 10, 0, rows.data()) == 0,
+          "bad arguments refused");
+
+    dsn_destroy(a);
+    dsn_destroy(b);
+}
+
+void timing(std::uint64_t steps, std::size_t handles, unsigned threads) {
+    double s[DSN_STATE_LEN];
+    double sink = 0.0;
+
+    std::printf("\n%-40s %10s\n", "one pendulum", "ns/step");
+    dsn_engine* h = dsn_create(PARAMS, START);
+    auto t0 = Clock::now();
+    for (std::uint64_t i = 0; i < steps; ++i) {
+        dsn_step_n(h, FIXED_DT, 1);
+        dsn_get_state(h, s);
+        sink += s[0];
+    }
+    std::printf("%-40s %10.1f\n", "dsn_step_n(1) + dsn_get_state per step", ns_since(t0, steps));
+
+    t0 = Clock::now();
+    dsn_step_n(h, FIXED_DT, steps);
+    std::printf("%-40s %10.1f\n", "dsn_step_n(steps)", ns_since(t0, steps));
+
+    std::vector<double> rows(steps * DSN_STATE_LEN);
+    t0 = Clock::now();
+    dsn_run(h, FIXED_DT, steps, 1, rows.data());
+    std::printf("%-40s %10.1f\n", "dsn_run, every state", ns_since(t0, steps));
+    dsn_destroy(h);
+
+    std::vector<dsn_engine*> many(handles);
+    for (dsn_engine*& e : many) e = dsn_create(PARAMS, START);
+    const std::uint64_t per = std::max<std::uint64_t>(steps / handles, 1);
+    std::vector<double> states(handles * DSN_STATE_LEN);
+
+    char title[64];
+    std::snprintf(title, sizeof title, "%zu pendulums x %llu steps", handles, static_cast<unsigned long long>(per));
+    std::printf("\n%-40s %10s\n", title, "ns/step");
+    t0 = Clock::now();
+    for (std::uint64_t k = 0; k < per; ++k)
+        for (dsn_engine* e : many) {
+            dsn_step_n(e, FIXED_DT, 1);
+            dsn_get_state(e, s);
+            sink += s[0];
+        }
+    std::printf("%-40s %10.1f\n", "per handle per step", ns_since(t0, per * handles));
+
+    t0 = Clock::now();
+    dsn_step_many(nullptr, many.data(), handles, FIXED_DT, per);
+    dsn_get_states(many.data(), handles, states.data());
+    std::printf("%-40s %10.1f\n", "dsn_step_many + dsn_get_states", ns_since(t0, per * handles));
+
+    dsn_pool* pool = dsn_pool_create(threads);
+    t0 = Clock::now();
+    dsn_step_many(pool, many.data(), handles, FIXED_DT, per);
+    dsn_get_states(many.data(), handles, states.data());
+    char label[64];
+    if (threads) std::snprintf(label, sizeof label, "same on a pool (%u threads)", threads);
+    else std::snprintf(label, sizeof label, "same on a pool (one thread per core)");
+    std::printf("%-40s %10.1f\n", label, ns_since(t0, per * handles));
+    dsn_pool_destroy(pool);
+
+    for (dsn_engine* e : many) dsn_destroy(e);
+    g_sink = sink;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const std::uint64_t steps = static_cast<std::uint64_t>(args.count("steps", 1000000));
+    const std::size_t handles = static_cast<std::size_t>(args.count("handles", 1024));
+    const unsigned threads = static_cast<unsigned>(args.count("threads", 0));
+    if (!args.check()) return 2;
+
+    correctness(2400);
+    timing(steps, handles, threads);
+
+    if (failures) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Dormand-Prince (dopri.hpp) against fixed-step RK4 at equal error: accel() evaluations.
+//
+//   doubleswing_dopri_bench [--tmax S] [--min-gain X]
+//
+// Per orbit and tolerance, runs DormandPrince to tmax and measures its error there
+// against the long double Taylor reference, then finds the fewest fixed RK4 steps that
+// are at least as accurate, and compares accel() evaluations (4 per RK4 step). Where
+// the motion is smooth throughout (a small swing, or a damped one after its flips) a
+// fixed step is already near right and the gain is modest; it is large on chaotic
+// stretches, whose error grows e^(lambda t) for any method, so they run for 5 s at
+// most. Also checks that sampling through advance_to at 240 Hz costs no extra
+// evaluations, and that a non-finite target returns at once. Exits non-zero if, at
+// tolerances of 1e-9 and tighter, DormandPrince needs more evaluations than RK4 on a
+// smooth orbit or more than 1 / --min-gain (3) of them on a chaotic one.
+
+#include <doubleswing/dopri.hpp>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/taylor.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+const ds::Params PARAMS{1.0, 1.0, 1.0, 1.0, 9.80665, 0.0};
+
+using Clock = std::chrono::steady_clock;
+
+double secs_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) ++failures;
+}
+
+// angles compared wrapped
+double state_err(const ds::State& s, const ds::StateOf<long double>& r) {
+    return double(std::max({ std::abs(std::remainder((long double)s.th1 - r.th1, 2.0L * ds::PI_L)),
+                             std::abs((long double)s.w1 - r.w1),
+                             std::abs(std::remainder((long double)s.th2 - r.th2, 2.0L * ds::PI_L)),
+                             std::abs((long double)s.w2 - r.w2) }));
+}
+
+double rk4_err(const ds::Params& p, const ds::State& s0, double tmax, std::uint64_t steps, const ds::StateOf<long double>& truth) {
+    ds::Engine e(p, s0);
+    const double dt = tmax / double(steps);
+    for (std::uint64_t i = 0; i < steps; ++i) e.step(dt);
+    return state_err(e.s, truth);
+}
+
+void compare(const char* name, const ds::Params& p, const ds::State& s0, double tmax, double min_gain) {
+    ds::TaylorL ref(p, s0);
+    const ds::StateOf<long double> truth = ref.advance_to(tmax);
+
+    std::printf("%s, %.0f s\n", name, tmax);
+    std::printf("  %-10s %12s %12s %12s %12s %8s\n", "tol", "dopri err", "dopri evals", "rk4 steps", "rk4 evals",
+                "gain");
+    for (const double tol : { 1e-6, 1e-8, 1e-9, 1e-10, 1e-12 }) {
+        ds::DopriConfig cfg;
+        cfg.rtol = cfg.atol = tol;
+        ds::DormandPrince dp(p, s0, cfg);
+        const double err = state_err(dp.advance_to(tmax), truth);
+
+        // fewest RK4 steps with the same error (doubling, then bisection); dt stays under
+        // Engine's 1/15 s cap
+        std::uint64_t steps = static_cast<std::uint64_t>(std::ceil(tmax * 15.0));
+        while (rk4_err(p, s0, tmax, steps, truth) > err && steps < (std::uint64_t(1) << 32)) steps *= 2;
+        for (std::uint64_t lo = steps / 2; steps - lo > std::max<std::uint64_t>(1, steps / 100);) {
+            const std::uint64_t mid = lo + (steps - lo) / 2;
+            (rk4_err(p, s0, tmax, mid, truth) > err ? lo : steps) = mid;
+        }
+        const double rk4_evals = 4.0 * double(steps);
+        const double gain = rk4_evals / double(dp.accel_evals);
+
+        std::printf("  %-10.0e %12.2e %12llu %12llu %12.0f %7.1fx\n", tol, err,
+                    (unsigned long long)dp.accel_evals, (unsigned long long)steps, rk4_evals, gain);
+        if (tol <= 1e-9 && gain < min_gain) {
+            std::printf("  FAILED: under %.0fx fewer evaluations than RK4\n", min_gain);
+            ++failures;
+        }
+    }
+    std::printf("\n");
+}
+
+void output_cost(double tmax) {
+    const ds::State s0{ 2.0, 0.0, 2.5, 0.0 };
+    ds::DormandPrince plain(PARAMS, s0);
+    const ds::State end = plain.advance_to(tmax);
+
+    ds::DormandPrince sampled(PARAMS, s0);
+    ds::State last{};
+    const auto outputs = static_cast<std::uint64_t>(tmax * 240.0);
+    const auto t0 = Clock::now();
+    for (std::uint64_t i = 1; i <= outputs; ++i) last = sampled.advance_to(tmax * double(i) / double(outputs));
+    const double secs = secs_since(t0);
+
+    char what[96];
+    std::snprintf(what, sizeof what, "%llu outputs at 240 Hz: %llu evals, same as none (%.1f ms)",
+                  (unsigned long long)outputs, (unsigned long long)sampled.accel_evals, secs * 1e3);
+    check(sampled.accel_evals == plain.accel_evals && std::abs(last.th1 - end.th1) < 1e-12, what);
+
+    const std::uint64_t before = sampled.accel_evals;
+    const double t = sampled.time();
+    sampled.advance_to(std::numeric_limits<double>::infinity());
+    sampled.advance_to(std::numeric_limits<double>::quiet_NaN());
+    check(sampled.accel_evals == before && sampled.time() == t, "advance_to(inf / NaN) returns without stepping");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double tmax = args.num("tmax", 60.0);
+    const double min_gain = args.num("min-gain", 3.0);
+    if (!args.check()) return 2;
+
+    ds::Params damped = PARAMS;
+    damped.damping = 0.3;
+    compare("regular swing (th1 = 0.5, th2 = 0.3)", PARAMS, ds::State{ 0.5, 0.0, 0.3, 0.0 }, tmax, 1.0);
+    compare("damped, flips then calm (th1 = th2 = 3)", damped, ds::State{ 3.0, 0.0, 3.0, 0.0 }, tmax, 1.0);
+    compare("chaotic (th1 = 2, th2 = 2.5)", PARAMS, ds::State{ 2.0, 0.0, 2.5, 0.0 }, std::min(tmax, 5.0), min_gain);
+    compare("chaotic (th1 = 3, th2 = -1)", PARAMS, ds::State{ 3.0, 0.0, -1.0, 0.0 }, std::min(tmax, 5.0), min_gain);
+    output_cost(tmax);
+
+    if (failures) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,281 @@
+// Drag input estimation: DragEstimator against the DragFilter low-pass it replaces.
+//
+//   doubleswing_drag_bench [--rate HZ] [--jitter MS] [--radius PX] [--tau MS] [--lead MS] [--trace FILE]
+//
+// Replays pointer traces with a known true angle theta(t): the pointer is sampled at
+// --rate with timestamp jitter and pixel quantization at --radius from the pivot, and
+// each sample is fed in at its timestamp, the way PhysicsThread does. Every physics
+// step (2400 Hz) reads theta, omega and alpha from the filter, and these are compared
+// with the truth at that instant:
+//   lag     shift (ms) that best aligns the estimate with the truth, for theta and omega
+//   jitter  RMS error left after removing that lag (omega, rad/s)
+//   alpha   RMS error of the acceleration used for step_drag_p1 (DragFilter passes 0)
+//   th2     RMS error of bob 2 after 100 ms of step_drag_p1 driven by the estimate
+//           instead of the true theta, omega, alpha (what the user actually sees)
+// --trace FILE replays recorded samples instead ("t,theta" lines, seconds and rad), with
+// the truth taken as the samples themselves (lag and jitter only). Exits non-zero if the
+// estimator's omega lags DragFilter's on the synthetic traces.
+
+#include <doubleswing/drag.hpp>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double STEP = 1.0 / 2400.0; // desktop physics rate
+constexpr double DRAG_ALPHA = 0.15;   // PhysicsThread's DragFilter tuning
+constexpr double DRAG_OMEGA_MAX = 10.0;
+
+struct Truth {
+    double theta, omega, alpha;
+};
+
+struct Trace {
+    const char* name;
+    double duration;
+    std::function<Truth(double)> at;
+};
+
+// quintic smoothstep from 0 to 1 over [0, 1] and its derivatives
+Truth smooth(double u) {
+    if (u <= 0.0) return { 0.0, 0.0, 0.0 };
+    if (u >= 1.0) return { 1.0, 0.0, 0.0 };
+    return { u*u*u*(10.0 + u*(-15.0 + 6.0*u)), 30.0*u*u*(1.0 - u)*(1.0 - u), 60.0*u*(1.0 - u)*(1.0 - 2.0*u) };
+}
+
+std::vector<Trace> traces() {
+    return {
+        { "sweep 0.8 Hz", 3.0, [](double t) {
+              const double w = 2.0 * ds::PI * 0.8, a = 1.2;
+              return Truth{ a * std::sin(w * t), a * w * std::cos(w * t), -a * w * w * std::sin(w * t) };
+          } },
+        { "flick 2.5 rad", 1.5, [](double t) {
+              const double T = 0.15, a = 2.5;
+              const Truth s = smooth((t - 0.5) / T);
+              return Truth{ -1.0 + a * s.theta, a * s.omega / T, a * s.alpha / (T * T) };
+          } },
+        { "spin 6 rad/s", 3.0, [](double t) {
+              // ramps up over T, then crosses +-pi about once a second
+              const double w = 6.0, T = 0.5, u = std::min(t / T, 1.0);
+              const Truth s = smooth(u);
+              const double th = t < T ? w * T * u*u*u*u * (2.5 + u*(-3.0 + u)) : w * (0.5 * T + (t - T));
+              return Truth{ ds::normalize_angle(th), w * s.theta, w * s.omega / T };
+          } },
+    };
+}
+
+struct Sample {
+    double t, theta;
+};
+
+// pointer samples of a trace: rate Hz, +-jitter s on the timestamps, angle from pixel
+// coordinates at radius px
+std::vector<Sample> sample(const Trace& tr, double rate, double jitter, double radius, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    std::vector<Sample> out;
+    for (double t = 0.0; t < tr.duration; t += 1.0 / rate) {
+        const double ts = std::max(0.0, t + jitter * u(rng));
+        const double th = tr.at(ts).theta;
+        const double x = std::round(radius * std::sin(th)), y = std::round(radius * std::cos(th));
+        out.push_back({ ts, std::atan2(x, y) });
+    }
+    std::sort(out.begin(), out.end(), [](const Sample& a, const Sample& b) { return a.t < b.t; });
+    return out;
+}
+
+// per physics step: what the filter hands step_drag_p1
+struct Series {
+    std::vector<double> theta, omega, alpha;
+};
+
+// The two filters behind one interface: feed samples, read state at a step time.
+struct OldFilter {
+    ds::DragFilter f;
+    double theta = 0.0, last_t = 0.0;
+    void grab(double th, double t) { f.reset(th); theta = th; last_t = t; }
+    void feed(const Sample& s) {
+        f.update(s.theta, s.t - last_t, DRAG_ALPHA, DRAG_OMEGA_MAX);
+        theta = s.theta;
+        last_t = s.t;
+    }
+    ds::DragEstimate at(double) const { return { theta, f.omega, 0.0 }; }
+};
+
+struct NewFilter {
+    ds::DragEstimator e;
+    NewFilter(double tau, double lead) {
+        e.tau = tau;
+        e.lead = lead;
+    }
+    void grab(double th, double t) { e.reset(th, t); }
+    void feed(const Sample& s) { e.update(s.theta, s.t); }
+    ds::DragEstimate at(double t) const { return e.at(t); }
+};
+
+template <class F>
+Series run(F f, const std::vector<Sample>& samples, double duration) {
+    Series s;
+    std::size_t next = 0;
+    f.grab(samples.front().theta, samples.front().t);
+    ++next;
+    for (double t = 0.0; t < duration; t += STEP) {
+        while (next < samples.size() && samples[next].t <= t) f.feed(samples[next++]);
+        const ds::DragEstimate e = f.at(t);
+        s.theta.push_back(e.theta);
+        s.omega.push_back(e.omega);
+        s.alpha.push_back(e.alpha);
+    }
+    return s;
+}
+
+// RMS of est(t) - truth(t - lag), angles wrapped
+double rms_shifted(const std::vector<double>& est, const std::function<double(double)>& truth, double lag, bool angle) {
+    double sum = 0.0;
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < est.size(); ++i) {
+        const double t = double(i) * STEP - lag;
+        if (t < 0.2) continue; // skip the grab transient
+        double d = est[i] - truth(t);
+        if (angle) d = std::remainder(d, 2.0 * ds::PI);
+        sum += d * d;
+        ++n;
+    }
+    return n ? std::sqrt(sum / double(n)) : 0.0;
+}
+
+// lag in [-50, 150] ms minimizing the RMS error, and that error
+std::pair<double, double> best_lag(const std::vector<double>& est, const std::function<double(double)>& truth, bool angle) {
+    double best = 0.0, err = HUGE_VAL;
+    for (double lag = -0.05; lag <= 0.15; lag += 0.00025) {
+        const double e = rms_shifted(est, truth, lag, angle);
+        if (e < err) { err = e; best = lag; }
+    }
+    return { best, err };
+}
+
+// bob 2 under step_drag_p1 driven by the series vs. by the truth, restarted from the
+// truth run every WINDOW so chaos does not swamp the forcing error
+constexpr double WINDOW = 0.1;
+
+double th2_error(const Series& s, const std::function<Truth(double)>& truth) {
+    const ds::Params p{1.0, 1.0, 1.0, 1.0, 9.80665, 0.02};
+    ds::Engine a(p, ds::State{}), b(p, ds::State{});
+    const auto per_window = static_cast<std::size_t>(std::lround(WINDOW / STEP));
+    double sum = 0.0;
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < s.theta.size(); ++i) {
+        if (i % per_window == 0) {
+            if (i > 0) {
+                const double d = std::remainder(a.s.th2 - b.s.th2, 2.0 * ds::PI);
+                sum += d * d;
+                ++n;
+            }
+            b.s = a.s;
+        }
+        const Truth tr = truth(double(i) * STEP);
+        a.step_drag_p1(STEP, tr.theta, tr.omega, tr.alpha);
+        b.step_drag_p1(STEP, s.theta[i], s.omega[i], s.alpha[i]);
+    }
+    return n ? std::sqrt(sum / double(n)) : 0.0;
+}
+
+struct Row {
+    double th_lag, w_lag, w_jitter, a_err, th2;
+};
+
+Row measure(const Series& s, const Trace& tr) {
+    const auto th = best_lag(s.theta, [&](double t) { return tr.at(t).theta; }, true);
+    const auto w = best_lag(s.omega, [&](double t) { return tr.at(t).omega; }, false);
+    const double a = rms_shifted(s.alpha, [&](double t) { return tr.at(t).alpha; }, 0.0, false);
+    return { th.first * 1e3, w.first * 1e3, w.second, a, th2_error(s, tr.at) };
+}
+
+void print(const char* trace, const char* filter, const Row& r) {
+    std::printf("%-14s %-22s %9.1f %9.1f %10.3f %10.1f %10.2e\n", trace, filter, r.th_lag, r.w_lag, r.w_jitter, r.a_err, r.th2);
+}
+
+bool load_trace(const std::string& path, std::vector<Sample>& out) {
+    std::FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    double t, th;
+    char line[256];
+    while (std::fgets(line, sizeof line, f))
+        if (std::sscanf(line, "%lf,%lf", &t, &th) == 2) out.push_back({ t, th });
+    std::fclose(f);
+    return out.size() >= 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double rate = args.num("rate", 60.0);
+    const double jitter = args.num("jitter", 2.0) * 1e-3;
+    const double radius = args.num("radius", 150.0);
+    const double lead = args.num("lead", 8.0) * 1e-3;
+    const double tau = args.num("tau", ds::DragEstimator{}.tau * 1e3) * 1e-3;
+    const std::string trace = args.str("trace");
+    if (!args.check()) return 2;
+    bool ok = true;
+
+    std::printf("pointer %.0f Hz, +-%.1f ms timestamp jitter, %.0f px radius; physics %.0f Hz\n\n",
+                rate, jitter * 1e3, radius, 1.0 / STEP);
+    std::printf("%-14s %-22s %9s %9s %10s %10s %10s\n", "trace", "filter", "th lag ms", "w lag ms",
+                "w jitter", "alpha err", "th2 rms");
+
+    if (!trace.empty()) {
+        std::vector<Sample> samples;
+        if (!load_trace(trace, samples)) {
+            std::fprintf(stderr, "cannot read trace %s\n", trace.c_str());
+            return 2;
+        }
+        const double t0 = samples.front().t;
+        for (Sample& s : samples) s.t -= t0;
+        const double duration = samples.back().t;
+        // truth: the samples, linearly interpolated, and their finite differences
+        const Trace tr{ "file", duration, [&](double t) {
+            auto it = std::upper_bound(samples.begin(), samples.end(), t,
+                                       [](double v, const Sample& s) { return v < s.t; });
+            if (it == samples.begin()) return Truth{ samples.front().theta, 0.0, 0.0 };
+            if (it == samples.end()) return Truth{ samples.back().theta, 0.0, 0.0 };
+            const Sample& a = *(it - 1);
+            const Sample& b = *it;
+            const double d = ds::unwrap_delta(b.theta, a.theta), span = std::max(b.t - a.t, 1e-6);
+            return Truth{ ds::normalize_angle(a.theta + d * (t - a.t) / span), d / span, 0.0 };
+        } };
+        print("file", "DragFilter", measure(run(OldFilter{}, samples, duration), tr));
+        print("file", "DragEstimator", measure(run(NewFilter(tau, 0.0), samples, duration), tr));
+        return 0;
+    }
+
+    std::uint64_t seed = 1;
+    for (const Trace& tr : traces()) {
+        const std::vector<Sample> samples = sample(tr, rate, jitter, radius, seed++);
+        const Row old_row = measure(run(OldFilter{}, samples, tr.duration), tr);
+        const Row new_row = measure(run(NewFilter(tau, 0.0), samples, tr.duration), tr);
+        char lead_name[32];
+        std::snprintf(lead_name, sizeof lead_name, "DragEstimator +%.0f ms", lead * 1e3);
+        const Row lead_row = measure(run(NewFilter(tau, lead), samples, tr.duration), tr);
+
+        print(tr.name, "DragFilter", old_row);
+        print(tr.name, "DragEstimator", new_row);
+        print(tr.name, lead_name, lead_row);
+        std::printf("\n");
+        if (!(new_row.w_lag < old_row.w_lag)) ok = false;
+    }
+
+    std::printf("%s\n", ok ? "DragEstimator's omega lags less than DragFilter's on every trace"
+                           : "FAIL: DragEstimator's omega lags DragFilter's");
+    return ok ? 0 : 1;
+}
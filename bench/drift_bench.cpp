@@ -0,0 +1,61 @@
+// Energy drift vs. cost for Engine's integrators on a long undamped run.
+//
+//   doubleswing_drift_bench [--hours H] [--th1 RAD] [--th2 RAD]
+//
+// For each scheme and dt: wall-clock ns/step, total seconds, and the worst
+// relative energy error |E - E0| / E0 seen over the run (sampled every step).
+
+#include <doubleswing/engine.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const char* name(ds::Integrator i) {
+    switch (i) {
+        case ds::Integrator::RK4:              return "rk4";
+        case ds::Integrator::ImplicitMidpoint: return "implicit-midpoint";
+        case ds::Integrator::GaussLegendre4:   return "gauss-legendre4";
+    }
+    return "?";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double t_end = args.num("hours", 1.0) * 3600.0;
+
+    ds::Params p{1.0, 1.0, 1.0, 1.0};
+    const ds::State s0{ args.num("th1", 1.2), 0.0, args.num("th2", 1.6), 0.0 };
+    if (!args.check()) return 2;
+
+    std::printf("%-18s %10s %12s %10s %12s\n", "integrator", "dt", "ns/step", "wall s", "max dE/E0");
+
+    for (auto integ : { ds::Integrator::RK4, ds::Integrator::ImplicitMidpoint, ds::Integrator::GaussLegendre4 }) {
+        for (double dt : { 1.0/960.0, 1.0/480.0, 1.0/240.0, 1.0/120.0, 1.0/60.0, 1.0/30.0 }) {
+            ds::Engine e(p, s0);
+            e.integrator = integ;
+            const double e0 = e.energy_breakdown().total();
+
+            const auto steps = static_cast<long long>(std::llround(t_end / dt));
+            double worst = 0.0;
+
+            const auto t0 = std::chrono::steady_clock::now();
+            for (long long i = 0; i < steps; ++i) {
+                e.step(dt);
+                worst = std::max(worst, std::abs(e.energy_breakdown().total() - e0));
+            }
+            const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            std::printf("%-18s %10.6f %12.1f %10.3f %12.3e\n",
+                        name(integ), dt, 1e9 * wall / double(steps), wall, worst / std::abs(e0));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+// EnsembleEngine (ensemble.hpp) against Engine::step, and ns per member-step per backend.
+//
+//   doubleswing_ensemble_bench [--members N] [--seconds S] [--tol X]
+//
+// Steps the same members (random states over the whole circle, some with per-member
+// params) through an EnsembleEngine and one Engine each. The Scalar backend must match
+// Engine bit for bit. The vector backends use a polynomial sin/cos, so they are checked
+// against a tolerance instead: after --seconds (default 1) every angle and rate must be
+// within --tol (default 1e-9) of Engine's. The member count is odd so the vector
+// kernels' remainder loop runs too. Also checks the dt clamp and that stepping in
+// ranges equals one full step. Backends this CPU or build lacks are skipped. Exits
+// non-zero on failure.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/ensemble.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double DT = 1.0 / 240.0;
+
+const ds::Params PARAMS{1.0, 1.0, 1.0, 1.0, 9.80665, 0.0};
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+using Clock = std::chrono::steady_clock;
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) ++failures;
+}
+
+struct Members {
+    std::vector<ds::State> s;
+    std::vector<ds::Params> p;
+};
+
+// every third member gets its own lengths, masses, g and damping
+Members make_members(std::size_t n, bool per_member) {
+    std::mt19937_64 rng(1234);
+    std::uniform_real_distribution<double> angle(-ds::PI, ds::PI), rate(-3.0, 3.0), scale(0.5, 2.0);
+    Members m;
+    for (std::size_t i = 0; i < n; ++i) {
+        m.s.push_back({ angle(rng), rate(rng), angle(rng), rate(rng) });
+        ds::Params p = PARAMS;
+        if (per_member && i % 3 == 0) {
+            p.l1 *= scale(rng); p.l2 *= scale(rng);
+            p.m1 *= scale(rng); p.m2 *= scale(rng);
+            p.g *= scale(rng);
+            p.damping = 0.1 * scale(rng);
+        }
+        m.p.push_back(p);
+    }
+    return m;
+}
+
+ds::EnsembleEngine make_ensemble(const Members& m, bool per_member, ds::SimdBackend b) {
+    ds::EnsembleEngine ens(PARAMS, m.s.size());
+    ens.set_backend(b);
+    for (std::size_t i = 0; i < m.s.size(); ++i) {
+        ens.set_state(i, m.s[i]);
+        if (per_member) ens.set_member_params(i, m.p[i]);
+    }
+    return ens;
+}
+
+std::vector<ds::State> reference(const Members& m, std::uint64_t steps, double dt) {
+    std::vector<ds::State> out;
+    for (std::size_t i = 0; i < m.s.size(); ++i) {
+        ds::Engine e(m.p[i], m.s[i]);
+        for (std::uint64_t k = 0; k < steps; ++k) e.step(dt);
+        out.push_back(e.s);
+    }
+    return out;
+}
+
+// largest angle or rate difference; angles compared on the circle
+double max_diff(const ds::EnsembleEngine& ens, const std::vector<ds::State>& ref, bool& bit_exact) {
+    double worst = 0.0;
+    bit_exact = true;
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        const ds::State s = ens.state(i);
+        bit_exact = bit_exact && std::memcmp(&s, &ref[i], sizeof(ds::State)) == 0;
+        worst = std::max({ worst,
+                           std::abs(std::remainder(s.th1 - ref[i].th1, 2.0 * ds::PI)),
+                           std::abs(std::remainder(s.th2 - ref[i].th2, 2.0 * ds::PI)),
+                           std::abs(s.w1 - ref[i].w1), std::abs(s.w2 - ref[i].w2) });
+    }
+    return worst;
+}
+
+void agreement(std::size_t n, std::uint64_t steps, double tol) {
+    for (const bool per_member : { false, true }) {
+        const Members m = make_members(n, per_member);
+        const auto ref = reference(m, steps, DT);
+
+        for (const ds::SimdBackend b : { ds::SimdBackend::Scalar, ds::SimdBackend::AVX2, ds::SimdBackend::AVX512 }) {
+            char what[96];
+            std::snprintf(what, sizeof what, "%s, %s params", ds::backend_name(b), per_member ? "per-member" : "shared");
+            if (!ds::EnsembleEngine::backend_available(b)) {
+                std::printf("%-56s skipped\n", what);
+                continue;
+            }
+            ds::EnsembleEngine ens = make_ensemble(m, per_member, b);
+            for (std::uint64_t k = 0; k < steps; ++k) ens.step(DT);
+
+            bool exact = false;
+            const double diff = max_diff(ens, ref, exact);
+            if (b == ds::SimdBackend::Scalar) {
+                std::snprintf(what + std::strlen(what), sizeof what - std::strlen(what), ": bit for bit");
+                check(exact, what);
+            } else {
+                std::snprintf(what + std::strlen(what), sizeof what - std::strlen(what), ": max diff %.1e", diff);
+                check(diff <= tol, what);
+            }
+        }
+    }
+
+    // a tab-out dt is capped the same way, and ranges add up to a full step
+    const Members m = make_members(n, true);
+    const auto ref = reference(m, 1, 0.5);
+    for (const ds::SimdBackend b : { ds::SimdBackend::Scalar, ds::SimdBackend::AVX2, ds::SimdBackend::AVX512 }) {
+        if (!ds::EnsembleEngine::backend_available(b)) continue;
+        ds::EnsembleEngine ens = make_ensemble(m, true, b);
+        ds::EnsembleEngine split = ens;
+        ens.step(0.5);
+        for (std::size_t i = 0; i < n; i += 100) split.step(0.5, i, i + 100);
+
+        bool exact = false;
+        const double diff = max_diff(ens, ref, exact);
+        char what[96];
+        std::snprintf(what, sizeof what, "%s: dt 0.5 capped like Engine", ds::backend_name(b));
+        check(b == ds::SimdBackend::Scalar ? exact : diff <= tol, what);
+        std::snprintf(what, sizeof what, "%s: step in ranges == one step", ds::backend_name(b));
+        check(ens.th1 == split.th1 && ens.w1 == split.w1 && ens.th2 == split.th2 && ens.w2 == split.w2, what);
+    }
+}
+
+void timing(std::size_t n) {
+    const Members m = make_members(n, false);
+    const std::uint64_t steps = std::max<std::uint64_t>(1, 2000000 / n);
+    const double member_steps = double(steps) * double(n);
+
+    std::printf("\n%-36s %10s\n", "", "ns/member-step");
+    std::vector<ds::Engine> es;
+    for (std::size_t i = 0; i < n; ++i) es.emplace_back(m.p[i], m.s[i]);
+    auto t0 = Clock::now();
+    for (std::uint64_t k = 0; k < steps; ++k)
+        for (ds::Engine& e : es) e.step(DT);
+    std::printf("%-36s %10.2f\n", "Engine per member",
+                std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / member_steps);
+    g_sink = es[0].s.th1;
+
+    for (const ds::SimdBackend b : { ds::SimdBackend::Scalar, ds::SimdBackend::AVX2, ds::SimdBackend::AVX512 }) {
+        if (!ds::EnsembleEngine::backend_available(b)) continue;
+        ds::EnsembleEngine ens = make_ensemble(m, false, b);
+        t0 = Clock::now();
+        for (std::uint64_t k = 0; k < steps; ++k) ens.step(DT);
+        char label[64];
+        std::snprintf(label, sizeof label, "EnsembleEngine %s", ds::backend_name(b));
+        std::printf("%-36s %10.2f\n", label,
+                    std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / member_steps);
+        g_sink = ens.th1[0];
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const auto n = static_cast<std::size_t>(args.count("members", 1023));
+    const auto steps = static_cast<std::uint64_t>(args.num("seconds", 1.0) / DT + 0.5);
+    const double tol = args.num("tol", 1e-9);
+    if (!args.check()) return 2;
+
+    agreement(std::max<std::size_t>(n, 1), steps, tol);
+    timing(std::max<std::size_t>(n, 1));
+
+    if (failures) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
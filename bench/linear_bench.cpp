@@ -0,0 +1,200 @@
+// Small-swing analytic fast path (NormalModesOf, Engine::linear_tol) against RK4.
+//
+//   doubleswing_linear_bench [--tmax S] [--tol X]
+//
+// Per amplitude: the linearization error estimate, and how far the closed-form
+// solution ends up from RK4 at dt/10 after tmax, relative to the swing. Then checks
+// that one step_linear over a long time equals many short ones, that a kick out of the
+// linear regime hands back to the integrator bit for bit, and times an idle pendulum
+// and a damped one released at 1 rad settling, with and without the fast path. Exits non-zero if a check
+// fails or an orbit within --tol ends further off than tol * omega * tmax, omega the
+// fast mode's frequency.
+
+#include <doubleswing/engine.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr double FIXED_DT = 1.0 / 240.0;
+
+const ds::Params PARAMS{1.0, 1.3, 1.0, 1.7, 9.80665, 0.0};
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+using Clock = std::chrono::steady_clock;
+
+double secs_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) ++failures;
+}
+
+double angle_diff(const ds::State& a, const ds::State& b) {
+    return std::max(std::abs(a.th1 - b.th1), std::abs(a.th2 - b.th2));
+}
+
+void accuracy(double tmax, double tol) {
+    std::printf("%-10s %12s %14s %14s\n", "amplitude", "error est.", "rel. error", "bound");
+    ds::NormalModes modes;
+    modes.build(PARAMS);
+    const double omega_max = modes.omega[1];
+
+    for (const double amp : {1e-4, 3e-4, 1e-3, 3e-3, 1e-2, 3e-2, 0.1, 0.3}) {
+        const ds::State s0{amp, 0.0, -0.6 * amp, 0.5 * amp};
+
+        ds::Engine ref(PARAMS, s0);
+        const std::uint64_t steps = static_cast<std::uint64_t>(tmax / FIXED_DT * 10.0 + 0.5);
+        for (std::uint64_t i = 0; i < steps; ++i) ref.step(FIXED_DT / 10.0);
+
+        ds::State lin = s0;
+        modes.advance(lin, tmax);
+
+        const double est = modes.linear_error(s0);
+        const double rel = angle_diff(lin, ref.s) / amp;
+        const double bound = est * omega_max * tmax;
+        std::printf("%-10.0e %12.2e %14.2e %14.2e\n", amp, est, rel, bound);
+        if (est <= tol && rel > std::max(bound, 1e-9)) {
+            std::printf("  FAILED: within --tol but %.2e off\n", rel);
+            ++failures;
+        }
+    }
+}
+
+void checks(double tol) {
+    std::printf("\n");
+
+    // any dt in one step: a long jump equals many short ones
+    ds::Params damped = PARAMS;
+    damped.damping = 0.005;
+    ds::Engine once(damped, {1e-4, 0.0, 2e-4, 0.0});
+    ds::Engine many = once;
+    once.linear_tol = many.linear_tol = tol;
+    const bool jumped = once.step_linear(1000.0);
+    bool all_linear = true;
+    for (int i = 0; i < 240000; ++i) all_linear = all_linear && many.step_linear(FIXED_DT);
+    check(jumped && all_linear && angle_diff(once.s, many.s) < 1e-8 * 1e-4,
+          "step_linear(1000 s) matches 240000 short steps");
+
+    // overdamped modes take the exponential branch
+    ds::Params heavy = PARAMS;
+    heavy.damping = 40.0;
+    ds::Engine slow(heavy, {1e-3, 0.0, 0.0, 0.0});
+    ds::Engine slow_ref = slow;
+    slow.linear_tol = tol;
+    for (int i = 0; i < 240; ++i) {
+        slow.step(FIXED_DT);
+        slow_ref.step(FIXED_DT);
+    }
+    check(angle_diff(slow.s, slow_ref.s) < 1e-3 * 1e-3, "overdamped decay matches RK4");
+
+    // a kick out of the linear regime: the integrator takes over, bit for bit
+    ds::Engine fast(PARAMS, {1e-4, 0.0, 0.0, 0.0});
+    fast.linear_tol = tol;
+    fast.step(FIXED_DT);
+    fast.s.w2 = 5.0;
+    ds::Engine plain(PARAMS, fast.s);
+    for (int i = 0; i < 2400; ++i) {
+        fast.step(FIXED_DT);
+        plain.step(FIXED_DT);
+    }
+    check(std::memcmp(&fast.s, &plain.s, sizeof(ds::State)) == 0, "kicked out of the linear regime: RK4 bit for bit");
+
+    // no rest state to linearize about
+    ds::Params up = PARAMS;
+    up.g = 0.0;
+    ds::Engine weightless(up, {1e-4, 0.0, 0.0, 0.0});
+    weightless.linear_tol = tol;
+    check(!weightless.step_linear(FIXED_DT), "g = 0 never takes the fast path");
+}
+
+void idle(double tol) {
+    ds::Params damped = PARAMS;
+    damped.damping = 0.02;
+    const std::uint64_t steps = 2000000;
+    std::printf("\n%-36s %10s\n", "swinging 1e-4 rad, damped 0.02", "ns/step");
+    for (const double t : {0.0, tol}) {
+        ds::Engine e(damped, {1e-4, 0.0, -1e-4, 0.0});
+        e.linear_tol = t;
+        const auto t0 = Clock::now();
+        for (std::uint64_t i = 0; i < steps; ++i) e.step(FIXED_DT);
+        char label[64];
+        std::snprintf(label, sizeof label, "linear_tol %g", t);
+        std::printf("%-36s %10.1f\n", label, secs_since(t0) * 1e9 / double(steps));
+        g_sink = e.s.th1;
+    }
+}
+
+void settling(double tol) {
+    ds::Params damped = PARAMS;
+    damped.damping = 0.5;
+    const ds::State s0{1.0, 0.0, 0.5, 0.0};
+    const std::uint64_t steps = static_cast<std::uint64_t>(120.0 / FIXED_DT);
+
+    std::printf("\n%-36s %10s %12s %12s\n", "damped 0.5, from 1 rad, 120 s", "ns/step", "linear", "final |th|");
+    double base_ns = 0.0;
+    ds::State base{};
+    for (const double t : {0.0, tol}) {
+        ds::Engine e(damped, s0);
+        e.linear_tol = t;
+        std::uint64_t linear = 0;
+        const auto t0 = Clock::now();
+        for (std::uint64_t i = 0; i < steps; ++i) e.step(FIXED_DT);
+        const double ns = secs_since(t0) * 1e9 / double(steps);
+
+        // where the fast path took over
+        ds::Engine probe(damped, s0);
+        probe.linear_tol = t;
+        for (std::uint64_t i = 0; i < steps; ++i) {
+            if (t > 0.0 && probe.step_linear(FIXED_DT)) {
+                linear = steps - i;
+                break;
+            }
+            probe.step(FIXED_DT);
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof label, "linear_tol %g", t);
+        std::printf("%-36s %10.1f %11.0f%% %12.2e\n", label, ns, 100.0 * double(linear) / double(steps),
+                    std::max(std::abs(e.s.th1), std::abs(e.s.th2)));
+        g_sink = e.s.th1;
+        if (t == 0.0) {
+            base_ns = ns;
+            base = e.s;
+        } else {
+            check(ns < base_ns, "settling run is faster with the fast path");
+            check(angle_diff(e.s, base) < 1e-6, "and ends where RK4 does");
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double tmax = args.num("tmax", 10.0);
+    const double tol = args.num("tol", 1e-6);
+    if (!args.check()) return 2;
+
+    accuracy(tmax, tol);
+    checks(tol);
+    idle(tol);
+    settling(tol);
+
+    if (failures) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
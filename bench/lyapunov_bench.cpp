@@ -0,0 +1,131 @@
+// Variational Lyapunov exponents (lyapunov.hpp) against the twin-trajectory method.
+//
+//   doubleswing_lyapunov_bench [--tmax S] [--d0 X] [--tol X]
+//
+// For a few chaotic and regular starts, estimates the largest exponent both ways over
+// the same --tmax: lyapunov() integrates one tangent vector, the twin method steps a
+// second Engine --d0 away and renormalizes the separation every renorm_steps steps
+// (Benettin). Prints both estimates and their cost. Exits non-zero if they differ by
+// more than --tol (relative to max(|lle|, 0.1)), or if an undamped full spectrum does
+// not come in +-pairs that sum to zero (to --tol as well: RK4 does not preserve volume
+// exactly).
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/lyapunov.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const ds::Params PARAMS{1.0, 1.0, 1.0, 1.0, 9.80665, 0.0};
+
+using Clock = std::chrono::steady_clock;
+
+double secs_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) ++failures;
+}
+
+// separation in state space, angles taken the short way round
+double separation(const ds::State& a, const ds::State& b, ds::State& d) {
+    d = { std::remainder(b.th1 - a.th1, 2.0 * ds::PI), b.w1 - a.w1,
+          std::remainder(b.th2 - a.th2, 2.0 * ds::PI), b.w2 - a.w2 };
+    return std::sqrt(d.th1 * d.th1 + d.w1 * d.w1 + d.th2 * d.th2 + d.w2 * d.w2);
+}
+
+// Benettin's method: the same perturbation direction lyapunov() starts its tangent in
+double twin_lle(const ds::State& s0, const ds::LyapunovConfig& cfg, double d0) {
+    ds::Engine a(PARAMS, s0);
+    ds::Engine b(PARAMS, ds::State{ s0.th1 + d0, s0.w1, s0.th2, s0.w2 });
+    const auto steps = static_cast<std::uint64_t>(cfg.t_measure / cfg.dt + 0.5);
+    double sum = 0.0;
+    for (std::uint64_t k = 1; k <= steps; ++k) {
+        a.step(cfg.dt);
+        b.step(cfg.dt);
+        if (k % cfg.renorm_steps != 0 && k != steps) continue;
+        ds::State d;
+        const double dist = separation(a.s, b.s, d);
+        sum += std::log(dist / d0);
+        const double f = d0 / dist;
+        b.s = { a.s.th1 + f * d.th1, a.s.w1 + f * d.w1, a.s.th2 + f * d.th2, a.s.w2 + f * d.w2 };
+    }
+    return sum / (double(steps) * cfg.dt);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double tmax = args.num("tmax", 60.0);
+    const double d0 = args.num("d0", 1e-9);
+    const double tol = args.num("tol", 0.02);
+    if (!args.check()) return 2;
+
+    ds::LyapunovConfig cfg;
+    cfg.t_measure = tmax;
+
+    struct Start {
+        const char* name;
+        ds::State s;
+    };
+    const Start starts[] = {
+        { "th1 = th2 = 2 (chaotic)",  { 2.0, 0.0, 2.0, 0.0 } },
+        { "th1 = 2, th2 = 2.5",       { 2.0, 0.0, 2.5, 0.0 } },
+        { "th1 = 3, th2 = -1",        { 3.0, 0.0, -1.0, 0.0 } },
+        { "th1 = th2 = 0.3 (regular)", { 0.3, 0.0, 0.3, 0.0 } },
+    };
+
+    std::printf("%-28s %12s %12s %10s %10s\n", "start", "variational", "twin", "var. s", "twin s");
+    double var_secs = 0.0, twin_secs = 0.0;
+    for (const Start& st : starts) {
+        auto t0 = Clock::now();
+        const double lv = ds::lyapunov(PARAMS, st.s, cfg).lle;
+        const double sv = secs_since(t0);
+        t0 = Clock::now();
+        const double lt = twin_lle(st.s, cfg, d0);
+        const double st_secs = secs_since(t0);
+        var_secs += sv;
+        twin_secs += st_secs;
+        std::printf("%-28s %12.4f %12.4f %10.3f %10.3f\n", st.name, lv, lt, sv, st_secs);
+        if (std::abs(lv - lt) > tol * std::max(std::abs(lv), 0.1)) {
+            std::printf("  FAILED: estimates differ by %.2e\n", std::abs(lv - lt));
+            ++failures;
+        }
+    }
+    std::printf("%-28s %12s %12s %10.3f %10.3f (variational / twin = %.2f)\n\n", "total", "", "", var_secs,
+                twin_secs, var_secs / twin_secs);
+
+    // an undamped flow preserves phase-space volume: exponents in +-pairs summing to 0
+    ds::LyapunovConfig full = cfg;
+    full.full_spectrum = true;
+    auto t0 = Clock::now();
+    const ds::LyapunovResult r = ds::lyapunov(PARAMS, starts[0].s, full);
+    const double secs = secs_since(t0);
+    std::printf("full spectrum %.4f %.4f %.4f %.4f (%.3f s)\n", r.spectrum[0], r.spectrum[1], r.spectrum[2],
+                r.spectrum[3], secs);
+    const double scale = std::max(std::abs(r.spectrum[0]), 0.1);
+    const double sum = r.spectrum[0] + r.spectrum[1] + r.spectrum[2] + r.spectrum[3];
+    check(std::abs(sum) < tol * scale, "undamped spectrum sums to zero");
+    check(std::abs(r.spectrum[0] + r.spectrum[3]) < tol * scale &&
+              std::abs(r.spectrum[1] + r.spectrum[2]) < tol * scale,
+          "and comes in +- pairs");
+    check(std::abs(r.spectrum[0] - r.lle) < tol * scale, "largest exponent matches the one-vector run");
+
+    if (failures) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// NLinkEngine: agreement with Engine at N = 2, and cost per step for longer chains.
+//
+//   doubleswing_nlink_bench [--steps N]
+//
+// Exits non-zero unless the two-link chain matches Engine bit for bit (accel, 1 s of
+// steps and energy, damped and undamped, every trig tier), so it can be run as a check
+// as well as a benchmark.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/nlink.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace {
+
+constexpr double FIXED_DT = 1.0 / 240.0;
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+template <class E>
+double ns_per_step(E& e, std::size_t steps) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < steps; ++i) e.step(FIXED_DT);
+    const auto t1 = std::chrono::steady_clock::now();
+    g_sink = e.s.th[0];
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(steps);
+}
+
+template <std::size_t N>
+ds::NLinkEngine<N> make_fixed() {
+    ds::ChainParams<N> p;
+    ds::ChainState<N> s;
+    for (std::size_t i = 0; i < N; ++i) {
+        p.l[i] = 1.0 / double(N);
+        p.m[i] = 1.0 / double(N);
+        s.th[i] = 0.3 + 0.01 * double(i);
+    }
+    return ds::NLinkEngine<N>(p, s);
+}
+
+ds::DynNLinkEngine make_dynamic(std::size_t n) {
+    ds::ChainParams<ds::DYNAMIC_LINKS> p;
+    ds::ChainState<ds::DYNAMIC_LINKS> s;
+    for (std::size_t i = 0; i < n; ++i) {
+        p.l.push_back(1.0 / double(n));
+        p.m.push_back(1.0 / double(n));
+        s.th.push_back(0.3 + 0.01 * double(i));
+        s.w.push_back(0.0);
+    }
+    return ds::DynNLinkEngine(p, s);
+}
+
+template <std::size_t N>
+void row(std::size_t steps) {
+    auto f = make_fixed<N>();
+    auto d = make_dynamic(N);
+    const double nf = ns_per_step(f, steps);
+    const double nd = ns_per_step(d, steps);
+    // real time at 240 Hz needs a step in under 1/240 s
+    std::printf("%-6zu %12.1f %12.1f %14.0fx\n", N, nf, nd, 1e9 * FIXED_DT / nf);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const auto steps = static_cast<std::size_t>(args.count("steps", 20000));
+    if (!args.check()) return 2;
+    bool ok = true;
+
+    // N = 2 against Engine, bit for bit
+    for (const double damping : { 0.0, 0.02 }) {
+        for (const ds::TrigMode trig : { ds::TrigMode::Libm, ds::TrigMode::Identities, ds::TrigMode::Polynomial }) {
+            std::mt19937_64 rng(3);
+            std::uniform_real_distribution<double> ang(-ds::PI, ds::PI), omega(-10.0, 10.0);
+            const ds::Params p{1.0, 1.3, 0.7, 1.7, 9.80665, damping};
+            ds::Engine e(p, ds::State{});
+            ds::NLinkEngine<2> c(ds::chain_params(p), ds::chain_state(ds::State{}));
+            e.trig = c.trig = trig;
+
+            std::size_t accel_diff = 0;
+            for (int k = 0; k < 100000; ++k) {
+                const ds::State st{ ang(rng), omega(rng), ang(rng), omega(rng) };
+                double a1, a2;
+                e.accel(st, a1, a2);
+                std::array<double, 2> a;
+                c.accel(ds::chain_state(st), a);
+                if (std::memcmp(&a[0], &a1, 8) != 0 || std::memcmp(&a[1], &a2, 8) != 0) ++accel_diff;
+            }
+
+            std::size_t step_diff = 0;
+            for (int k = 0; k < 16; ++k) {
+                const ds::State s0{ -3.0 + 0.4 * k, 0.0, 2.5 - 0.3 * k, 0.0 };
+                e.s = s0;
+                c.s = ds::chain_state(s0);
+                for (int i = 0; i < 240; ++i) { e.step(FIXED_DT); c.step(FIXED_DT); }
+                const ds::State cs{ c.s.th[0], c.s.w[0], c.s.th[1], c.s.w[1] };
+                const double ee = e.energy_breakdown().total(), ce = c.energy_breakdown().total();
+                if (std::memcmp(&cs, &e.s, sizeof cs) != 0 || std::memcmp(&ee, &ce, 8) != 0) ++step_diff;
+            }
+
+            const bool pass = accel_diff == 0 && step_diff == 0;
+            ok = ok && pass;
+            const char* tier = trig == ds::TrigMode::Libm ? "libm"
+                             : trig == ds::TrigMode::Identities ? "identities" : "polynomial";
+            std::printf("N=2 vs Engine, %-10s damping %.2f: %zu/100000 accels, %zu/16 runs differ %s\n", tier,
+                        damping, accel_diff, step_diff, pass ? "ok" : "FAIL");
+        }
+    }
+    std::printf("\n");
+
+    // cost per step
+    std::printf("%-6s %12s %12s %15s\n", "links", "fixed ns", "dynamic ns", "real time");
+    {
+        ds::Engine e(ds::Params{1.0, 1.0, 1.0, 1.0}, ds::State{1.5, 0.0, 1.5, 0.0});
+        const auto t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < steps; ++i) e.step(FIXED_DT);
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count()
+                          / double(steps);
+        g_sink = e.s.th1;
+        std::printf("%-6s %12.1f %12s %14.0fx\n", "Engine", ns, "-", 1e9 * FIXED_DT / ns);
+    }
+    row<2>(steps);
+    row<5>(steps);
+    row<10>(steps);
+    row<20>(steps);
+    row<50>(steps);
+
+    // energy conservation on a long undamped chain (sanity check of the general N path)
+    {
+        auto c = make_fixed<20>();
+        const double e0 = c.energy_breakdown().total();
+        for (int i = 0; i < 240 * 5; ++i) c.step(FIXED_DT);
+        const double drift = std::abs(c.energy_breakdown().total() - e0) / (std::abs(e0) + 1e-12);
+        std::printf("\nN=20 relative energy drift over 5 s: %.3e\n", drift);
+    }
+
+    return ok ? 0 : 1;
+}
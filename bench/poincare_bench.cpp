@@ -0,0 +1,119 @@
+// Section crossings (poincare.hpp): correctness at the +-pi wrap, and cost per step.
+//
+//   doubleswing_poincare_bench [--tmax S]
+//
+// A rotating pendulum and its mirror image (all angles and rates negated) cross
+// th1 = th and th1 = -th the same number of times, in opposite directions. Checks that
+// for th = 0, +-pi (where the angle wraps) and 2, with Rising, Falling and Both; that
+// every refined hit lies on the section; and that a swing short of pi never crosses
+// it. Then times trace_section against plain stepping. Exits non-zero on failure.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/poincare.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const ds::Params PARAMS{1.0, 1.0, 1.0, 1.0, 9.80665, 0.0};
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) ++failures;
+}
+
+std::vector<ds::SectionHit> trace(const ds::State& s0, const ds::Section& sec, double tmax) {
+    ds::PoincareConfig cfg;
+    cfg.t_max = tmax;
+    std::vector<ds::SectionHit> hits;
+    ds::trace_section(PARAMS, s0, sec, cfg, [&](const ds::SectionHit& h) {
+        hits.push_back(h);
+        return true;
+    });
+    return hits;
+}
+
+bool on_section(const std::vector<ds::SectionHit>& hits, double th) {
+    for (const ds::SectionHit& h : hits)
+        if (std::abs(std::remainder(h.s.th1 - th, 2.0 * ds::PI)) > 1e-9) return false;
+    return true;
+}
+
+void mirror_checks(double tmax) {
+    // fast enough that th1 keeps going round; the mirror runs the other way
+    const ds::State fwd{0.3, 12.0, 0.0, 0.0};
+    const ds::State back{-0.3, -12.0, 0.0, 0.0};
+
+    for (const double th : {0.0, ds::PI, -ds::PI, 2.0}) {
+        const auto both_f = trace(fwd, ds::th1_section(th, ds::CrossDir::Both), tmax);
+        const auto both_b = trace(back, ds::th1_section(-th, ds::CrossDir::Both), tmax);
+        const auto rise_f = trace(fwd, ds::th1_section(th, ds::CrossDir::Rising), tmax);
+        const auto fall_b = trace(back, ds::th1_section(-th, ds::CrossDir::Falling), tmax);
+        const auto fall_f = trace(fwd, ds::th1_section(th, ds::CrossDir::Falling), tmax);
+
+        char what[96];
+        std::snprintf(what, sizeof what, "th1 = %+.4f: %zu crossings forward, %zu mirrored", th,
+                      both_f.size(), both_b.size());
+        check(!both_f.empty() && both_f.size() == both_b.size(), what);
+        std::snprintf(what, sizeof what, "th1 = %+.4f: rising forward = falling mirrored", th);
+        check(rise_f.size() == fall_b.size() && rise_f.size() == both_f.size() && fall_f.empty(), what);
+        std::snprintf(what, sizeof what, "th1 = %+.4f: every hit on the section", th);
+        check(on_section(both_f, th) && on_section(both_b, -th), what);
+    }
+
+    // a swing that never reaches pi crosses 0 but not pi
+    const ds::State swing{1.0, 0.0, 0.0, 0.0};
+    check(trace(swing, ds::th1_section(ds::PI, ds::CrossDir::Both), tmax).empty() &&
+              !trace(swing, ds::th1_section(0.0, ds::CrossDir::Both), tmax).empty(),
+          "small swing: crosses th1 = 0, never th1 = pi");
+}
+
+void timing(double tmax) {
+    using Clock = std::chrono::steady_clock;
+    const ds::State s0{2.0, 0.0, 1.0, 0.0};
+    const double dt = ds::PoincareConfig{}.dt;
+    const double steps = std::ceil(tmax / dt);
+
+    auto t0 = Clock::now();
+    ds::Engine e(PARAMS, s0);
+    for (double k = 0; k < steps; ++k) e.step(dt);
+    const double plain = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / steps;
+
+    t0 = Clock::now();
+    const auto hits = trace(s0, ds::th1_section(0.0, ds::CrossDir::Both), tmax);
+    const double traced = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / steps;
+
+    std::printf("\n%-36s %10s\n", "chaotic run", "ns/step");
+    std::printf("%-36s %10.1f\n", "Engine::step", plain);
+    char label[64];
+    std::snprintf(label, sizeof label, "trace_section (%zu crossings)", hits.size());
+    std::printf("%-36s %10.1f\n", label, traced);
+    g_sink = e.s.th1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double tmax = args.num("tmax", 20.0);
+    if (!args.check()) return 2;
+
+    mirror_checks(tmax);
+    timing(tmax * 5.0);
+
+    if (failures) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+// BasicEngine policy variants against the runtime-dispatching Engine.
+//
+//   doubleswing_policy_bench [--steps N]
+//
+// For every policy that has an Engine equivalent (double, normalize_angle wrap) the
+// two must step bit for bit the same; the bench exits non-zero otherwise. The other
+// variants (different wrap, float) report their state difference from Engine after 1 s.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/engine_policy.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr double FIXED_DT = 1.0 / 240.0;
+
+const ds::Params PARAMS{1.0, 1.3, 1.0, 1.7, 9.80665, 0.02};
+const ds::State START{2.5, 0.3, -1.0, 4.0};
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+using Clock = std::chrono::steady_clock;
+
+double ns_since(Clock::time_point t0, std::size_t steps) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(steps);
+}
+
+bool same_bits(const ds::State& a, const ds::State& b) {
+    return std::memcmp(&a, &b, sizeof(ds::State)) == 0;
+}
+
+double state_diff(const ds::State& a, const ds::State& b) {
+    // angle differences wrapped, so an unwrapped variant compares fairly
+    return std::max({ std::abs(ds::normalize_angle(a.th1 - b.th1)), std::abs(a.w1 - b.w1),
+                      std::abs(ds::normalize_angle(a.th2 - b.th2)), std::abs(a.w2 - b.w2) });
+}
+
+// Engine configured like Policy, at double precision
+template <class Policy>
+ds::Engine runtime_engine() {
+    ds::Params p = PARAMS;
+    if (!Policy::damped) p.damping = 0.0;
+    ds::Engine e(p, START);
+    e.trig = Policy::trig;
+    e.integrator = Policy::integrator;
+    return e;
+}
+
+template <class Policy>
+bool row(const char* name, std::size_t steps) {
+    using Real = typename Policy::real;
+
+    ds::Engine e = runtime_engine<Policy>();
+    ds::BasicEngine<Policy> b(ds::params_as<Real>(e.p), ds::state_as<Real>(START));
+    ds::BasicEngine<Policy> r = b;
+
+    auto t0 = Clock::now();
+    for (std::size_t i = 0; i < steps; ++i) e.step(FIXED_DT);
+    const double ns_engine = ns_since(t0, steps);
+
+    t0 = Clock::now();
+    for (std::size_t i = 0; i < steps; ++i) b.step(Real(FIXED_DT));
+    const double ns_step = ns_since(t0, steps);
+
+    t0 = Clock::now();
+    r.run(Real(FIXED_DT), steps);
+    const double ns_run = ns_since(t0, steps);
+
+    g_sink = e.s.th1 + double(b.s.th1) + double(r.s.th1);
+
+    const ds::State bs = ds::state_from(b.s), rs = ds::state_from(r.s);
+    const bool exact = std::is_same_v<Real, double> && Policy::wrap == ds::AngleWrap::Loop;
+    bool pass = true;
+    char check[48];
+    if (exact) {
+        pass = same_bits(e.s, bs) && same_bits(e.s, rs);
+        std::snprintf(check, sizeof(check), "%s", pass ? "bit-exact" : "FAIL (differs)");
+    } else {
+        // the pendulum is chaotic, so compare over a horizon short enough to mean something
+        ds::Engine e1 = runtime_engine<Policy>();
+        ds::BasicEngine<Policy> b1(ds::params_as<Real>(e1.p), ds::state_as<Real>(START));
+        for (int i = 0; i < 240; ++i) { e1.step(FIXED_DT); b1.step(Real(FIXED_DT)); }
+        std::snprintf(check, sizeof(check), "1 s diff %.2e", state_diff(e1.s, ds::state_from(b1.s)));
+    }
+
+    std::printf("%-28s %10.1f %10.1f %10.1f %8.2fx   %s\n", name, ns_engine, ns_step, ns_run,
+                ns_engine / std::min(ns_step, ns_run), check);
+    return pass;
+}
+
+template <bool Damped, ds::TrigMode Trig = ds::TrigMode::Libm,
+          ds::Integrator Method = ds::Integrator::RK4, ds::AngleWrap Wrap = ds::AngleWrap::Loop>
+using P64 = ds::EnginePolicy<double, Damped, Trig, Method, Wrap>;
+
+template <bool Damped, ds::TrigMode Trig = ds::TrigMode::Libm,
+          ds::Integrator Method = ds::Integrator::RK4, ds::AngleWrap Wrap = ds::AngleWrap::Loop>
+using P32 = ds::EnginePolicy<float, Damped, Trig, Method, Wrap>;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const auto steps = static_cast<std::size_t>(args.count("steps", 200000));
+    if (!args.check()) return 2;
+    bool ok = true;
+
+    using ds::TrigMode;
+    using ds::Integrator;
+    using ds::AngleWrap;
+
+    std::printf("ns/step over %zu steps at dt = 1/240 (Engine: runtime dispatch; step: BasicEngine::step; "
+                "run: BasicEngine::run)\n\n", steps);
+    std::printf("%-28s %10s %10s %10s %9s   %s\n", "variant", "Engine", "step", "run", "gain", "vs Engine");
+
+    ok &= row<P64<true>>("rk4 libm damped", steps);
+    ok &= row<P64<false>>("rk4 libm", steps);
+    ok &= row<P64<false, TrigMode::Identities>>("rk4 identities", steps);
+    ok &= row<P64<false, TrigMode::Polynomial>>("rk4 polynomial", steps);
+    ok &= row<P64<true, TrigMode::Polynomial>>("rk4 polynomial damped", steps);
+    ok &= row<P64<false, TrigMode::Polynomial, Integrator::RK4, AngleWrap::Round>>("rk4 polynomial wrap=round", steps);
+    ok &= row<P64<false, TrigMode::Polynomial, Integrator::RK4, AngleWrap::None>>("rk4 polynomial wrap=none", steps);
+    ok &= row<P64<false, TrigMode::Libm, Integrator::ImplicitMidpoint>>("midpoint", steps / 4);
+    ok &= row<P64<false, TrigMode::Libm, Integrator::GaussLegendre4>>("gauss4", steps / 4);
+    ok &= row<P32<false, TrigMode::Identities>>("float rk4 identities", steps);
+    ok &= row<P32<false, TrigMode::Identities, Integrator::RK4, AngleWrap::Round>>("float rk4 identities round", steps);
+
+    std::printf("\n%s\n", ok ? "all double/Loop variants match Engine bit for bit" : "MISMATCH against Engine");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// Float (EngineF) against double (Engine): how long float tracks the double reference,
+// and what it saves per step.
+//
+//   doubleswing_precision_bench [--tmax S] [--tol RAD] [--runs N] [--steps N] [--threads N]
+//
+// Per starting amplitude (th1 = th2 = A, a spread of small w1 offsets) the median time
+// until float is past tol of double, next to the same for double at dt/2 (the
+// integrator's own error horizon at this dt), and the worst energy error of each.
+// "never" is within tol to tmax. Small-amplitude orbits are regular, so float must
+// stay within tol there for the whole run; the bench exits non-zero if it does not.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/precision.hpp>
+#include <doubleswing/thread_pool.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr double FIXED_DT = 1.0 / 240.0;
+
+const ds::Params PARAMS{1.0, 1.0, 1.0, 1.0};
+
+volatile double g_sink; // keeps results observable so loops are not optimized out
+
+using Clock = std::chrono::steady_clock;
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+// time or "never" (< 0 from the report means within tol to t_max)
+const char* fmt_time(double t, double t_max, char* buf, std::size_t n) {
+    if (t < 0.0 || t > t_max) std::snprintf(buf, n, "never");
+    else std::snprintf(buf, n, "%.2f", t);
+    return buf;
+}
+
+template <class E>
+double ns_per_step(std::size_t steps, ds::TrigMode trig) {
+    using Real = typename E::real;
+    E e(ds::params_as<Real>(PARAMS), ds::state_as<Real>(ds::State{2.5, 0.3, -1.0, 4.0}));
+    e.trig = trig;
+    const auto t0 = Clock::now();
+    for (std::size_t i = 0; i < steps; ++i) e.step(Real(FIXED_DT));
+    g_sink = double(e.s.th1);
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(steps);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    ds::DivergenceConfig cfg;
+    cfg.dt    = FIXED_DT;
+    cfg.t_max = args.num("tmax", 30.0);
+    cfg.tol   = args.num("tol", cfg.tol);
+    const std::size_t runs = std::max<std::size_t>(args.count("runs", 16), 1);
+    const auto steps = static_cast<std::size_t>(args.count("steps", 200000));
+    const auto threads = static_cast<unsigned>(args.count("threads", 0));
+    if (!args.check()) return 2;
+    bool ok = true;
+
+    ds::ThreadPool pool(threads);
+
+    std::printf("float vs double, dt = 1/240, tol %.1e rad, %zu runs per amplitude, tmax %.0f s\n\n",
+                cfg.tol, runs, cfg.t_max);
+    std::printf("%6s %12s %12s %12s %12s %12s %12s\n", "A", "float t", "dt/2 t",
+                "float 1s", "dt/2 1s", "dE/E double", "dE/E float");
+
+    for (const double amp : { 0.1, 0.3, 0.6, 1.0, 1.5, 2.0, 2.5, 3.0 }) {
+        std::vector<ds::DivergenceReport> rep(runs);
+        pool.parallel_for(runs, [&](std::size_t i, unsigned) {
+            const ds::State s0{ amp, 1e-3 * double(i), amp, 0.0 };
+            rep[i] = ds::divergence_report(PARAMS, s0, cfg);
+        });
+
+        std::vector<double> tf, tt, ef, et;
+        double de_d = 0.0, de_f = 0.0;
+        for (const ds::DivergenceReport& r : rep) {
+            // never diverging sorts above any time
+            tf.push_back(r.float_time < 0.0 ? cfg.t_max * 2.0 : r.float_time);
+            tt.push_back(r.truncation_time < 0.0 ? cfg.t_max * 2.0 : r.truncation_time);
+            ef.push_back(r.float_error_1s);
+            et.push_back(r.truncation_error_1s);
+            de_d = std::max(de_d, r.energy_error_double);
+            de_f = std::max(de_f, r.energy_error_float);
+            if (amp <= 0.3 && r.float_time >= 0.0) ok = false;
+        }
+
+        char a[16], b[16];
+        std::printf("%6.1f %12s %12s %12.2e %12.2e %12.2e %12.2e\n", amp,
+                    fmt_time(median(tf), cfg.t_max, a, sizeof a), fmt_time(median(tt), cfg.t_max, b, sizeof b),
+                    median(ef), median(et), de_d, de_f);
+    }
+
+    std::printf("\nns/step over %zu steps (single engine)\n", steps);
+    std::printf("%-14s %10s %10s %8s\n", "trig", "double", "float", "ratio");
+    for (const auto trig : { ds::TrigMode::Libm, ds::TrigMode::Identities, ds::TrigMode::Polynomial }) {
+        const double nd = ns_per_step<ds::Engine>(steps, trig);
+        const double nf = ns_per_step<ds::EngineF>(steps, trig);
+        const char* name = trig == ds::TrigMode::Libm ? "libm" : trig == ds::TrigMode::Identities ? "identities"
+                                                                                                : "polynomial";
+        std::printf("%-14s %10.1f %10.1f %7.2fx\n", name, nd, nf, nd / nf);
+    }
+
+    std::printf("\n%s\n", ok ? "float tracks double on every regular (small-amplitude) orbit"
+                             : "FAIL: float left double on a small-amplitude orbit");
+    return ok ? 0 : 1;
+}
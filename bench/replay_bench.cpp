@@ -0,0 +1,210 @@
+// Determinism and seek cost of session recordings (replay.hpp).
+//
+//   doubleswing_replay_bench [--seconds S] [--dir PATH] [--keep]
+//   doubleswing_replay_bench --verify FILE
+//
+// Records a scripted interactive session (drags through a DragFilter, resets, a param
+// change, a switch to the small-swing fast path) twice and checks that both files are
+// byte-identical, that replaying one reproduces every checkpoint and the final state
+// bit for bit, and that seek() lands on the same state as a straight replay. --keep leaves the recording on disk so a
+// later run (or another machine) can check it with --verify. Exits non-zero on any
+// mismatch.
+
+#include <doubleswing/drag.hpp>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/replay.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double DT = 1.0 / 2400.0;             // desktop physics rate
+constexpr std::uint64_t STEPS_PER_SAMPLE = 40;  // mouse sampled at 60 Hz
+constexpr std::uint64_t CHECKPOINT_EVERY = 2400;
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+bool same_bits(const ds::State& a, const ds::State& b) {
+    return std::memcmp(&a, &b, sizeof(ds::State)) == 0;
+}
+
+// The desktop app's input handling (PhysicsThread) driven by a seeded script instead
+// of a mouse. Returns the final state.
+ds::State record_session(const std::string& path, std::uint64_t steps) {
+    ds::Engine e(ds::Params{4.0, 4.0, 2.0, 2.0, 9.80665, 0.02}, ds::State{0.3, 0.0, -0.2, 0.0});
+    ds::Recorder rec(e, DT);
+    rec.open(path, CHECKPOINT_EVERY);
+
+    std::mt19937_64 rng(20240601);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    ds::DragFilter filter;
+
+    int dragging = 0;
+    std::uint64_t drag_end = 0, next_grab = 2400;
+    double target = 0.0, theta = 0.0, omega = 0.0;
+
+    for (std::uint64_t k = 0; k < steps; ++k) {
+        if (dragging == 0 && k >= next_grab) {
+            dragging = unit(rng) < 0.5 ? 1 : 2;
+            theta = dragging == 1 ? e.s.th1 : e.s.th2;
+            filter.reset(theta);
+            omega = 0.0;
+            target = (unit(rng) * 2.0 - 1.0) * 3.0;
+            drag_end = k + 600 + std::uint64_t(unit(rng) * 2400);
+        }
+        if (dragging && k % STEPS_PER_SAMPLE == 0) {
+            // mouse eases toward the target angle
+            theta += 0.08 * (target - theta);
+            omega = filter.update(theta, double(STEPS_PER_SAMPLE) * DT, 0.15, 10.0);
+            if (dragging == 1 && std::abs(omega) < 0.05) omega = 0.0;
+        }
+        if (dragging && k >= drag_end) {
+            dragging = 0;
+            next_grab = k + 2400 + std::uint64_t(unit(rng) * 7200);
+        }
+
+        if (k == steps / 2) rec.set_params(ds::Params{4.0, 3.0, 2.0, 2.5, 9.80665, 0.02});
+        if (k == steps / 3) rec.set_config(ds::Integrator::RK4, ds::TrigMode::Polynomial, 1e-6);
+        if (k % 100000 == 99999) rec.set_state(ds::State{});
+
+        if (dragging == 1) {
+            rec.step_drag_p1(theta, omega, 0.0);
+        } else if (dragging == 2) {
+            ds::State s = e.s;
+            s.th2 = theta;
+            s.w2 = omega;
+            rec.set_state(s);
+            rec.step();
+            s = e.s;
+            s.th2 = theta;
+            rec.set_state(s);
+        } else {
+            rec.step();
+        }
+    }
+    rec.close();
+    return e.s;
+}
+
+std::vector<unsigned char> slurp(const std::string& path) {
+    std::vector<unsigned char> data;
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return data;
+    unsigned char tmp[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(tmp, 1, sizeof tmp, f)) > 0) data.insert(data.end(), tmp, tmp + n);
+    std::fclose(f);
+    return data;
+}
+
+int verify_file(const std::string& path) {
+    ds::Replayer r;
+    if (!r.open(path)) {
+        std::fprintf(stderr, "cannot read recording %s\n", path.c_str());
+        return 1;
+    }
+    std::uint64_t bad = 0;
+    const auto t0 = Clock::now();
+    const bool ok = r.verify(bad);
+    const double secs = seconds_since(t0);
+    if (!ok) {
+        std::printf("%s: diverges at checkpoint step %llu\n", path.c_str(), (unsigned long long)bad);
+        return 1;
+    }
+    std::printf("%s: %llu steps, %zu events, %zu checkpoints%s replay bit-exact (%.2f s)\n", path.c_str(),
+                (unsigned long long)r.total_steps(), r.events().size(), r.checkpoints().size(),
+                r.complete() ? "," : " (truncated),", secs);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const std::string verify = args.str("verify");
+    const auto steps = static_cast<std::uint64_t>(args.num("seconds", 120.0) / DT);
+    const std::string dir = args.str("dir", ".");
+    const bool keep = args.has("keep");
+    if (!args.check()) return 2;
+    if (args.has("verify")) return verify_file(verify);
+
+    const std::string path_a = dir + "/replay_bench_a.dsrpl";
+    const std::string path_b = dir + "/replay_bench_b.dsrpl";
+    bool ok = true;
+
+    // two recordings of the same script must be identical files
+    auto t0 = Clock::now();
+    const ds::State final_a = record_session(path_a, steps);
+    const double rec_secs = seconds_since(t0);
+    const ds::State final_b = record_session(path_b, steps);
+    const auto bytes_a = slurp(path_a);
+    const bool identical = !bytes_a.empty() && bytes_a == slurp(path_b) && same_bits(final_a, final_b);
+    ok = ok && identical;
+    std::printf("record: %llu steps in %.2f s, %zu bytes; second run %s\n", (unsigned long long)steps,
+                rec_secs, bytes_a.size(), identical ? "byte-identical" : "DIFFERS");
+    std::remove(path_b.c_str());
+
+    ds::Replayer r;
+    if (!r.open(path_a) || r.total_steps() != steps || !r.complete()) {
+        std::fprintf(stderr, "cannot read back %s\n", path_a.c_str());
+        return 1;
+    }
+
+    // full replay against every checkpoint and the recorder's final state
+    std::uint64_t bad = 0;
+    t0 = Clock::now();
+    const bool verified = r.verify(bad) && same_bits(r.engine().s, final_a);
+    const double replay_secs = seconds_since(t0);
+    ok = ok && verified;
+    std::printf("replay: %zu events, %zu checkpoints, %.2f s, %s\n", r.events().size(), r.checkpoints().size(),
+                replay_secs, verified ? "bit-exact" : "FAIL");
+    if (!verified) std::printf("  first divergent checkpoint: step %llu\n", (unsigned long long)bad);
+
+    // seek() vs. replaying from the start
+    {
+        std::mt19937_64 rng(7);
+        std::uniform_int_distribution<std::uint64_t> pick(0, steps);
+        std::vector<std::uint64_t> targets(64);
+        for (auto& k : targets) k = pick(rng);
+
+        std::vector<ds::State> expect;
+        ds::Replayer linear;
+        linear.open(path_a);
+        std::vector<std::uint64_t> sorted = targets;
+        std::sort(sorted.begin(), sorted.end());
+        for (const std::uint64_t k : sorted) {
+            linear.advance(k - linear.step_index());
+            expect.push_back(linear.engine().s);
+        }
+
+        bool seek_ok = true;
+        t0 = Clock::now();
+        for (const std::uint64_t k : targets) {
+            r.seek(k);
+            const std::size_t i = std::size_t(std::lower_bound(sorted.begin(), sorted.end(), k) - sorted.begin());
+            seek_ok = seek_ok && r.step_index() == k && same_bits(r.engine().s, expect[i]);
+        }
+        const double seek_ms = seconds_since(t0) * 1e3 / double(targets.size());
+        ok = ok && seek_ok;
+        std::printf("seek: %.3f ms per random seek (full replay %.0f ms), %s\n", seek_ms, replay_secs * 1e3,
+                    seek_ok ? "matches straight replay" : "FAIL");
+    }
+
+    if (keep) std::printf("kept %s (check later with --verify)\n", path_a.c_str());
+    else std::remove(path_a.c_str());
+
+    return ok ? 0 : 1;
+}
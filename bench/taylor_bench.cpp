@@ -0,0 +1,125 @@
+// Taylor-series reference integrator: accuracy and cost against RK4 and Dormand-Prince.
+//
+//   doubleswing_taylor_bench [--tmax S] [--th1 RAD] [--th2 RAD]
+//
+// Every method runs the same undamped start to tmax and is compared with TaylorL
+// (long double, tol = its epsilon) there: max state error, steps, mean step, wall time.
+// The bench exits non-zero if the default double Taylor run is not within 1e-10 of the
+// long double one, or its energy error passes 1e-13.
+
+#include <doubleswing/dopri.hpp>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/taylor.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const ds::Params PARAMS{1.0, 1.0, 1.0, 1.0};
+
+using Clock = std::chrono::steady_clock;
+
+double secs_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// long double reference, angles compared wrapped
+double state_err(const ds::State& s, const ds::StateOf<long double>& r) {
+    return double(std::max({ std::abs(std::remainder((long double)s.th1 - r.th1, 2.0L * ds::PI_L)),
+                             std::abs((long double)s.w1 - r.w1),
+                             std::abs(std::remainder((long double)s.th2 - r.th2, 2.0L * ds::PI_L)),
+                             std::abs((long double)s.w2 - r.w2) }));
+}
+
+double energy_err(const ds::State& s, double e0) {
+    return std::abs(ds::Engine(PARAMS, s).energy_breakdown().total() - e0) / std::abs(e0);
+}
+
+void row(const char* name, double err, unsigned long long steps, double t_max, double secs, double de) {
+    std::printf("%-22s %12.2e %10llu %12.3e %10.3f %12.2e\n", name, err, steps,
+                t_max / double(steps), secs * 1e3, de);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const double t_max = args.num("tmax", 5.0);
+    const ds::State s0{ args.num("th1", 2.0), 0.0, args.num("th2", 2.5), 0.0 };
+    if (!args.check()) return 2;
+    const double e0 = ds::Engine(PARAMS, s0).energy_breakdown().total();
+    bool ok = true;
+
+    auto t0 = Clock::now();
+    ds::TaylorL ref(PARAMS, s0);
+    const ds::StateOf<long double> truth = ref.advance_to(t_max);
+    std::printf("reference: long double Taylor, order %d, %llu steps, %.3f ms\n\n", ref.order(),
+                (unsigned long long)ref.steps, secs_since(t0) * 1e3);
+
+    std::printf("%-22s %12s %10s %12s %10s %12s\n", "method", "err @ tmax", "steps", "mean h", "ms", "max dE/E0");
+
+    for (const int order : { 0, 10, 15, 20, 25, 30 }) {
+        ds::TaylorConfig cfg;
+        cfg.order = order;
+        ds::Taylor tay(PARAMS, s0, cfg);
+        double de = 0.0;
+        t0 = Clock::now();
+        while (tay.time() < t_max) {
+            tay.step();
+            de = std::max(de, energy_err(tay.state(), e0));
+        }
+        const ds::State end = tay.interpolate(t_max);
+        const double secs = secs_since(t0);
+        const double err = state_err(end, truth);
+
+        char name[32];
+        std::snprintf(name, sizeof name, order ? "taylor order %d" : "taylor (order %d)", tay.order());
+        row(name, err, tay.steps, t_max, secs, de);
+        if (order == 0 && (!(err <= 1e-10) || !(de <= 1e-13))) ok = false;
+    }
+
+    for (const double tol : { 1e-10, 1e-13 }) {
+        ds::DopriConfig cfg;
+        cfg.rtol = cfg.atol = tol;
+        ds::DormandPrince dp(PARAMS, s0, cfg);
+        double de = 0.0;
+        t0 = Clock::now();
+        while (dp.time() < t_max) {
+            dp.step();
+            de = std::max(de, energy_err(dp.state(), e0));
+        }
+        const ds::State end = dp.interpolate(t_max);
+        const double secs = secs_since(t0);
+
+        char name[32];
+        std::snprintf(name, sizeof name, "dopri5 tol %.0e", tol);
+        row(name, state_err(end, truth), dp.accepted + dp.rejected, t_max, secs, de);
+    }
+
+    for (const double steps_per_s : { 240.0, 2400.0, 24000.0 }) {
+        ds::Engine e(PARAMS, s0);
+        const auto steps = static_cast<unsigned long long>(std::llround(t_max * steps_per_s));
+        const double dt = t_max / double(steps);
+        double de = 0.0;
+        t0 = Clock::now();
+        for (unsigned long long i = 0; i < steps; ++i) {
+            e.step(dt);
+            de = std::max(de, energy_err(e.s, e0));
+        }
+        const double secs = secs_since(t0);
+
+        char name[32];
+        std::snprintf(name, sizeof name, "rk4 dt 1/%.0f", steps_per_s);
+        row(name, state_err(e.s, truth), steps, t_max, secs, de);
+    }
+
+    std::printf("\n%s\n", ok ? "double Taylor matches the long double reference"
+                             : "FAIL: double Taylor is off the long double reference");
+    return ok ? 0 : 1;
+}
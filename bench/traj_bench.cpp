@@ -0,0 +1,134 @@
+// Round trip and throughput of the trajectory file format.
+//
+//   doubleswing_traj_bench [--samples N] [--dir PATH]
+//
+// Records one Engine run in each encoding, reads it back sequentially and by random
+// seeks, and checks the result against the in-memory series (Raw must be exact,
+// Quantized within half a quantum). Exits non-zero on any mismatch.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/trajectory.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// max |a - b| per field class, scaled by the quantum of that field
+double quantum_error(const ds::State& a, const ds::State& b, double qa, double qr) {
+    return std::max({ std::abs(a.th1 - b.th1) / qa, std::abs(a.w1 - b.w1) / qr,
+                      std::abs(a.th2 - b.th2) / qa, std::abs(a.w2 - b.w2) / qr });
+}
+
+bool same(const ds::State& a, const ds::State& b) {
+    return a.th1 == b.th1 && a.w1 == b.w1 && a.th2 == b.th2 && a.w2 == b.w2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const auto samples = static_cast<std::size_t>(args.count("samples", 2000000));
+    const std::string dir = args.str("dir", ".");
+    if (!args.check()) return 2;
+    const double dt = 1.0 / 240.0;
+    bool ok = true;
+
+    const ds::Params p{1.0, 1.0, 1.0, 1.0, 9.80665, 0.0};
+    std::vector<ds::State> ref;
+    ref.reserve(samples);
+    {
+        ds::Engine e(p, ds::State{2.0, 0.0, 2.5, 0.0});
+        for (std::size_t i = 0; i < samples; ++i) {
+            ref.push_back(e.s);
+            e.step(dt);
+        }
+    }
+    const double mb = double(samples * sizeof(ds::State)) / (1 << 20);
+
+    std::printf("%-10s %10s %10s %12s %12s %12s %10s\n",
+                "encoding", "bytes/smp", "ratio", "write MB/s", "read MB/s", "seek ns", "max err");
+
+    for (const auto enc : { ds::TrajEncoding::Raw, ds::TrajEncoding::Quantized }) {
+        const bool raw = enc == ds::TrajEncoding::Raw;
+        const std::string path = dir + (raw ? "/traj_bench_raw.dstrj" : "/traj_bench_q.dstrj");
+        ds::TrajectoryOptions opt;
+        opt.encoding = enc;
+
+        auto t0 = Clock::now();
+        {
+            ds::TrajectoryWriter w;
+            bool wrote = w.open(path, p, 0.0, dt, opt);
+            for (const auto& s : ref) wrote = wrote && w.append(s);
+            if (!w.close() || !wrote) {
+                std::fprintf(stderr, "cannot write %s\n", path.c_str());
+                return 1;
+            }
+        }
+        const double write_s = seconds_since(t0);
+
+        ds::TrajectoryReader r;
+        if (!r.open(path) || r.size() != samples || r.params().m2 != p.m2 || r.dt() != dt) {
+            std::fprintf(stderr, "cannot read back %s\n", path.c_str());
+            return 1;
+        }
+
+        // sequential pass, chunk by chunk
+        t0 = Clock::now();
+        double err = 0.0;
+        std::size_t i = 0;
+        for (std::size_t c = 0; c < r.chunk_count(); ++c) {
+            for (const auto& s : r.chunk(c)) {
+                if (raw) { if (!same(s, ref[i])) err = 1e300; }
+                else     err = std::max(err, quantum_error(s, ref[i], opt.angle_quantum, opt.rate_quantum));
+                ++i;
+            }
+        }
+        const double read_s = seconds_since(t0);
+        if (i != samples) err = 1e300;
+
+        // random seeks by time
+        std::mt19937_64 rng(7);
+        std::uniform_real_distribution<double> when(0.0, double(samples) * dt);
+        const int seeks = 20000;
+        t0 = Clock::now();
+        for (int k = 0; k < seeks; ++k) {
+            const double t = when(rng);
+            const std::size_t j = r.index_at(t);
+            const ds::State s = r.at(j);
+            if (j >= samples || double(j) * dt > t + 1e-9 || (j + 1 < samples && double(j + 1) * dt <= t - 1e-9))
+                err = 1e300;
+            else if (raw) { if (!same(s, ref[j])) err = 1e300; }
+            else err = std::max(err, quantum_error(s, ref[j], opt.angle_quantum, opt.rate_quantum));
+        }
+        const double seek_ns = seconds_since(t0) * 1e9 / seeks;
+
+        const bool pass = raw ? err == 0.0 : err <= 0.5 + 1e-6;
+        ok = ok && pass;
+
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        long size = 0;
+        if (f) { std::fseek(f, 0, SEEK_END); size = std::ftell(f); std::fclose(f); }
+        std::printf("%-10s %10.2f %10.2f %12.0f %12.0f %12.0f %10.3g %s\n", raw ? "raw" : "quantized",
+                    double(size) / double(samples), double(samples * sizeof(ds::State)) / double(size),
+                    mb / write_s, mb / read_s, seek_ns, err, pass ? "ok" : "FAIL");
+
+        r.close();
+        std::remove(path.c_str());
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+// Speed and accuracy of Engine's trig tiers against the libm reference kernel.
+//
+//   doubleswing_trig_bench [--samples N]
+//
+// Exits non-zero if any tier exceeds its documented error bound, so it can be
+// run as a check as well as a benchmark.
+
+#include <doubleswing/engine.hpp>
+#include <doubleswing/util.hpp>
+
+#include "../apps/common/args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// documented bounds
+constexpr double SINCOS_ABS_MAX = 4.5e-16;  // sincos_poly, |x| < 1e5
+constexpr double ACCEL_REL_MAX  = 1e-12;    // |a_fast - a_libm| / (|a_libm| + 1), angles in [-pi, pi]
+// with |angle| ~ 1e4 the libm kernel itself loses digits forming th1 - th2, so the
+// comparison is against a noisier reference
+constexpr double ACCEL_REL_WIDE_MAX = 1e-8;
+constexpr double TRAJ_MAX       = 1e-9;     // max state difference after 1 s at dt = 1/240
+
+const char* name(ds::TrigMode m) {
+    switch (m) {
+        case ds::TrigMode::Libm:       return "libm";
+        case ds::TrigMode::Identities: return "identities";
+        case ds::TrigMode::Polynomial: return "polynomial";
+    }
+    return "?";
+}
+
+double state_diff(const ds::State& a, const ds::State& b) {
+    return std::max({ std::abs(a.th1 - b.th1), std::abs(a.w1 - b.w1),
+                      std::abs(a.th2 - b.th2), std::abs(a.w2 - b.w2) });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Args args(argc, argv);
+    const auto samples = static_cast<std::size_t>(args.count("samples", 1000000));
+    if (!args.check()) return 2;
+    bool ok = true;
+
+    std::mt19937_64 rng(12345);
+
+    // sincos_poly vs libm
+    {
+        std::uniform_real_distribution<double> wide(-1e5, 1e5), narrow(-4.0 * ds::PI, 4.0 * ds::PI);
+        double worst = 0.0;
+        for (std::size_t i = 0; i < samples; ++i) {
+            const double x = (i & 1) ? wide(rng) : narrow(rng);
+            double s, c;
+            ds::sincos_poly(x, s, c);
+            worst = std::max({ worst, std::abs(s - std::sin(x)), std::abs(c - std::cos(x)) });
+        }
+        const bool pass = worst <= SINCOS_ABS_MAX;
+        ok = ok && pass;
+        std::printf("sincos_poly     max abs err %.3e (bound %.1e) %s\n", worst, SINCOS_ABS_MAX, pass ? "ok" : "FAIL");
+    }
+
+    // random states, including wrapped-around and adversarial angles
+    const ds::Params p{1.0, 1.3, 1.0, 1.7, 9.80665, 0.02};
+    std::uniform_real_distribution<double> ang(-ds::PI, ds::PI), big(-1e4, 1e4), omega(-20.0, 20.0);
+    std::vector<ds::State> states(std::min<std::size_t>(samples, 200000));
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        const bool adversarial = (i % 8) == 0;
+        states[i] = { adversarial ? big(rng) : ang(rng), omega(rng),
+                      adversarial ? big(rng) : ang(rng), omega(rng) };
+    }
+
+    ds::Engine ref(p, ds::State{});
+    std::printf("%-12s %12s %14s %14s %14s\n", "tier", "ns/accel", "rel err", "rel err wide", "traj diff 1s");
+
+    for (auto mode : { ds::TrigMode::Libm, ds::TrigMode::Identities, ds::TrigMode::Polynomial }) {
+        ds::Engine e(p, ds::State{});
+        e.trig = mode;
+
+        double worst = 0.0, worst_wide = 0.0;
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            double a1, a2, r1, r2;
+            e.accel(states[i], a1, a2);
+            ref.accel(states[i], r1, r2);
+            const double err = std::max(std::abs(a1 - r1) / (std::abs(r1) + 1.0),
+                                        std::abs(a2 - r2) / (std::abs(r2) + 1.0));
+            double& w = (i % 8) == 0 ? worst_wide : worst;
+            w = std::max(w, err);
+        }
+
+        // timing
+        double sink = 0.0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < 5; ++rep) {
+            for (const auto& st : states) {
+                double a1, a2;
+                e.accel(st, a1, a2);
+                sink += a1 + a2;
+            }
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count()
+                          / double(5 * states.size());
+        volatile double keep = sink; // keep the timed loop from being optimized out
+        (void)keep;
+
+        // short-horizon trajectory divergence (chaos amplifies any difference later on)
+        double traj = 0.0;
+        for (int k = 0; k < 16; ++k) {
+            const ds::State s0{ -3.0 + 0.4 * k, 0.0, 2.5 - 0.3 * k, 0.0 };
+            ds::Engine a(p, s0), b(p, s0);
+            a.trig = mode;
+            for (int i = 0; i < 240; ++i) { a.step(1.0 / 240.0); b.step(1.0 / 240.0); }
+            traj = std::max(traj, state_diff(a.s, b.s));
+        }
+
+        const bool pass = worst <= ACCEL_REL_MAX && worst_wide <= ACCEL_REL_WIDE_MAX && traj <= TRAJ_MAX;
+        ok = ok && pass;
+        std::printf("%-12s %12.2f %14.3e %14.3e %14.3e %s\n", name(mode), ns, worst, worst_wide, traj,
+                    pass ? "ok" : "FAIL");
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <doubleswing/ensemble.hpp>
+#include <doubleswing/util.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ds {
+
+// "Time to flip" map over initial (th1, th2), both arms starting at rest.
+// x runs over th1, y over th2 (row 0 = th2_max, so the image is upright).
+struct ChaosMapConfig {
+    Params p{1.0, 1.0, 1.0, 1.0};
+    std::size_t width = 512;
+    std::size_t height = 512;
+    double th1_min = -PI, th1_max = PI;
+    double th2_min = -PI, th2_max = PI;
+
+    double dt = 1.0 / 240.0; // capped at 1/15 s like Engine::step; <= 0 gives an empty map
+    double t_max = 10.0;
+
+    std::size_t tile = 32;   // tile edge in cells; one tile = one task
+    unsigned threads = 0;    // 0 = hardware_concurrency
+    SimdBackend backend = SimdBackend::Auto;
+};
+
+struct ChaosMap {
+    std::size_t width = 0, height = 0;
+    double t_max = 0.0;
+    // seconds until either arm first passes over the top; -1 if it never did within t_max
+    std::vector<float> flip_time;
+};
+
+// Called after each finished tile, from worker threads (calls are serialized).
+using ChaosMapProgress = std::function<void(std::size_t tiles_done, std::size_t tiles_total)>;
+
+[[nodiscard]] ChaosMap chaos_map(const ChaosMapConfig& cfg, const ChaosMapProgress& progress = {});
+
+// true if the starting energy is too low for either arm to ever reach the top
+// (energy only decreases with damping >= 0).
+[[nodiscard]] bool cannot_flip(const Params& p, const State& s);
+
+// Grayscale PNG, log-scaled: fast flips bright, never-flipped black.
+bool write_chaos_map_png(const std::string& path, const ChaosMap& m);
+
+} // namespace ds
@@ -0,0 +1,63 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstdint>
+
+namespace ds {
+
+struct DopriConfig {
+    double rtol = 1e-9;
+    double atol = 1e-9;
+    double h_init = 0.0;   // 0 = pick from the initial derivatives
+    double h_min = 1e-10;  // below this a step is accepted regardless of error
+    double h_max = 0.5;
+};
+
+// Adaptive Dormand-Prince 5(4) integrator with embedded error control and
+// 4th-order dense output, on the same equations of motion as Engine.
+// Meant for offline runs: there is no dt clamp, and the integrator may run
+// ahead of the requested output time and interpolate back.
+class DormandPrince {
+public:
+    Params p;
+
+    DormandPrince(const Params& p, const State& s0, const DopriConfig& cfg = {});
+
+    // state at the end of the last accepted step (angles in [-pi, pi])
+    [[nodiscard]] State state() const;
+    [[nodiscard]] double time() const { return t; }
+
+    // one accepted step (retrying rejected ones); returns its size
+    double step();
+
+    // state at t_out, stepping forward as needed; t_out must not be before the
+    // start of the last accepted step. A non-finite t_out, or a state that has gone
+    // non-finite, returns state() without stepping further.
+    State advance_to(double t_out);
+
+    // dense output inside the last accepted step [time() - last_h, time()]
+    [[nodiscard]] State interpolate(double t_out) const;
+
+    // restart from a new state (drops step history, keeps the step size guess)
+    void reset(const State& s, double t0 = 0.0);
+
+    // work counters
+    std::uint64_t accel_evals = 0;
+    std::uint64_t accepted = 0;
+    std::uint64_t rejected = 0;
+
+private:
+    DopriConfig cfg;
+    Engine eng;         // only used for accel()
+
+    double t = 0.0;
+    double h = 0.0;     // next step size
+    double last_h = 0.0;
+    double y[4];        // th1, w1, th2, w2 (angles wrapped after each step)
+    double k1[4];       // f(y), first-same-as-last
+    double rcont[5][4]; // dense output coefficients for the last step
+
+    void deriv(const double* x, double* dx);
+    double initial_step();
+};
+
+} // namespace ds
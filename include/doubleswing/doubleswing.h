@@ -0,0 +1,111 @@
+/* C ABI of libdoubleswing, for embedding the engine from other languages
+ * (Python ctypes/cffi, Rust, ...). Plain C, no C++ types cross it.
+ *
+ * Every dsn_engine is independent: its own state, parameters and output buffer, so
+ * different handles may be stepped from different threads at once. One handle must
+ * not be used from two threads at the same time.
+ *
+ * Arrays are caller-owned and row-major:
+ *   params  l1, l2, m1, m2, g, damping          (DSN_PARAMS_LEN doubles)
+ *   state   th1, w1, th2, w2                    (DSN_STATE_LEN doubles)
+ *   output  DSN_OUT_* below                     (DSN_OUT_LEN doubles)
+ * Bulk calls take n handles and n rows of the matching length.
+ *
+ * Functions returning int give 1 on success and 0 on bad arguments (nothing changed). */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(DSN_BUILDING)
+#    define DSN_API __declspec(dllexport)
+#  else
+#    define DSN_API __declspec(dllimport)
+#  endif
+#else
+#  define DSN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bumped on any incompatible change to the functions or layouts below */
+#define DSN_ABI_VERSION 1
+
+/* largest dt a step accepts (Engine caps its steps here) */
+#define DSN_MAX_DT (1.0 / 15.0)
+
+enum { DSN_PARAMS_LEN = 6, DSN_STATE_LEN = 4 };
+
+/* Per-handle output, refreshed by every step call and by dsn_snapshot.
+ * Positions in metres relative to the pivot, +y down; energies in joules. */
+enum {
+    DSN_OUT_X1, DSN_OUT_Y1, DSN_OUT_X2, DSN_OUT_Y2,
+    DSN_OUT_TH1, DSN_OUT_W1, DSN_OUT_TH2, DSN_OUT_W2,
+    DSN_OUT_KE, DSN_OUT_PE, DSN_OUT_E,
+    DSN_OUT_TIME,   /* seconds stepped since create (or the last dsn_set_time) */
+    DSN_OUT_STEPS,  /* steps taken since create */
+    DSN_OUT_LEN
+};
+
+/* values of dsn_set_integrator / dsn_set_trig (ds::Integrator / ds::TrigMode) */
+enum { DSN_RK4, DSN_IMPLICIT_MIDPOINT, DSN_GAUSS_LEGENDRE4 };
+enum { DSN_TRIG_LIBM, DSN_TRIG_IDENTITIES, DSN_TRIG_POLYNOMIAL };
+
+typedef struct dsn_engine dsn_engine;
+typedef struct dsn_pool dsn_pool;
+
+DSN_API int dsn_abi_version(void);
+
+/* NULL if params are invalid (lengths and masses must be > 0, all finite) or out of memory */
+DSN_API dsn_engine* dsn_create(const double* params, const double* state);
+DSN_API void dsn_destroy(dsn_engine* e);
+
+DSN_API int dsn_set_params(dsn_engine* e, const double* params);
+DSN_API void dsn_get_params(const dsn_engine* e, double* params);
+DSN_API void dsn_set_state(dsn_engine* e, const double* state);
+DSN_API void dsn_get_state(const dsn_engine* e, double* state);
+DSN_API void dsn_set_time(dsn_engine* e, double time);
+DSN_API int dsn_set_integrator(dsn_engine* e, int integrator);
+DSN_API int dsn_set_trig(dsn_engine* e, int trig);
+/* Engine::linear_tol: small swings are stepped in closed form (0 = off, the default) */
+DSN_API int dsn_set_linear_tol(dsn_engine* e, double tol);
+
+/* The handle's output array (DSN_OUT_LEN doubles). The address is fixed for the
+ * handle's lifetime, so it can be wrapped once (numpy.ctypeslib.as_array, a Rust
+ * slice); the contents change with each step call. */
+DSN_API const double* dsn_output(const dsn_engine* e);
+DSN_API void dsn_snapshot(dsn_engine* e);
+
+/* n steps of dt; requires 0 < dt <= DSN_MAX_DT */
+DSN_API int dsn_step_n(dsn_engine* e, double dt, uint64_t n);
+
+/* n steps with bob 1 held at (th1, w1, a1) and bob 2 integrated (Engine::step_drag_p1) */
+DSN_API int dsn_step_drag_p1_n(dsn_engine* e, double dt, uint64_t n, double th1, double w1, double a1);
+
+/* n steps of dt, writing the state after every `every`th step to rows
+ * (n / every rows of DSN_STATE_LEN); returns the number of rows written, 0 on bad
+ * arguments. A whole trajectory in one call. */
+DSN_API uint64_t dsn_run(dsn_engine* e, double dt, uint64_t n, uint64_t every, double* rows);
+
+/* ---- many handles per call ---- */
+
+/* Worker threads for dsn_step_many (threads == 0: one per core). NULL if the threads
+ * cannot be started. */
+DSN_API dsn_pool* dsn_pool_create(unsigned threads);
+DSN_API void dsn_pool_destroy(dsn_pool* pool);
+
+DSN_API void dsn_get_states(const dsn_engine* const* handles, size_t n, double* states);
+DSN_API void dsn_set_states(dsn_engine* const* handles, size_t n, const double* states);
+DSN_API void dsn_get_outputs(const dsn_engine* const* handles, size_t n, double* outputs);
+
+/* steps every handle by `steps` steps of dt; across pool's threads if pool is not
+ * NULL (handles must be distinct), in the calling thread otherwise. 0 on bad dt or
+ * if the pool fails to run the job (nothing stepped). */
+DSN_API int dsn_step_many(dsn_pool* pool, dsn_engine* const* handles, size_t n, double dt, uint64_t steps);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,22 +3,82 @@
 namespace ds {
 
 // delta in [-pi, pi]
-double unwrap_delta(double new_theta, double prev_theta);
+template <class Real>
+Real unwrap_delta(Real new_theta, Real prev_theta);
 
-struct DragFilter {
-    double omega = 0.0;
-    double prev_theta = 0.0;
+// Real matches the engine it drives (DragFilter for Engine, DragFilterF for EngineF).
+template <class Real>
+struct DragFilterOf {
+    Real omega = Real(0);
+    Real prev_theta = Real(0);
     bool has_prev = false;
 
     // alpha in [0,1], clamp in rad/s.
     // returns filtered omega (also stored in omega)
-    double update(double theta, double dt, double alpha, double omega_max);
+    Real update(Real theta, Real dt, Real alpha, Real omega_max);
 
-    void reset(double theta) {
+    void reset(Real theta) {
         prev_theta = theta;
-        omega = 0.0;
+        omega = Real(0);
         has_prev = true;
     }
 };
 
+// theta, omega and alpha of a dragged rod at one instant
+template <class Real>
+struct DragEstimateOf {
+    Real theta = Real(0); // [-pi, pi]
+    Real omega = Real(0);
+    Real alpha = Real(0);
+};
+
+// Tracks a dragged angle from timestamped pointer samples with a critically damped
+// alpha-beta-gamma (fading-memory polynomial) filter: each sample corrects a constant-
+// acceleration prediction, with gains from theta = exp(-dt / tau), so irregular or
+// coalesced sample intervals are weighted by their actual length. Unlike DragFilter's
+// low-pass on finite differences, omega has no steady lag on a constant-rate drag and
+// alpha is estimated too, so step_drag_p1 can be forced with it instead of 0.
+//
+// at(t) extrapolates to the physics step's time (plus `lead`, to cover display and
+// input latency), up to max_lead past the last sample; a pointer held still with no
+// samples for longer than that is taken as stopped.
+template <class Real>
+struct DragEstimatorOf {
+    // tuning
+    Real tau = Real(0.025);       // s; memory (smaller: less lag, more noise)
+    Real omega_max = Real(15.0);  // rad/s
+    Real alpha_max = Real(400.0); // rad/s^2
+    Real lead = Real(0);          // s added to every at() query
+    Real max_lead = Real(0.05);   // s; extrapolation limit past the last sample
+
+    // filter state at the last sample (theta unwrapped, so it is continuous)
+    Real theta = Real(0);
+    Real omega = Real(0);
+    Real alpha = Real(0);
+    Real time = Real(0);
+    bool has_prev = false;
+
+    // start at rest at theta (a grab)
+    void reset(Real theta, Real time);
+
+    // one pointer sample taken at `time` (any monotonic clock, seconds); samples must
+    // come in time order; one at the same time as the last replaces it
+    void update(Real theta, Real time);
+
+    [[nodiscard]] DragEstimateOf<Real> at(Real time) const;
+};
+
+// defined in drag.cpp for these two
+extern template double unwrap_delta<double>(double, double);
+extern template float unwrap_delta<float>(float, float);
+extern template struct DragFilterOf<double>;
+extern template struct DragFilterOf<float>;
+extern template struct DragEstimatorOf<double>;
+extern template struct DragEstimatorOf<float>;
+
+using DragFilter = DragFilterOf<double>;
+using DragFilterF = DragFilterOf<float>;
+using DragEstimate = DragEstimateOf<double>;
+using DragEstimator = DragEstimatorOf<double>;
+
 } // namespace ds
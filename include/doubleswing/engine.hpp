@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 
 namespace ds {
 
@@ -20,38 +21,159 @@ struct EnergyBreakdown {
     double total() const { return ke + pe; }
 };
 
-class Engine {
+// Scheme used by Engine::step (step_drag_p1 always uses RK4).
+enum class Integrator {
+    RK4,              // explicit, 4th order (default)
+    ImplicitMidpoint, // symplectic, 2nd order
+    GaussLegendre4,   // symplectic, 4th order (2-stage Gauss collocation)
+};
+
+// How Engine::accel evaluates its trig terms.
+enum class TrigMode {
+    Libm,       // six libm calls per evaluation (reference)
+    Identities, // sin/cos of th1 and th2 only; the rest from angle-sum identities
+    Polynomial, // Identities, with sincos_poly (util.hpp) instead of libm
+};
+
+// Params / State in another scalar type (EngineF, BasicEngine<float policy> etc.)
+template <class Real>
+struct BasicParams {
+    Real l1, l2;
+    Real m1, m2;
+    Real g = Real(9.80665);
+    Real damping = Real(0);
+};
+
+template <class Real>
+struct BasicState {
+    Real th1, w1;
+    Real th2, w2;
+};
+
+// double keeps the existing structs, so Engine and the double policies share them
+template <class Real>
+using ParamsOf = std::conditional_t<std::is_same_v<Real, double>, Params, BasicParams<Real>>;
+template <class Real>
+using StateOf = std::conditional_t<std::is_same_v<Real, double>, State, BasicState<Real>>;
+
+template <class Real>
+ParamsOf<Real> params_as(const Params& p) {
+    return { Real(p.l1), Real(p.l2), Real(p.m1), Real(p.m2), Real(p.g), Real(p.damping) };
+}
+
+template <class Real>
+StateOf<Real> state_as(const State& s) {
+    return { Real(s.th1), Real(s.w1), Real(s.th2), Real(s.w2) };
+}
+
+template <class S>
+State state_from(const S& s) {
+    return { double(s.th1), double(s.w1), double(s.th2), double(s.w2) };
+}
+
+// Normal modes of the pendulum linearized about the hanging rest state,
+//   M q'' + K q = -damping * M q',   q = (th1, th2),
+// the small-swing limit of both the Lagrangian and the momentum-form equations. Each
+// mode is a damped oscillator with a closed-form solution, so a small swing can be
+// advanced by any dt at O(1) cost (Engine::step_linear).
+template <class Real>
+struct NormalModesOf {
+    ParamsOf<Real> p{};     // params the modes were built for
+    Real omega[2] = {};     // undamped angular frequencies, rad/s, slow mode first
+    Real shape[2][2] = {};  // mode shapes as columns, in (th1, th2)
+    Real inv[2][2] = {};    // shape^-1, state -> mode coordinates
+    Real mass[3] = {};      // M: (0,0), (0,1), (1,1)
+    Real stiff[2] = {};     // diagonal of K
+    Real error_scale = Real(0);
+    bool valid = false;
+    Real step_dt = Real(-1);  // dt of the cached propagator
+    Real prop[2][2] = {};     // per mode: decay * cos, decay * sin / wd over step_dt
+
+    // false (and valid = false) without a stable rest state: g <= 0, or a length
+    // or mass that is not positive
+    bool build(const ParamsOf<Real>& params);
+    [[nodiscard]] bool built_for(const ParamsOf<Real>& params) const;
+
+    // Estimated relative size of the terms linearization drops (x - sin x, 1 - cos x,
+    // the centripetal omega^2 terms), at the largest angles s's energy allows. That
+    // energy is energy_breakdown() to second order, so it is conserved (or decays)
+    // along the linear motion and the estimate holds for all later steps too; an
+    // angle far from 0 (an unwrapped 2 pi, say) shows up as a large energy.
+    [[nodiscard]] Real linear_error(const StateOf<Real>& s) const;
+
+    // s after dt of linear motion (any dt >= 0); the propagator for the last dt is kept
+    void advance(StateOf<Real>& s, Real dt);
+};
+
+// Runtime-configurable engine. Each step picks the equations-of-motion kernel for the
+// current (damping != 0, trig, integrator) combination from engine_policy.hpp; use
+// BasicEngine there when the configuration is known at compile time.
+//
+// Real is the type of the state and of the kernel arithmetic: Engine (double) is the
+// reference, EngineF (float) halves the state and doubles the SIMD width at the cost
+// of precision; divergence_report() in precision.hpp measures how much.
+template <class Real>
+class EngineOf {
 public:
-    Params p;
-    State  s;
+    using real = Real;
+    using params_type = ParamsOf<Real>;
+    using state_type = StateOf<Real>;
+
+    params_type p;
+    state_type  s;
+
+    // The symplectic schemes integrate the Hamiltonian form (canonical momenta), so
+    // undamped runs keep a bounded energy error instead of drifting. Damping enters
+    // as the generalized force -damping * p.
+    Integrator integrator = Integrator::RK4;
+
+    // Build with DS_FAST_TRIG_DEFAULT (CMake: DOUBLESWING_FAST_TRIG) to default to Identities.
+#if defined(DS_FAST_TRIG_DEFAULT)
+    TrigMode trig = TrigMode::Identities;
+#else
+    TrigMode trig = TrigMode::Libm;
+#endif
+
+    // Small-swing fast path, off at 0: while the linearization error estimate
+    // (NormalModesOf::linear_error) is at most linear_tol, step() advances the normal
+    // modes in closed form instead of integrating, and goes back to the integrator
+    // once a change of state or params pushes the estimate above it. The closed form
+    // drifts from the nonlinear solution by at most about linear_tol per radian of the
+    // fast mode's phase (omega * t), relative to the swing (doubleswing_linear_bench).
+    Real linear_tol = Real(0);
 
-    explicit Engine(const Params& p, const State& s0);
+    explicit EngineOf(const params_type& p, const state_type& s0);
 
-    void step(double dt);
+    void step(Real dt);
 
-    void bob_positions(double& x1, double& y1, double& x2, double& y2) const;
+    // Advance by dt (not capped, O(1) whatever its size) in closed form if the
+    // linearization error estimate is within linear_tol; false, with the state left
+    // alone, otherwise.
+    bool step_linear(Real dt);
 
+    void bob_positions(Real& x1, Real& y1, Real& x2, Real& y2) const;
+
+    // accumulated in double whatever Real is
     [[nodiscard]] EnergyBreakdown energy_breakdown() const;
 
     // When th1, w1, a1 are externally imposed, integrate only (th2, w2) with moving-pivot dynamics.
-    void step_drag_p1(double dt, double th1, double w1, double a1);
+    void step_drag_p1(Real dt, Real th1, Real w1, Real a1);
 
-private:
     // returns angular accelerations (th1dd, th2dd) for given state
-    void accel(const State& st, double& a1, double& a2) const;
-
-    // RK4 step on (th1,w1,th2,w2)
-    void rk4(State& st, double dt) const;
+    // (public so other integrators can share the equations of motion)
+    void accel(const state_type& st, Real& a1, Real& a2) const;
 
-    // theta2'' when pivot (bob1) has cartesian acceleration (xdd,ydd)
-    double accel_theta2_moving_pivot(double th2, double w2, double xdd, double ydd) const;
+    NormalModesOf<Real> modes; // step_linear's cache, rebuilt when p changes
+};
 
-    // RK4 integrate only (th2, w2) given pivot accel
-    void rk4_th2(double& th2, double& w2, double dt, double xdd, double ydd) const;
+// defined in engine.cpp / normal_modes.cpp for these two
+extern template struct NormalModesOf<double>;
+extern template struct NormalModesOf<float>;
+extern template class EngineOf<double>;
+extern template class EngineOf<float>;
 
-    // bob1 cartesian acceleration from (th1,w1,a1)
-    static void bob1_cart_accel(const Params& p, double th1, double w1, double a1,
-                                double& xdd, double& ydd);
-};
+using Engine = EngineOf<double>;
+using EngineF = EngineOf<float>;
+using NormalModes = NormalModesOf<double>;
 
 } // namespace ds
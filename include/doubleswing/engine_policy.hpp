@@ -0,0 +1,445 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <doubleswing/stats.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace ds {
+
+// How a policy engine brings angles back into [-pi, pi] after each step.
+enum class AngleWrap {
+    Loop,  // normalize_angle (what Engine does): two compares when already in range
+    Round, // a - 2*pi*nearbyint(a / 2*pi): branch-free, same result for in-range angles
+    None,  // no wrapping; angles stay continuous, precision degrades on very long runs
+};
+
+// Compile-time configuration of BasicEngine. Every choice Engine makes at run time
+// (damping, trig tier, integrator) is a template argument here, so the step kernel has
+// no branches left in it. Undamped policies ignore Params::damping entirely.
+template <class Real = double, bool Damped = true, TrigMode Trig = TrigMode::Libm,
+          Integrator Method = Integrator::RK4, AngleWrap Wrap = AngleWrap::Loop>
+struct EnginePolicy {
+    using real = Real;
+    static constexpr bool damped = Damped;
+    static constexpr TrigMode trig = Trig;
+    static constexpr Integrator integrator = Method;
+    static constexpr AngleWrap wrap = Wrap;
+};
+
+namespace detail {
+
+// The equations of motion, shared by Engine (which picks an instantiation at run time)
+// and BasicEngine. With Real = double each instantiation does exactly the arithmetic
+// Engine did before it dispatched here.
+
+template <AngleWrap Wrap, class Real>
+Real wrap_angle(Real a) {
+    if constexpr (Wrap == AngleWrap::Loop) {
+        return normalize_angle(a);
+    } else if constexpr (Wrap == AngleWrap::Round) {
+        constexpr Real TWO_PI = Real(2.0 * PI);
+        constexpr Real INV_TWO_PI = Real(1.0 / (2.0 * PI));
+        return a - TWO_PI * std::nearbyint(a * INV_TWO_PI);
+    } else {
+        return a;
+    }
+}
+
+template <TrigMode Trig, class Real>
+void sincos_tier(Real x, Real& s, Real& c) {
+    if constexpr (Trig == TrigMode::Polynomial) {
+        double sd, cd;
+        sincos_poly(double(x), sd, cd);
+        s = Real(sd);
+        c = Real(cd);
+    } else {
+        s = std::sin(x);
+        c = std::cos(x);
+    }
+}
+
+// Stats hook for accel's denominator guard (stats.hpp); compiled out without DS_STATS.
+template <class Real>
+void note_denom(Real denom, Real eps) {
+    if constexpr (stats_enabled) {
+        DS_STAT(AccelCalls);
+        if (std::abs(denom) < eps) {
+            DS_STAT(DenomClamps);
+            DS_TRACE(DenomClamp, denom);
+        }
+    }
+}
+
+template <class Pol, class P, class S, class Real = typename Pol::real>
+void accel(const P& p, const S& st, Real& a1, Real& a2) {
+    const Real w1 = st.w1;
+    const Real w2 = st.w2;
+
+    const Real m1 = p.m1;
+    const Real m2 = p.m2;
+    const Real l1 = p.l1;
+    const Real l2 = p.l2;
+    const Real g  = p.g;
+
+    // Protect against denom ~ 0 spikes
+    const Real eps = Real(1e-12);
+
+    if constexpr (Pol::trig == TrigMode::Libm) {
+        // Angles measured from vertical
+        const Real th1 = st.th1;
+        const Real th2 = st.th2;
+        const Real dth = th1 - th2;
+
+        const Real denom = (Real(2.0)*m1 + m2 - m2*std::cos(Real(2.0)*dth));
+        const Real denom1 = std::max(std::abs(denom), eps) * (denom < 0 ? Real(-1.0) : Real(1.0));
+        note_denom(denom, eps);
+
+        a1 = (-g*(Real(2.0)*m1 + m2)*std::sin(th1)
+              - m2*g*std::sin(th1 - Real(2.0)*th2)
+              - Real(2.0)*std::sin(dth)*m2*(w2*w2*l2 + w1*w1*l1*std::cos(dth)))
+             / (l1 * denom1);
+
+        a2 = ( Real(2.0)*std::sin(dth) *
+              ( w1*w1*l1*(m1 + m2)
+                + g*(m1 + m2)*std::cos(th1)
+                + w2*w2*l2*m2*std::cos(dth) ) )
+             / (l2 * denom1);
+    } else {
+        Real s1, c1, s2, c2;
+        sincos_tier<Pol::trig>(Real(st.th1), s1, c1);
+        sincos_tier<Pol::trig>(Real(st.th2), s2, c2);
+
+        // dth = th1 - th2, and th1 - 2*th2 = dth - th2
+        const Real sd = s1*c2 - c1*s2;
+        const Real cd = c1*c2 + s1*s2;
+        const Real s_mix = sd*c2 - cd*s2;
+
+        // 2*m1 + m2 - m2*cos(2*dth) == 2*m1 + 2*m2*sin^2(dth), without the cancellation
+        const Real denom = Real(2.0)*m1 + Real(2.0)*m2*sd*sd;
+        const Real denom1 = std::max(std::abs(denom), eps) * (denom < 0 ? Real(-1.0) : Real(1.0));
+        note_denom(denom, eps);
+
+        a1 = (-g*(Real(2.0)*m1 + m2)*s1
+              - m2*g*s_mix
+              - Real(2.0)*sd*m2*(w2*w2*l2 + w1*w1*l1*cd))
+             / (l1 * denom1);
+
+        a2 = ( Real(2.0)*sd *
+              ( w1*w1*l1*(m1 + m2)
+                + g*(m1 + m2)*c1
+                + w2*w2*l2*m2*cd ) )
+             / (l2 * denom1);
+    }
+
+    // Simple viscous damping on angular velocities
+    if constexpr (Pol::damped) {
+        a1 -= Real(p.damping) * w1;
+        a2 -= Real(p.damping) * w2;
+    }
+}
+
+// RK4 step on (th1,w1,th2,w2)
+template <class Pol, class P, class S, class Real = typename Pol::real>
+void rk4(const P& p, S& st, Real dt) {
+    auto deriv = [&](const S& x) -> S {
+        Real a1, a2;
+        accel<Pol>(p, x, a1, a2);
+        return S{ x.w1, a1, x.w2, a2 };
+    };
+
+    const Real half = Real(0.5) * dt;
+
+    const S k1 = deriv(st);
+
+    S tmp = st;
+    tmp.th1 += half * k1.th1;
+    tmp.w1  += half * k1.w1;
+    tmp.th2 += half * k1.th2;
+    tmp.w2  += half * k1.w2;
+    const S k2 = deriv(tmp);
+
+    tmp = st;
+    tmp.th1 += half * k2.th1;
+    tmp.w1  += half * k2.w1;
+    tmp.th2 += half * k2.th2;
+    tmp.w2  += half * k2.w2;
+    const S k3 = deriv(tmp);
+
+    tmp = st;
+    tmp.th1 += dt * k3.th1;
+    tmp.w1  += dt * k3.w1;
+    tmp.th2 += dt * k3.th2;
+    tmp.w2  += dt * k3.w2;
+    const S k4 = deriv(tmp);
+
+    const Real sixth = dt / Real(6.0);
+    st.th1 += sixth * (k1.th1 + Real(2.0)*k2.th1 + Real(2.0)*k3.th1 + k4.th1);
+    st.w1  += sixth * (k1.w1  + Real(2.0)*k2.w1  + Real(2.0)*k3.w1  + k4.w1);
+    st.th2 += sixth * (k1.th2 + Real(2.0)*k2.th2 + Real(2.0)*k3.th2 + k4.th2);
+    st.w2  += sixth * (k1.w2  + Real(2.0)*k2.w2  + Real(2.0)*k3.w2  + k4.w2);
+
+    // Bound angles to avoid precision blowups over long runs
+    st.th1 = wrap_angle<Pol::wrap>(st.th1);
+    st.th2 = wrap_angle<Pol::wrap>(st.th2);
+}
+
+// canonical momenta <-> angular velocities at the same angles
+template <class P, class S, class Real>
+void to_momenta(const P& p, const S& st, Real& p1, Real& p2) {
+    const Real c = std::cos(st.th1 - st.th2);
+    p1 = (p.m1 + p.m2)*p.l1*p.l1*st.w1 + p.m2*p.l1*p.l2*c*st.w2;
+    p2 = p.m2*p.l2*p.l2*st.w2 + p.m2*p.l1*p.l2*c*st.w1;
+}
+
+template <class P, class Real>
+void from_momenta(const P& p, Real th1, Real th2, Real p1, Real p2, Real& w1, Real& w2) {
+    const Real m1 = p.m1, m2 = p.m2;
+    const Real l1 = p.l1, l2 = p.l2;
+
+    const Real dth = th1 - th2;
+    const Real c = std::cos(dth), sn = std::sin(dth);
+    const Real mu = m1 + m2*sn*sn;
+
+    w1 = (l2*p1 - l1*p2*c) / (l1*l1*l2*mu);
+    w2 = (l1*(m1 + m2)*p2 - l2*m2*p1*c) / (l1*l2*l2*m2*mu);
+}
+
+// Hamilton's equations: y = (th1, th2, p1, p2)
+template <class Pol, class P, class Real = typename Pol::real>
+void hamilton(const P& p, const Real* y, Real* dy) {
+    const Real th1 = y[0], th2 = y[1];
+    const Real p1  = y[2], p2  = y[3];
+
+    const Real m1 = p.m1, m2 = p.m2;
+    const Real l1 = p.l1, l2 = p.l2;
+    const Real g  = p.g;
+
+    const Real dth = th1 - th2;
+    const Real c = std::cos(dth), sn = std::sin(dth);
+    const Real mu = m1 + m2*sn*sn;
+
+    // dq/dt = dH/dp
+    dy[0] = (l2*p1 - l1*p2*c) / (l1*l1*l2*mu);
+    dy[1] = (l1*(m1 + m2)*p2 - l2*m2*p1*c) / (l1*l2*l2*m2*mu);
+
+    // dp/dt = -dH/dq
+    const Real h1 = p1*p2*sn / (l1*l2*mu);
+    const Real h2 = (m2*l2*l2*p1*p1 + (m1 + m2)*l1*l1*p2*p2 - Real(2.0)*m2*l1*l2*p1*p2*c)
+                    / (Real(2.0)*l1*l1*l2*l2*mu*mu);
+    const Real s2 = Real(2.0)*sn*c; // sin(2*dth)
+
+    dy[2] = -(m1 + m2)*g*l1*std::sin(th1) - h1 + h2*s2;
+    dy[3] = -m2*g*l2*std::sin(th2) + h1 - h2*s2;
+
+    // viscous damping on omegas is -damping * p in momentum form
+    if constexpr (Pol::damped) {
+        dy[2] -= Real(p.damping) * p1;
+        dy[3] -= Real(p.damping) * p2;
+    }
+}
+
+// Gauss-Legendre collocation (1 or 2 stages) on (th1,th2,p1,p2)
+template <class Pol, int Stages, class P, class S, class Real = typename Pol::real>
+void gauss(const P& p, S& st, Real dt) {
+    static_assert(Stages == 1 || Stages == 2);
+
+    // Butcher tableau of the s-stage Gauss-Legendre method
+    const Real r3 = std::sqrt(Real(3.0));
+    const Real a1[1][1] = { { Real(0.5) } };
+    const Real b1[1] = { Real(1.0) };
+    const Real a2[2][2] = { { Real(0.25), Real(0.25) - r3/Real(6.0) },
+                            { Real(0.25) + r3/Real(6.0), Real(0.25) } };
+    const Real b2[2] = { Real(0.5), Real(0.5) };
+
+    const Real* a = Stages == 1 ? &a1[0][0] : &a2[0][0];
+    const Real* b = Stages == 1 ? b1 : b2;
+
+    Real y[4];
+    y[0] = st.th1;
+    y[1] = st.th2;
+    to_momenta(p, st, y[2], y[3]);
+
+    // stage derivatives K_i = f(y + dt * sum_j a_ij K_j), solved by fixed-point
+    // iteration (contractive for the step sizes Engine::step allows)
+    Real k[Stages][4], yi[4], kn[4];
+    hamilton<Pol>(p, y, k[0]);
+    for (int i = 1; i < Stages; ++i)
+        for (int c = 0; c < 4; ++c) k[i][c] = k[0][c];
+
+    // 1e-15 in double; a few ulp for narrower types
+    const Real tol = std::max(Real(1e-15), Real(4.5) * std::numeric_limits<Real>::epsilon());
+    const int max_iter = 50;
+    for (int it = 0; it < max_iter; ++it) {
+        Real change = 0, scale = 0;
+        for (int i = 0; i < Stages; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                Real acc = 0;
+                for (int j = 0; j < Stages; ++j) acc += a[i*Stages + j] * k[j][c];
+                yi[c] = y[c] + dt*acc;
+            }
+            hamilton<Pol>(p, yi, kn);
+            for (int c = 0; c < 4; ++c) {
+                change = std::max(change, std::abs(kn[c] - k[i][c]));
+                scale  = std::max(scale, std::abs(kn[c]));
+                k[i][c] = kn[c];
+            }
+        }
+        if (change <= tol * std::max(scale, Real(1.0))) break;
+    }
+
+    for (int c = 0; c < 4; ++c) {
+        Real acc = 0;
+        for (int i = 0; i < Stages; ++i) acc += b[i] * k[i][c];
+        y[c] += dt*acc;
+    }
+
+    st.th1 = wrap_angle<Pol::wrap>(y[0]);
+    st.th2 = wrap_angle<Pol::wrap>(y[1]);
+    from_momenta(p, st.th1, st.th2, y[2], y[3], st.w1, st.w2);
+}
+
+// One step of the policy's integrator; dt is used as given (no clamp).
+template <class Pol, class P, class S, class Real = typename Pol::real>
+void step(const P& p, S& st, Real dt) {
+    if constexpr (Pol::integrator == Integrator::RK4) rk4<Pol>(p, st, dt);
+    else if constexpr (Pol::integrator == Integrator::ImplicitMidpoint) gauss<Pol, 1>(p, st, dt);
+    else gauss<Pol, 2>(p, st, dt);
+}
+
+// theta2'' when the pivot (bob1) has cartesian acceleration (xdd,ydd):
+// th2'' = -(g/l2) * sin(th2) - (xdd*cos(th2) + ydd*sin(th2))/l2 - damping*w2
+template <class Pol, class P, class Real = typename Pol::real>
+Real accel_theta2_moving_pivot(const P& p, Real th2, Real w2, Real xdd, Real ydd) {
+    const Real s2 = std::sin(th2);
+    const Real c2 = std::cos(th2);
+
+    Real a2 = -(p.g / p.l2) * s2
+              - (xdd * c2 + ydd * s2) / p.l2;
+
+    if constexpr (Pol::damped) a2 -= Real(p.damping) * w2;
+    return a2;
+}
+
+// RK4 integrate only (th2, w2) given pivot accel
+template <class Pol, class P, class Real = typename Pol::real>
+void rk4_th2(const P& p, Real& th2, Real& w2, Real dt, Real xdd, Real ydd) {
+    auto deriv = [&](Real th, Real w) {
+        // d/dt th = w, d/dt w = a(th,w)
+        const Real a = accel_theta2_moving_pivot<Pol>(p, th, w, xdd, ydd);
+        return std::pair<Real, Real>(w, a);
+    };
+
+    const auto [k1_th, k1_w] = deriv(th2, w2);
+
+    const auto [k2_th, k2_w] = deriv(th2 + Real(0.5)*dt*k1_th, w2 + Real(0.5)*dt*k1_w);
+
+    const auto [k3_th, k3_w] = deriv(th2 + Real(0.5)*dt*k2_th, w2 + Real(0.5)*dt*k2_w);
+
+    const auto [k4_th, k4_w] = deriv(th2 + dt*k3_th, w2 + dt*k3_w);
+
+    th2 += (dt/Real(6.0)) * (k1_th + Real(2)*k2_th + Real(2)*k3_th + k4_th);
+    w2  += (dt/Real(6.0)) * (k1_w  + Real(2)*k2_w  + Real(2)*k3_w  + k4_w);
+
+    th2 = wrap_angle<Pol::wrap>(th2);
+}
+
+// Engine::step_drag_p1 without the dt clamp: th1, w1, a1 imposed, (th2, w2) integrated.
+template <class Pol, class P, class S, class Real = typename Pol::real>
+void step_drag_p1(const P& p, S& st, Real dt, Real th1, Real w1, Real a1) {
+    st.th1 = wrap_angle<Pol::wrap>(th1);
+    st.w1  = w1;
+
+    // bob1 cartesian acceleration from (th1,w1,a1):
+    // x = l1*sin(th1), y = l1*cos(th1)
+    const Real s = std::sin(st.th1);
+    const Real c = std::cos(st.th1);
+    const Real xdd = p.l1 * (a1 * c - (st.w1*st.w1) * s);
+    const Real ydd = p.l1 * (-a1 * s - (st.w1*st.w1) * c);
+
+    Real th2 = st.th2;
+    Real w2  = st.w2;
+    rk4_th2<Pol>(p, th2, w2, dt, xdd, ydd);
+
+    st.th2 = th2;
+    st.w2  = w2;
+}
+
+// energies are always accumulated in double
+template <class P, class S>
+EnergyBreakdown energy_breakdown(const P& p, const S& st) {
+    const double th1 = st.th1, th2 = st.th2;
+    const double w1 = st.w1, w2 = st.w2;
+
+    const double m1 = p.m1, m2 = p.m2;
+    const double l1 = p.l1, l2 = p.l2;
+    const double g  = p.g;
+
+    const double v1_sq = (l1*w1)*(l1*w1);
+    const double v2_sq = v1_sq + (l2*w2)*(l2*w2) + 2.0*l1*l2*w1*w2*std::cos(th1 - th2);
+
+    const double ke = 0.5*m1*v1_sq + 0.5*m2*v2_sq;
+
+    const double pe = (m1 + m2)*g*l1*(1 - std::cos(th1)) + m2*g*l2*(1 - std::cos(th2));
+
+    return {ke, pe};
+}
+
+} // namespace detail
+
+// Engine with its configuration fixed at compile time: each Policy compiles to a
+// straight-line kernel (no damping test, trig tier switch or integrator switch per
+// evaluation). Unlike Engine, step() does not clamp dt; callers pass a sane step.
+//
+//   BasicEngine<EnginePolicy<double, false>> e(p, s0);          // undamped RK4, libm
+//   BasicEngine<EnginePolicy<double, true, TrigMode::Polynomial,
+//                            Integrator::GaussLegendre4>> g(p, s0);
+//
+// With Real = double and AngleWrap::Loop a policy matching Engine's settings steps bit
+// for bit the same as Engine.
+template <class Policy = EnginePolicy<>>
+class BasicEngine {
+public:
+    using policy = Policy;
+    using real = typename Policy::real;
+    using params_type = ParamsOf<real>;
+    using state_type = StateOf<real>;
+
+    params_type p;
+    state_type  s;
+
+    BasicEngine(const params_type& params, const state_type& s0) : p(params), s(s0) {
+        s.th1 = detail::wrap_angle<Policy::wrap>(s.th1);
+        s.th2 = detail::wrap_angle<Policy::wrap>(s.th2);
+    }
+
+    void step(real dt) { detail::step<Policy>(p, s, dt); }
+
+    // `steps` steps of dt with the state held in locals between them
+    void run(real dt, std::size_t steps) {
+        state_type st = s;
+        for (std::size_t i = 0; i < steps; ++i) detail::step<Policy>(p, st, dt);
+        s = st;
+    }
+
+    void step_drag_p1(real dt, real th1, real w1, real a1) {
+        detail::step_drag_p1<Policy>(p, s, dt, th1, w1, a1);
+    }
+
+    void accel(const state_type& st, real& a1, real& a2) const { detail::accel<Policy>(p, st, a1, a2); }
+
+    void bob_positions(real& x1, real& y1, real& x2, real& y2) const {
+        x1 = p.l1 * std::sin(s.th1);
+        y1 = p.l1 * std::cos(s.th1);
+        x2 = x1 + p.l2 * std::sin(s.th2);
+        y2 = y1 + p.l2 * std::cos(s.th2);
+    }
+
+    [[nodiscard]] EnergyBreakdown energy_breakdown() const { return detail::energy_breakdown(p, s); }
+};
+
+} // namespace ds
@@ -0,0 +1,66 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace ds {
+
+// Which kernel EnsembleEngine::step runs.
+// Scalar reproduces Engine::step bit-for-bit; the vector kernels use a polynomial
+// sin/cos (<= 2 ulp) and track Engine::step to ~1e-12 over short horizons.
+// Wasm128 is WebAssembly SIMD128 (Emscripten builds with DOUBLESWING_WEB_THREADS).
+enum class SimdBackend { Auto, Scalar, AVX2, AVX512, Wasm128 };
+
+const char* backend_name(SimdBackend b);
+
+// Many independent double pendulums stored structure-of-arrays, stepped together.
+// Members share `p` unless per-member params are set with set_member_params().
+class EnsembleEngine {
+public:
+    Params p;
+
+    // state, one entry per member (keep all four the same length; use resize())
+    std::vector<double> th1, w1;
+    std::vector<double> th2, w2;
+
+    explicit EnsembleEngine(const Params& p, std::size_t n = 0, const State& s0 = {});
+
+    [[nodiscard]] std::size_t size() const { return th1.size(); }
+
+    // new members start at s0 (and inherit `p` if per-member params are on)
+    void resize(std::size_t n, const State& s0 = {});
+
+    // moves the last member into slot i and shrinks by one (order is not kept)
+    void swap_remove(std::size_t i);
+
+    void set_state(std::size_t i, const State& s);
+    [[nodiscard]] State state(std::size_t i) const;
+
+    // Switches the ensemble to per-member params (others keep their current values).
+    void set_member_params(std::size_t i, const Params& mp);
+    [[nodiscard]] Params member_params(std::size_t i) const;
+    [[nodiscard]] bool has_member_params() const { return per_member; }
+    void clear_member_params();
+
+    // Same dt clamp as Engine::step. The range overload lets callers split work across threads.
+    void step(double dt);
+    void step(double dt, std::size_t begin, std::size_t end);
+
+    // Auto resolves to the widest kernel the CPU (and this build) supports.
+    void set_backend(SimdBackend b);
+    [[nodiscard]] SimdBackend backend() const { return active; }
+    [[nodiscard]] static bool backend_available(SimdBackend b);
+
+private:
+    // per-member params (empty when all members share `p`)
+    std::vector<double> l1, l2;
+    std::vector<double> m1, m2;
+    std::vector<double> g, damping;
+    bool per_member = false;
+
+    SimdBackend active = SimdBackend::Scalar;
+
+    void step_scalar(double dt, std::size_t begin, std::size_t end);
+};
+
+} // namespace ds
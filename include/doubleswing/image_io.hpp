@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ds {
+
+// Minimal dependency-free image writers for offline tools. Row-major, row 0 at the top.
+// All return false if the file could not be written.
+
+// Portable float map (single channel, little-endian float32).
+bool write_pfm(const std::string& path, std::size_t width, std::size_t height, const float* data);
+
+// Headerless little-endian float32.
+bool write_raw_f32(const std::string& path, std::size_t width, std::size_t height, const float* data);
+
+// 8-bit grayscale PNG (stored/uncompressed deflate).
+bool write_png_gray(const std::string& path, std::size_t width, std::size_t height, const std::uint8_t* data);
+
+} // namespace ds
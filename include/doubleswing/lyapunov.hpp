@@ -0,0 +1,53 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace ds {
+
+// Engine plus up to 4 tangent vectors integrated with the linearized (variational)
+// equations d(dx)/dt = J(x) dx. The state part is bit-for-bit Engine::step.
+class VariationalEngine {
+public:
+    Params p;
+    State  s;
+
+    // tangent vectors in (th1, w1, th2, w2) order; only the first `k` are integrated
+    std::array<State, 4> tangent{};
+    int k;
+
+    // tangents start as the first k unit vectors
+    VariationalEngine(const Params& p, const State& s0, int k = 1);
+
+    void step(double dt);
+
+    // Modified Gram-Schmidt on the tangents; norms[i] gets the length of tangent i
+    // (after projecting out tangents 0..i-1) before it is normalized.
+    void orthonormalize(double* norms);
+};
+
+struct LyapunovConfig {
+    double dt = 1.0 / 240.0;
+    double t_transient = 0.0;     // run this long before measuring (tangents still aligned)
+    double t_measure = 60.0;
+    std::size_t renorm_steps = 10; // Gram-Schmidt every N steps
+    bool full_spectrum = false;    // integrate 4 tangents instead of 1
+};
+
+struct LyapunovResult {
+    double lle = 0.0;                  // largest exponent, 1/s
+    std::array<double, 4> spectrum{};  // descending; only filled with full_spectrum
+};
+
+[[nodiscard]] LyapunovResult lyapunov(const Params& p, const State& s0, const LyapunovConfig& cfg = {});
+
+// One result per initial state, spread over a thread pool (threads == 0: all cores).
+// progress (optional) is called from worker threads, serialized.
+[[nodiscard]] std::vector<LyapunovResult> lyapunov_batch(
+        const Params& p, const std::vector<State>& s0, const LyapunovConfig& cfg = {},
+        unsigned threads = 0,
+        const std::function<void(std::size_t done, std::size_t total)>& progress = {});
+
+} // namespace ds
@@ -0,0 +1,239 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <doubleswing/engine_policy.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace ds {
+
+// NLinkEngine<DYNAMIC_LINKS> takes the link count at run time.
+inline constexpr std::size_t DYNAMIC_LINKS = 0;
+
+template <std::size_t N>
+using LinkArray = std::conditional_t<N == DYNAMIC_LINKS, std::vector<double>, std::array<double, N>>;
+
+// Link 0 hangs from the fixed pivot; bob i sits at the end of rod i.
+template <std::size_t N>
+struct ChainParams {
+    LinkArray<N> l{}, m{};
+    double g = 9.80665;
+    double damping = 0.0; // same viscous term as Params::damping, on every link
+};
+
+template <std::size_t N>
+struct ChainState {
+    LinkArray<N> th{}, w{}; // angles from vertical, angular velocities
+};
+
+// Chain of point masses on rigid massless rods (planar, pivot fixed, +y down).
+//
+// accel() is O(N): the rod tensions satisfy a tridiagonal system (from differentiating
+// each length constraint twice), solved with one Thomas sweep; the angular accelerations
+// then follow link by link. No mass matrix is formed. With N fixed every loop has a
+// constant trip count and the scratch arrays live in the object, so small chains unroll.
+//
+// N = 2 is the same system as Engine, and accel(), step() and energy_breakdown() run
+// Engine's own kernels (engine_policy.hpp, picked by trig and damping as Engine picks
+// them), so NLinkEngine<2> matches Engine's RK4 bit for bit (a DYNAMIC_LINKS chain of
+// two takes the general path). Other N: step() is RK4 with Engine's dt clamp and angle
+// wrapping. Short links are stiff: a chain released from horizontal whips its tip, and
+// dt has to shrink with the shortest link to stay stable.
+template <std::size_t N>
+class NLinkEngine {
+public:
+    using Array = LinkArray<N>;
+
+    ChainParams<N> p;
+    ChainState<N> s;
+
+    // Libm: std::sin/std::cos per link; Polynomial: sincos_poly. Identities behaves as
+    // Libm here (the differences already come from angle-sum identities), except for
+    // N = 2, where each tier is Engine's.
+    TrigMode trig = TrigMode::Libm;
+
+    // For DYNAMIC_LINKS the link count is p.l.size(); p.m and s0 must have the same length.
+    NLinkEngine(const ChainParams<N>& params, const ChainState<N>& s0) : p(params), s(s0) {
+        if constexpr (N == DYNAMIC_LINKS) {
+            const std::size_t n = p.l.size();
+            p.m.resize(n, 1.0);
+            s.th.resize(n, 0.0);
+            s.w.resize(n, 0.0);
+            for (Array* a : { &sn, &cs, &cd, &sd, &cp, &dp, &ten, &acc,
+                              &k1.th, &k1.w, &k2.th, &k2.w, &k3.th, &k3.w, &k4.th, &k4.w,
+                              &tmp.th, &tmp.w })
+                a->resize(n);
+        }
+    }
+
+    [[nodiscard]] std::size_t links() const { return s.th.size(); }
+
+    void step(double dt) {
+        dt = std::clamp(dt, 0.0, 1.0/15.0);
+        if constexpr (N == 2) {
+            State st = engine_state(s);
+            with_engine_policy([&](auto pol) { detail::step<decltype(pol)>(engine_params(), st, dt); });
+            s = chain_state_of(st);
+            return;
+        }
+        const std::size_t n = links();
+
+        deriv(s, k1);
+        for (std::size_t i = 0; i < n; ++i) {
+            tmp.th[i] = s.th[i] + 0.5 * dt * k1.th[i];
+            tmp.w[i]  = s.w[i]  + 0.5 * dt * k1.w[i];
+        }
+        deriv(tmp, k2);
+        for (std::size_t i = 0; i < n; ++i) {
+            tmp.th[i] = s.th[i] + 0.5 * dt * k2.th[i];
+            tmp.w[i]  = s.w[i]  + 0.5 * dt * k2.w[i];
+        }
+        deriv(tmp, k3);
+        for (std::size_t i = 0; i < n; ++i) {
+            tmp.th[i] = s.th[i] + dt * k3.th[i];
+            tmp.w[i]  = s.w[i]  + dt * k3.w[i];
+        }
+        deriv(tmp, k4);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            s.th[i] += (dt / 6.0) * (k1.th[i] + 2.0*k2.th[i] + 2.0*k3.th[i] + k4.th[i]);
+            s.w[i]  += (dt / 6.0) * (k1.w[i]  + 2.0*k2.w[i]  + 2.0*k3.w[i]  + k4.w[i]);
+            // remainder rather than normalize_angle: a long chain stepped too coarsely can
+            // whip its tip to inf, and the while loops would never return on that
+            s.th[i] = std::remainder(s.th[i], 2.0 * PI);
+        }
+    }
+
+    // angular accelerations for state st (a must hold links() entries)
+    void accel(const ChainState<N>& st, Array& a) const {
+        if constexpr (N == 2) {
+            const State es = engine_state(st);
+            with_engine_policy([&](auto pol) { detail::accel<decltype(pol)>(engine_params(), es, a[0], a[1]); });
+            return;
+        }
+        const std::size_t n = links();
+        if (n == 0) return;
+        const auto& l = p.l;
+        const auto& m = p.m;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (trig == TrigMode::Polynomial) sincos_poly(st.th[i], sn[i], cs[i]);
+            else { sn[i] = std::sin(st.th[i]); cs[i] = std::cos(st.th[i]); }
+        }
+        // between rod i and rod i+1: cd = cos(th_i - th_i+1), sd = sin(th_i+1 - th_i)
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            cd[i] = cs[i]*cs[i + 1] + sn[i]*sn[i + 1];
+            sd[i] = sn[i + 1]*cs[i] - cs[i + 1]*sn[i];
+        }
+
+        // Tensions: row i is e_i . (a_i - a_i-1) = -l_i w_i^2 with the bob accelerations
+        // written in terms of the tensions on either side. Thomas sweep, forward...
+        for (std::size_t i = 0; i < n; ++i) {
+            const double sub = i > 0 ? cd[i - 1] / m[i - 1] : 0.0;
+            const double sup = i + 1 < n ? cd[i] / m[i] : 0.0;
+            const double diag = -(1.0 / m[i] + (i > 0 ? 1.0 / m[i - 1] : 0.0));
+            const double rhs = -l[i]*st.w[i]*st.w[i] - (i == 0 ? p.g*cs[0] : 0.0);
+
+            const double den = i > 0 ? diag - sub*cp[i - 1] : diag;
+            cp[i] = sup / den;
+            dp[i] = (i > 0 ? rhs - sub*dp[i - 1] : rhs) / den;
+        }
+        // ...and back
+        ten[n - 1] = dp[n - 1];
+        for (std::size_t i = n - 1; i-- > 0;) ten[i] = dp[i] - cp[i]*ten[i + 1];
+
+        // l_i * th_i'' is the bob-relative acceleration normal to rod i
+        for (std::size_t i = 0; i < n; ++i) {
+            double f = i == 0 ? -p.g*sn[0] : -ten[i - 1]*sd[i - 1] / m[i - 1];
+            if (i + 1 < n) f += ten[i + 1]*sd[i] / m[i];
+            a[i] = f / l[i] - p.damping*st.w[i];
+        }
+    }
+
+    // bob i at (x[i], y[i]) in metres, pivot at the origin, +y down
+    void bob_positions(Array& x, Array& y) const {
+        if constexpr (N == DYNAMIC_LINKS) {
+            x.resize(links());
+            y.resize(links());
+        }
+        double px = 0.0, py = 0.0;
+        for (std::size_t i = 0; i < links(); ++i) {
+            px += p.l[i] * std::sin(s.th[i]);
+            py += p.l[i] * std::cos(s.th[i]);
+            x[i] = px;
+            y[i] = py;
+        }
+    }
+
+    // PE is zero with every link hanging straight down (as in Engine)
+    [[nodiscard]] EnergyBreakdown energy_breakdown() const {
+        if constexpr (N == 2) return detail::energy_breakdown(engine_params(), engine_state(s));
+        double vx = 0.0, vy = 0.0, drop = 0.0;
+        double ke = 0.0, pe = 0.0;
+        for (std::size_t i = 0; i < links(); ++i) {
+            const double c = std::cos(s.th[i]);
+            vx += p.l[i]*s.w[i]*c;
+            vy -= p.l[i]*s.w[i]*std::sin(s.th[i]);
+            drop += p.l[i]*(1.0 - c);
+            ke += 0.5*p.m[i]*(vx*vx + vy*vy);
+            pe += p.m[i]*p.g*drop;
+        }
+        return {ke, pe};
+    }
+
+private:
+    // scratch (sized once for DYNAMIC_LINKS); accel() and step() are not reentrant
+    mutable Array sn{}, cs{}, cd{}, sd{}, cp{}, dp{}, ten{}, acc{};
+    mutable ChainState<N> k1, k2, k3, k4, tmp;
+
+    // ---- N = 2 through Engine's kernels ----
+    [[nodiscard]] Params engine_params() const { return { p.l[0], p.l[1], p.m[0], p.m[1], p.g, p.damping }; }
+    static State engine_state(const ChainState<N>& c) { return { c.th[0], c.w[0], c.th[1], c.w[1] }; }
+    static ChainState<N> chain_state_of(const State& e) { return { {e.th1, e.th2}, {e.w1, e.w2} }; }
+
+    // calls f with the EnginePolicy Engine would pick for these settings
+    template <class F>
+    void with_engine_policy(F&& f) const {
+        const auto pick = [&](auto damped) {
+            constexpr bool D = decltype(damped)::value;
+            switch (trig) {
+                case TrigMode::Identities:
+                    f(EnginePolicy<double, D, TrigMode::Identities, Integrator::RK4, AngleWrap::Loop>{});
+                    return;
+                case TrigMode::Polynomial:
+                    f(EnginePolicy<double, D, TrigMode::Polynomial, Integrator::RK4, AngleWrap::Loop>{});
+                    return;
+                case TrigMode::Libm:
+                    break;
+            }
+            f(EnginePolicy<double, D, TrigMode::Libm, Integrator::RK4, AngleWrap::Loop>{});
+        };
+        if (p.damping != 0.0) pick(std::true_type{});
+        else pick(std::false_type{});
+    }
+
+    void deriv(const ChainState<N>& x, ChainState<N>& dx) const {
+        accel(x, acc);
+        for (std::size_t i = 0; i < links(); ++i) {
+            dx.th[i] = x.w[i];
+            dx.w[i] = acc[i];
+        }
+    }
+};
+
+using DynNLinkEngine = NLinkEngine<DYNAMIC_LINKS>;
+
+// Engine's two-link Params / State as a chain.
+inline ChainParams<2> chain_params(const Params& p) {
+    return { {p.l1, p.l2}, {p.m1, p.m2}, p.g, p.damping };
+}
+
+inline ChainState<2> chain_state(const State& s) {
+    return { {s.th1, s.th2}, {s.w1, s.w2} };
+}
+
+} // namespace ds
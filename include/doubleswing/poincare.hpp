@@ -0,0 +1,75 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace ds {
+
+// Poincare sections: runs that report only the states where the trajectory crosses a
+// surface g(state) = 0, instead of every step.
+//
+// g is evaluated on angles unwrapped across each step (continuous from the step's
+// start, which has angles in [-pi, pi]), so the +-pi wrap never looks like a crossing.
+// A g that is itself an angle, such as th1 - pi, should be periodic and set
+// Section::angle: its values are then unwrapped across the step too, so th1 = pi is
+// crossed from either side (th1_section / th2_section do this). A step that crosses
+// and comes back within itself is not seen; keep dt small compared to the time
+// between crossings.
+enum class CrossDir {
+    Rising,  // g goes from < 0 to >= 0
+    Falling, // g goes from > 0 to <= 0
+    Both,
+};
+
+struct Section {
+    std::function<double(const State&)> g;
+    CrossDir dir = CrossDir::Rising;
+    bool angle = false; // g is an angle (mod 2 pi), e.g. remainder(th1 - th, 2 pi)
+};
+
+// th1 = th with w1 > 0 (Rising) etc.; the usual sections for the double pendulum
+[[nodiscard]] Section th1_section(double th = 0.0, CrossDir dir = CrossDir::Rising);
+[[nodiscard]] Section th2_section(double th = 0.0, CrossDir dir = CrossDir::Rising);
+
+struct SectionHit {
+    double t;
+    State s; // angles in [-pi, pi]
+};
+
+struct PoincareConfig {
+    double dt = 1.0 / 240.0;
+    double t_max = 100.0;
+    std::size_t max_hits = 0;  // stop a run after this many crossings; 0 = no limit
+    double t_tol = 1e-12;      // crossing time tolerance, s
+    Integrator integrator = Integrator::RK4;
+    TrigMode trig = TrigMode::Libm;
+};
+
+// Steps Engine with cfg.dt (the step-by-step trajectory is exactly Engine's) and
+// refines each detected crossing: a cubic Hermite fit through the step's end points
+// and derivatives gives the first guess, then Illinois regula falsi on sub-steps of
+// the same integrator from the step's start pins the crossing to t_tol. Costs two
+// extra accel calls plus a few sub-steps per crossing, nothing per plain step.
+// hit returns false to stop early. Returns the number of crossings reported; a run
+// whose state goes non-finite ends there.
+std::size_t trace_section(const Params& p, const State& s0, const Section& sec, const PoincareConfig& cfg,
+                          const std::function<bool(const SectionHit&)>& hit);
+
+// One trajectory's crossings, in time order.
+struct PoincareRun {
+    std::size_t index = 0; // position in the initial-state list
+    std::vector<SectionHit> hits;
+};
+
+// Receives finished runs in index order, `chunk` runs at a time, on the calling thread.
+// Returning false stops the batch.
+using PoincareSink = std::function<bool(const PoincareRun* runs, std::size_t n)>;
+
+// trace_section for every initial state over a thread pool (threads == 0: all cores).
+// Memory is one chunk of runs. Returns the number of runs handed to the sink.
+std::size_t poincare_batch(const Params& p, const std::vector<State>& s0, const Section& sec,
+                           const PoincareConfig& cfg, const PoincareSink& sink,
+                           unsigned threads = 0, std::size_t chunk = 256);
+
+} // namespace ds
@@ -0,0 +1,38 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+
+namespace ds {
+
+// How long an EngineF (float) run tracks the Engine (double) reference from the same
+// start, so precision can be picked per use case: a drawn pendulum only needs to look
+// right, a chaos map needs every pixel's trajectory to be the double one.
+//
+// The pendulum is chaotic, so any perturbation eventually grows to O(1); what matters
+// is when. The same question asked of double at dt/2 gives the integrator's own
+// truncation-error horizon at this dt: if float diverges no sooner than that, float
+// rounding is not the accuracy limit and the float mode costs nothing that matters.
+struct DivergenceConfig {
+    double dt = 1.0 / 240.0;
+    double t_max = 60.0;
+    double tol = 1e-2;          // rad; max of the wrapped th1, th2 differences
+    Integrator integrator = Integrator::RK4;
+    TrigMode trig = TrigMode::Libm;
+};
+
+struct DivergenceReport {
+    double float_time = -1.0;      // first t the float run is past tol; -1 if within to t_max
+    double truncation_time = -1.0; // same for double at dt/2 against double at dt
+    double float_error_1s = 0.0;   // angle difference after 1 s (or t_max if shorter), float
+    double truncation_error_1s = 0.0;
+    // max |E - E0| / E0 over the run; both are bounded by the integrator when undamped,
+    // float adds its rounding on top (0 when E0 == 0 or damping != 0)
+    double energy_error_double = 0.0;
+    double energy_error_float = 0.0;
+};
+
+// Steps the three engines (double at dt, float at dt, double at dt/2) side by side
+// to cfg.t_max (energy errors are over the whole run, past divergence too); a run
+// whose state goes non-finite counts as diverged there.
+[[nodiscard]] DivergenceReport divergence_report(const Params& p, const State& s0, const DivergenceConfig& cfg);
+
+} // namespace ds
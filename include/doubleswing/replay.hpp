@@ -0,0 +1,143 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ds {
+
+// Deterministic session recordings: everything that changes an Engine other than its
+// own stepping, keyed by step index, plus periodic checkpoints of the full engine.
+//
+// Layout (little-endian):
+//   [0, 32)  header: "DSRPL001", u32 version (2), u32 reserved, u64 checkpoint_every, u64 reserved
+//   records  u32 kind, u32 field count n, u64 step, n x f64
+//
+// A checkpoint at step k holds the engine as it was before anything at step k was
+// applied (state, params, dt, integrator, trig, linear_tol, elapsed time); the first
+// record is always the checkpoint at step 0. Events at step k apply in file order, then
+// step k runs: as step_drag_p1 if a DragP1 event was among them, otherwise as step(dt).
+// The last record is End (total steps); a file cut short by a crash still loads up to its
+// last whole record, which is the point when chasing an explosion.
+//
+// Inputs are recorded as the values that reached the engine (after drag filtering),
+// so a recording replays the same way whatever the frontend's filter settings are.
+enum class ReplayRecord : std::uint32_t {
+    Checkpoint = 0, // th1, w1, th2, w2, l1, l2, m1, m2, g, damping, dt, integrator, trig, linear_tol, time
+    SetState = 1,   // th1, w1, th2, w2
+    SetParams = 2,  // l1, l2, m1, m2, g, damping
+    SetDt = 3,      // dt
+    SetConfig = 4,  // integrator, trig, linear_tol
+    DragP1 = 5,     // th1, w1, a1 for this step's step_drag_p1
+    End = 6,        // (no fields) step = total steps
+};
+
+// Drives an Engine and logs every operation on it. All changes to the engine while
+// recording must go through the recorder. Without open() it only forwards the calls,
+// so a frontend can drive through it unconditionally.
+class Recorder {
+public:
+    Recorder(Engine& e, double dt) : eng(e), step_dt(dt) {}
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // Starts a recording from the engine's current state. false if the file cannot be
+    // created. The file is flushed at each checkpoint, so a crash loses at most
+    // checkpoint_every steps.
+    bool open(const std::string& path, std::uint64_t checkpoint_every = 2400);
+
+    void set_state(const State& s);
+    void set_params(const Params& p);
+    void set_dt(double dt);
+    void set_config(Integrator integrator, TrigMode trig, double linear_tol);
+
+    void step();
+    void step_drag_p1(double th1, double w1, double a1);
+
+    // writes End; false if any write failed
+    bool close();
+
+    [[nodiscard]] bool is_open() const { return f != nullptr; }
+    [[nodiscard]] std::uint64_t steps() const { return count; }
+    [[nodiscard]] double dt() const { return step_dt; }
+    [[nodiscard]] Engine& engine() { return eng; }
+
+private:
+    Engine& eng;
+    std::FILE* f = nullptr;
+    bool ok = false;
+    double step_dt = 0.0;
+    std::uint64_t every = 0;
+    std::uint64_t count = 0;
+    double t = 0.0;
+    std::vector<std::uint8_t> buf; // pending records, written at checkpoints and close
+
+    void put(ReplayRecord kind, const double* v, std::uint32_t n);
+    void checkpoint();
+    void after_step();
+    bool flush();
+};
+
+// Loads a recording and plays it back bit for bit. seek() restores the nearest
+// checkpoint at or before the target and replays forward from there.
+class Replayer {
+public:
+    struct Event {
+        std::uint64_t step;
+        ReplayRecord kind;
+        double v[6];
+    };
+
+    struct Checkpoint {
+        std::uint64_t step;
+        State s;
+        Params p;
+        double dt;
+        Integrator integrator;
+        TrigMode trig;
+        double linear_tol;
+        double time;
+        std::size_t event; // first event at or after step
+    };
+
+    // false if the file is missing, not a recording, or has no initial checkpoint
+    bool open(const std::string& path);
+
+    [[nodiscard]] const Engine& engine() const { return eng; }
+    [[nodiscard]] std::uint64_t step_index() const { return cur; }
+    [[nodiscard]] std::uint64_t total_steps() const { return total; }
+    [[nodiscard]] double time() const { return t; }   // sum of the dts stepped so far
+    [[nodiscard]] double dt() const { return step_dt; }
+    [[nodiscard]] bool complete() const { return ended; } // End record present
+    [[nodiscard]] const std::vector<Event>& events() const { return ev; }
+    [[nodiscard]] const std::vector<Checkpoint>& checkpoints() const { return cps; }
+
+    // Runs up to n steps (stopping at total_steps()); returns the number run.
+    std::uint64_t advance(std::uint64_t n);
+
+    // Engine state before step k (k <= total_steps()).
+    void seek(std::uint64_t k);
+
+    // Replays from step 0 and compares the engine with every recorded checkpoint, bit
+    // for bit. On a mismatch returns false with the checkpoint's step in bad_step.
+    bool verify(std::uint64_t& bad_step);
+
+private:
+    Engine eng{ Params{1.0, 1.0, 1.0, 1.0}, State{} };
+    std::vector<Event> ev;
+    std::vector<Checkpoint> cps;
+    std::uint64_t total = 0;
+    bool ended = false;
+
+    std::uint64_t cur = 0;
+    std::size_t next = 0; // next event
+    double step_dt = 0.0;
+    double t = 0.0;
+
+    void restore(const Checkpoint& c);
+};
+
+} // namespace ds
@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace ds {
+
+// Instrumentation counters for the physics core. Built in with DS_STATS (CMake:
+// DOUBLESWING_STATS); otherwise the DS_STAT / DS_TRACE points below compile to nothing
+// and engine_stats() reports zeros.
+//
+// Each thread counts into its own block (plain single-writer stores, no shared cache
+// lines), so instrumented ensembles and sweeps do not contend. engine_stats() sums the
+// blocks of every thread, including threads that have since exited.
+#if defined(DS_STATS)
+inline constexpr bool stats_enabled = true;
+#else
+inline constexpr bool stats_enabled = false;
+#endif
+
+enum class Counter : int {
+    Steps,           // Engine::step calls
+    DragSteps,       // Engine::step_drag_p1 calls
+    DtClamps,        // step / step_drag_p1 capped dt at 1/15 s
+    AccelCalls,      // equations-of-motion evaluations (4 per RK4 step)
+    DenomClamps,     // accel denominator hit the 1e-12 guard
+    DragUpdates,     // DragFilter::update calls
+    DragSaturations, // raw drag omega clamped to omega_max
+    Count
+};
+
+struct EngineStats {
+    std::uint64_t steps = 0;
+    std::uint64_t drag_steps = 0;
+    std::uint64_t dt_clamps = 0;
+    std::uint64_t accel_calls = 0;
+    std::uint64_t denom_clamps = 0;
+    std::uint64_t drag_updates = 0;
+    std::uint64_t drag_saturations = 0;
+
+    // Energy change across undamped Engine::step calls and the simulated time they
+    // covered. An exact integrator keeps drift_energy at 0.
+    double drift_energy = 0.0;
+    double drift_time = 0.0;
+
+    // mean energy drift, J/s
+    [[nodiscard]] double drift_per_second() const {
+        return drift_time > 0.0 ? drift_energy / drift_time : 0.0;
+    }
+};
+
+// Totals since the last reset_engine_stats(), over all threads.
+[[nodiscard]] EngineStats engine_stats();
+void reset_engine_stats();
+
+// Rare events worth a log line. value: the requested dt, the unclamped denominator,
+// or the unclamped drag omega.
+enum class TracePoint : int { DtClamp, DenomClamp, DragSaturation };
+
+// Called on the thread that hit the trace point; keep it cheap. nullptr removes it.
+using TraceHook = void (*)(TracePoint point, double value, void* user);
+void set_trace_hook(TraceHook hook, void* user = nullptr);
+
+namespace detail {
+
+struct StatsBlock {
+    std::atomic<std::uint64_t> counts[int(Counter::Count)] = {};
+    std::atomic<double> drift_energy{0.0};
+    std::atomic<double> drift_time{0.0};
+};
+
+StatsBlock* register_stats_thread();
+void fire_trace(TracePoint point, double value);
+
+inline thread_local StatsBlock* tls_stats = nullptr;
+
+inline StatsBlock& local_stats() {
+    if (!tls_stats) tls_stats = register_stats_thread();
+    return *tls_stats;
+}
+
+// only the owning thread writes its block, so a relaxed load + store is enough
+inline void stat_add(std::atomic<std::uint64_t>& c, std::uint64_t n) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void stat_add(std::atomic<double>& c, double v) {
+    c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+inline void count(Counter c) { stat_add(local_stats().counts[int(c)], 1); }
+
+inline void add_drift(double energy, double time) {
+    StatsBlock& b = local_stats();
+    stat_add(b.drift_energy, energy);
+    stat_add(b.drift_time, time);
+}
+
+} // namespace detail
+
+} // namespace ds
+
+#if defined(DS_STATS)
+#define DS_STAT(counter) ::ds::detail::count(::ds::Counter::counter)
+#define DS_TRACE(point, value) ::ds::detail::fire_trace(::ds::TracePoint::point, double(value))
+#else
+#define DS_STAT(counter) ((void)0)
+#define DS_TRACE(point, value) ((void)0)
+#endif
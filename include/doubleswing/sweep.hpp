@@ -0,0 +1,72 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstddef>
+#include <functional>
+
+namespace ds {
+
+// Evenly spaced values min .. max (inclusive); n == 1 is just min.
+struct SweepAxis {
+    double min = 0.0, max = 0.0;
+    std::size_t n = 1;
+
+    SweepAxis(double v = 0.0) : min(v), max(v) {}
+    SweepAxis(double lo, double hi, std::size_t count) : min(lo), max(hi), n(count) {}
+
+    [[nodiscard]] double at(std::size_t i) const {
+        return n <= 1 ? min : min + (max - min) * double(i) / double(n - 1);
+    }
+};
+
+// Grid over Params, one Engine run per point from the same initial state. l1 varies
+// fastest, then l2, m1, m2, g, damping.
+struct SweepConfig {
+    SweepAxis l1{1.0}, l2{1.0};
+    SweepAxis m1{1.0}, m2{1.0};
+    SweepAxis g{9.80665};
+    SweepAxis damping{0.0};
+
+    State s0{1.0, 0.0, 1.0, 0.0};
+    double dt = 1.0 / 240.0;
+    double t_max = 10.0;
+    Integrator integrator = Integrator::RK4;
+    TrigMode trig = TrigMode::Libm;
+
+    // a run whose |w| passes this is stopped and reported as diverged
+    double w_limit = 1e4;
+
+    unsigned threads = 0;      // 0 = hardware_concurrency
+    std::size_t chunk = 4096;  // points in flight at once; bounds memory for any grid size
+};
+
+// Reductions of one run, accumulated while stepping (no trajectory is kept).
+struct SweepPoint {
+    std::size_t index = 0;      // position in the grid
+    Params p{};
+    double max_w = 0.0;         // max(|w1|, |w2|) over the run, rad/s
+    // Energy error relative to the starting energy: max |E - E0| / E0 when undamped;
+    // with damping > 0, the largest rise above the lowest energy so far (damping only
+    // removes energy, so any rise is integration error). Not an error measure for
+    // damping < 0, which pumps energy in.
+    double energy_drift = 0.0;
+    double flip_time = -1.0;    // first time either arm passes over the top; -1 if never
+    double energy_ratio = 1.0;  // E(end) / E0 (1 when E0 == 0)
+    bool diverged = false;      // non-finite state or |w| > w_limit; reductions up to there
+};
+
+[[nodiscard]] std::size_t sweep_size(const SweepConfig& cfg);
+[[nodiscard]] Params sweep_params(const SweepConfig& cfg, std::size_t index);
+
+// One run of the sweep (called by sweep() for each point; public for spot checks).
+[[nodiscard]] SweepPoint sweep_point(const SweepConfig& cfg, std::size_t index);
+
+// Receives finished points in grid order, cfg.chunk at a time, on the calling thread.
+// Returning false stops the sweep (e.g. on a write error).
+using SweepSink = std::function<bool(const SweepPoint* points, std::size_t n)>;
+using SweepProgress = std::function<void(std::size_t done, std::size_t total)>;
+
+// Runs the grid over a thread pool, one chunk at a time; returns the number of points
+// handed to the sink. progress (optional) is called after each chunk.
+std::size_t sweep(const SweepConfig& cfg, const SweepSink& sink, const SweepProgress& progress = {});
+
+} // namespace ds
@@ -0,0 +1,81 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstdint>
+
+namespace ds {
+
+inline constexpr int TAYLOR_MAX_ORDER = 30;
+
+struct TaylorConfig {
+    int order = 0;         // 10 .. TAYLOR_MAX_ORDER; 0 = picked from tol
+    double tol = 0.0;      // local error per step, relative to max(1, |state|); 0 = Real's epsilon
+    double h_max = 1.0;
+};
+
+// Adaptive Taylor-series integrator for reference trajectories, on the same equations
+// of motion as Engine (the identities form, whose denominator 2 m1 + 2 m2 sin^2 never
+// needs Engine's eps clamp for positive masses).
+//
+// Each step computes the Taylor coefficients of (th1, w1, th2, w2) to the configured
+// order by automatic differentiation: the recurrences for products, quotients and
+// sin/cos build every coefficient from the lower ones, O(order^2) work and a single
+// libm sin/cos pair per angle. The step size comes from how fast the last two
+// coefficients decay (Jorba & Zou), so it grows with the order: at order ~20 a step
+// is usually a large fraction of a second where RK4 needs ~1e-4 s for the same error.
+// The series itself is the dense output.
+//
+// TaylorL (long double; 80-bit on x86) gives ground truth for checking double runs.
+// Like DormandPrince it is meant for offline runs: no dt clamp, and the integrator
+// may step past a requested output time and evaluate back.
+template <class Real>
+class TaylorOf {
+public:
+    using real = Real;
+    using params_type = ParamsOf<Real>;
+    using state_type = StateOf<Real>;
+
+    params_type p;
+
+    TaylorOf(const Params& p, const State& s0, const TaylorConfig& cfg = {});
+
+    // state at the end of the last step (angles in [-pi, pi])
+    [[nodiscard]] state_type state() const;
+    [[nodiscard]] Real time() const { return t; }
+    [[nodiscard]] int order() const { return n; }
+
+    // one step; returns its size
+    Real step();
+
+    // state at t_out, stepping forward as needed; t_out must not be before the
+    // start of the last step
+    state_type advance_to(Real t_out);
+
+    // series evaluation inside the last step [time() - last_h, time()]
+    [[nodiscard]] state_type interpolate(Real t_out) const;
+
+    // restart from a new state (drops the last step)
+    void reset(const State& s, Real t0 = Real(0));
+
+    std::uint64_t steps = 0;
+
+private:
+    int n = 20;
+    Real tol = Real(0);
+    Real h_max = Real(1);
+
+    Real t = Real(0);
+    Real last_h = Real(0);
+    Real y[4] = {};                              // th1, w1, th2, w2 (angles wrapped after each step)
+    Real coef[4][TAYLOR_MAX_ORDER + 1] = {};     // series of the last step, about its start
+
+    void coefficients();
+};
+
+// defined in taylor.cpp for these two
+extern template class TaylorOf<double>;
+extern template class TaylorOf<long double>;
+
+using Taylor = TaylorOf<double>;
+using TaylorL = TaylorOf<long double>;
+
+} // namespace ds
@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ds {
+
+// Fixed set of worker threads running index-parallel jobs with work stealing.
+// Each worker starts on a contiguous slice of the index range (neighbouring tasks stay
+// on one core); a worker that runs dry steals the back half of another worker's slice.
+class ThreadPool {
+public:
+    // threads == 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Calls fn(task, worker) for every task in [0, count) and blocks until all are done.
+    // worker is in [0, size()), handy for per-thread scratch. Not reentrant.
+    void parallel_for(std::size_t count, const std::function<void(std::size_t, unsigned)>& fn);
+
+private:
+    struct alignas(64) Slice {
+        std::mutex m;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Slice[]> slices;
+
+    std::mutex run_m;   // one parallel_for at a time
+    std::mutex m;
+    std::condition_variable cv_start;
+    std::condition_variable cv_done;
+    std::uint64_t generation = 0;
+    unsigned running = 0;
+    bool stop = false;
+    const std::function<void(std::size_t, unsigned)>* job = nullptr;
+
+    void worker_loop(unsigned id);
+    bool next_task(unsigned id, std::size_t& task);
+};
+
+} // namespace ds
@@ -0,0 +1,141 @@
+#pragma once
+#include <doubleswing/engine.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ds {
+
+// Binary trajectory files: a fixed-rate series of States plus the Params that made them.
+//
+// Layout (little-endian):
+//   [0, 128)  header: "DSTRJ001", u32 encoding, u32 chunk_samples, Params (6 x f64),
+//             f64 t0, f64 dt, f64 angle_quantum, f64 rate_quantum,
+//             u64 samples, u64 chunks, u64 index_offset, u64 reserved
+//   chunks    chunk_samples States each (the last one may be short), 8-byte aligned
+//   index     chunks + 1 u64 file offsets; entry i is where chunk i starts, the last
+//             entry is where the index starts
+//
+// Sample i is at time t0 + i * dt, so seeking by time is one division plus one index
+// lookup. Raw chunks are the States as stored in memory and can be viewed in place.
+// Quantized chunks round each field to a multiple of its quantum (error <= quantum / 2)
+// and store the second differences of those integers as zigzag varints, after four
+// absolute i64 values for the first sample.
+enum class TrajEncoding : std::uint32_t {
+    Raw = 0,
+    Quantized = 1,
+};
+
+struct TrajectoryOptions {
+    TrajEncoding encoding = TrajEncoding::Raw;
+    std::uint32_t chunk_samples = 4096;
+    double angle_quantum = 1e-7; // rad, Quantized only
+    double rate_quantum = 1e-6;  // rad/s, Quantized only
+};
+
+struct StateSpan {
+    const State* data = nullptr;
+    std::size_t size = 0;
+
+    const State& operator[](std::size_t i) const { return data[i]; }
+    const State* begin() const { return data; }
+    const State* end() const { return data + size; }
+};
+
+// Streams States to disk one chunk at a time. Not copyable.
+class TrajectoryWriter {
+public:
+    TrajectoryWriter() = default;
+    ~TrajectoryWriter();
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    // false if the file cannot be created or the options are invalid
+    bool open(const std::string& path, const Params& p, double t0, double dt,
+              const TrajectoryOptions& opt = {});
+
+    // false once any write has failed
+    bool append(const State& s);
+
+    // flushes the last chunk, writes the index and finalizes the header
+    bool close();
+
+    [[nodiscard]] bool is_open() const { return f != nullptr; }
+    [[nodiscard]] std::uint64_t samples() const { return count; }
+
+private:
+    std::FILE* f = nullptr;
+    bool ok = false;
+    Params p{};
+    double t0 = 0.0, dt = 0.0;
+    TrajectoryOptions opt;
+    std::uint64_t count = 0;
+    std::uint64_t offset = 0;             // current end of file
+    std::vector<std::uint64_t> index;
+    std::vector<State> pending;           // current chunk
+    std::vector<std::uint8_t> buf;        // encoded chunk
+
+    bool flush_chunk();
+};
+
+// Memory-maps a trajectory file (reads it into memory where mmap is unavailable).
+// Raw files are viewed without copying; Quantized chunks are decoded on demand into
+// a one-chunk cache, so at() and chunk() on the same reader are not thread-safe.
+class TrajectoryReader {
+public:
+    TrajectoryReader() = default;
+    ~TrajectoryReader();
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    // false if the file is missing, truncated or not a trajectory file
+    bool open(const std::string& path);
+    void close();
+
+    [[nodiscard]] const Params& params() const { return p; }
+    [[nodiscard]] TrajEncoding encoding() const { return enc; }
+    [[nodiscard]] double t0() const { return start; }
+    [[nodiscard]] double dt() const { return step; }
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] std::size_t chunk_count() const { return chunks; }
+    [[nodiscard]] std::size_t chunk_samples() const { return per_chunk; }
+
+    // index of the last sample at or before t (clamped to the file)
+    [[nodiscard]] std::size_t index_at(double t) const;
+
+    // every sample in place (Raw only; empty span otherwise)
+    [[nodiscard]] StateSpan all() const;
+
+    // chunk c: in place for Raw, decoded into the cache for Quantized
+    StateSpan chunk(std::size_t c) const;
+
+    State at(std::size_t i) const;
+    State at_time(double t) const { return at(index_at(t)); }
+
+    // copies samples [first, first + n) to out; false if out of range
+    bool read(std::size_t first, std::size_t n, State* out) const;
+
+private:
+    const std::uint8_t* base = nullptr;
+    std::size_t bytes = 0;
+    bool mapped = false;
+    std::vector<std::uint8_t> owned; // fallback when the file is not mapped
+
+    Params p{};
+    TrajEncoding enc = TrajEncoding::Raw;
+    double start = 0.0, step = 0.0;
+    double qa = 0.0, qr = 0.0;
+    std::size_t count = 0, chunks = 0, per_chunk = 0;
+    const std::uint8_t* index = nullptr;
+
+    mutable std::vector<State> cache;
+    mutable std::size_t cached = SIZE_MAX;
+
+    [[nodiscard]] std::uint64_t chunk_offset(std::size_t c) const;
+    [[nodiscard]] std::size_t chunk_size(std::size_t c) const;
+    bool decode(std::size_t c) const;
+};
+
+} // namespace ds
@@ -0,0 +1,197 @@
+#include <doubleswing/doubleswing.h>
+#include <doubleswing/engine.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+struct dsn_engine {
+    ds::Engine eng;
+    double time = 0.0;
+    std::uint64_t steps = 0;
+    alignas(64) double out[DSN_OUT_LEN] = {};
+};
+
+struct dsn_pool {
+    ds::ThreadPool pool;
+    explicit dsn_pool(unsigned threads) : pool(threads) {}
+};
+
+namespace {
+
+bool valid_params(const double* p) {
+    for (int i = 0; i < DSN_PARAMS_LEN; ++i)
+        if (!std::isfinite(p[i])) return false;
+    return p[0] > 0.0 && p[1] > 0.0 && p[2] > 0.0 && p[3] > 0.0;
+}
+
+bool valid_dt(double dt) { return dt > 0.0 && dt <= DSN_MAX_DT; }
+
+ds::Params to_params(const double* p) { return { p[0], p[1], p[2], p[3], p[4], p[5] }; }
+ds::State to_state(const double* s) { return { s[0], s[1], s[2], s[3] }; }
+
+void write_state(const ds::State& s, double* out) {
+    out[0] = s.th1; out[1] = s.w1;
+    out[2] = s.th2; out[3] = s.w2;
+}
+
+void advance(dsn_engine* e, double dt, std::uint64_t n) {
+    for (std::uint64_t i = 0; i < n; ++i) e->eng.step(dt);
+    e->time += dt * double(n);
+    e->steps += n;
+}
+
+} // namespace
+
+extern "C" {
+
+int dsn_abi_version(void) { return DSN_ABI_VERSION; }
+
+// No exception may leave an extern "C" function: allocation and thread start-up
+// failures come back as NULL / 0 instead.
+
+dsn_engine* dsn_create(const double* params, const double* state) {
+    if (!params || !state || !valid_params(params)) return nullptr;
+    dsn_engine* e = new (std::nothrow) dsn_engine{ ds::Engine(to_params(params), to_state(state)) };
+    if (e) dsn_snapshot(e);
+    return e;
+}
+
+void dsn_destroy(dsn_engine* e) { delete e; }
+
+int dsn_set_params(dsn_engine* e, const double* params) {
+    if (!params || !valid_params(params)) return 0;
+    e->eng.p = to_params(params);
+    dsn_snapshot(e);
+    return 1;
+}
+
+void dsn_get_params(const dsn_engine* e, double* params) {
+    const ds::Params& p = e->eng.p;
+    params[0] = p.l1; params[1] = p.l2;
+    params[2] = p.m1; params[3] = p.m2;
+    params[4] = p.g;  params[5] = p.damping;
+}
+
+void dsn_set_state(dsn_engine* e, const double* state) {
+    e->eng.s = to_state(state);
+    dsn_snapshot(e);
+}
+
+void dsn_get_state(const dsn_engine* e, double* state) { write_state(e->eng.s, state); }
+
+void dsn_set_time(dsn_engine* e, double time) {
+    e->time = time;
+    e->out[DSN_OUT_TIME] = time;
+}
+
+int dsn_set_integrator(dsn_engine* e, int integrator) {
+    switch (integrator) {
+        case DSN_RK4:               e->eng.integrator = ds::Integrator::RK4; return 1;
+        case DSN_IMPLICIT_MIDPOINT: e->eng.integrator = ds::Integrator::ImplicitMidpoint; return 1;
+        case DSN_GAUSS_LEGENDRE4:   e->eng.integrator = ds::Integrator::GaussLegendre4; return 1;
+    }
+    return 0;
+}
+
+int dsn_set_trig(dsn_engine* e, int trig) {
+    switch (trig) {
+        case DSN_TRIG_LIBM:       e->eng.trig = ds::TrigMode::Libm; return 1;
+        case DSN_TRIG_IDENTITIES: e->eng.trig = ds::TrigMode::Identities; return 1;
+        case DSN_TRIG_POLYNOMIAL: e->eng.trig = ds::TrigMode::Polynomial; return 1;
+    }
+    return 0;
+}
+
+int dsn_set_linear_tol(dsn_engine* e, double tol) {
+    if (!(tol >= 0.0)) return 0;
+    e->eng.linear_tol = tol;
+    return 1;
+}
+
+const double* dsn_output(const dsn_engine* e) { return e->out; }
+
+void dsn_snapshot(dsn_engine* e) {
+    double* o = e->out;
+    e->eng.bob_positions(o[DSN_OUT_X1], o[DSN_OUT_Y1], o[DSN_OUT_X2], o[DSN_OUT_Y2]);
+    write_state(e->eng.s, o + DSN_OUT_TH1);
+    const ds::EnergyBreakdown en = e->eng.energy_breakdown();
+    o[DSN_OUT_KE] = en.ke;
+    o[DSN_OUT_PE] = en.pe;
+    o[DSN_OUT_E]  = en.total();
+    o[DSN_OUT_TIME]  = e->time;
+    o[DSN_OUT_STEPS] = double(e->steps);
+}
+
+int dsn_step_n(dsn_engine* e, double dt, uint64_t n) {
+    if (!valid_dt(dt)) return 0;
+    advance(e, dt, n);
+    dsn_snapshot(e);
+    return 1;
+}
+
+int dsn_step_drag_p1_n(dsn_engine* e, double dt, uint64_t n, double th1, double w1, double a1) {
+    if (!valid_dt(dt)) return 0;
+    for (uint64_t i = 0; i < n; ++i) e->eng.step_drag_p1(dt, th1, w1, a1);
+    e->time += dt * double(n);
+    e->steps += n;
+    dsn_snapshot(e);
+    return 1;
+}
+
+uint64_t dsn_run(dsn_engine* e, double dt, uint64_t n, uint64_t every, double* rows) {
+    if (!valid_dt(dt) || every == 0 || !rows) return 0;
+    uint64_t written = 0;
+    for (uint64_t done = 0; done + every <= n; done += every) {
+        advance(e, dt, every);
+        write_state(e->eng.s, rows + written * DSN_STATE_LEN);
+        ++written;
+    }
+    advance(e, dt, n % every);
+    dsn_snapshot(e);
+    return written;
+}
+
+dsn_pool* dsn_pool_create(unsigned threads) {
+    try {
+        return new dsn_pool(threads);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void dsn_pool_destroy(dsn_pool* pool) { delete pool; }
+
+void dsn_get_states(const dsn_engine* const* handles, size_t n, double* states) {
+    for (size_t i = 0; i < n; ++i) write_state(handles[i]->eng.s, states + i * DSN_STATE_LEN);
+}
+
+void dsn_set_states(dsn_engine* const* handles, size_t n, const double* states) {
+    for (size_t i = 0; i < n; ++i) dsn_set_state(handles[i], states + i * DSN_STATE_LEN);
+}
+
+void dsn_get_outputs(const dsn_engine* const* handles, size_t n, double* outputs) {
+    for (size_t i = 0; i < n; ++i)
+        std::memcpy(outputs + i * DSN_OUT_LEN, handles[i]->out, sizeof(double) * DSN_OUT_LEN);
+}
+
+int dsn_step_many(dsn_pool* pool, dsn_engine* const* handles, size_t n, double dt, uint64_t steps) {
+    if (!valid_dt(dt)) return 0;
+    const auto step_one = [&](std::size_t i, unsigned) {
+        advance(handles[i], dt, steps);
+        dsn_snapshot(handles[i]);
+    };
+    if (pool) {
+        try {
+            pool->pool.parallel_for(n, step_one);
+        } catch (...) {
+            return 0;
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) step_one(i, 0);
+    }
+    return 1;
+}
+
+} // extern "C"
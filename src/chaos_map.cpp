@@ -0,0 +1,128 @@
+#include <doubleswing/chaos_map.hpp>
+#include <doubleswing/image_io.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+namespace ds {
+
+bool cannot_flip(const Params& p, const State& s) {
+    if (p.damping < 0.0) return false;
+
+    const double e0 = Engine(p, s).energy_breakdown().total();
+
+    // cheapest way over the top for each arm (other arm hanging straight down)
+    const double pe_flip1 = 2.0 * (p.m1 + p.m2) * p.g * p.l1;
+    const double pe_flip2 = 2.0 * p.m2 * p.g * p.l2;
+    return e0 < std::min(pe_flip1, pe_flip2);
+}
+
+namespace {
+
+struct TileRect {
+    std::size_t x0, y0, x1, y1;
+};
+
+void run_tile(const ChaosMapConfig& cfg, const TileRect& r, float* out) {
+    const double dx = (cfg.th1_max - cfg.th1_min) / double(cfg.width);
+    const double dy = (cfg.th2_max - cfg.th2_min) / double(cfg.height);
+
+    EnsembleEngine ens(cfg.p);
+    ens.set_backend(cfg.backend);
+
+    // member j of the ensemble is pixel cell[j]
+    std::vector<std::size_t> cell;
+    cell.reserve((r.x1 - r.x0) * (r.y1 - r.y0));
+
+    for (std::size_t y = r.y0; y < r.y1; ++y) {
+        for (std::size_t x = r.x0; x < r.x1; ++x) {
+            const std::size_t idx = y * cfg.width + x;
+            // row 0 is th2_max
+            const State s{ cfg.th1_min + (double(x) + 0.5) * dx, 0.0,
+                           cfg.th2_max - (double(y) + 0.5) * dy, 0.0 };
+            out[idx] = -1.0f;
+            if (cannot_flip(cfg.p, s)) continue;
+
+            ens.resize(ens.size() + 1);
+            ens.set_state(ens.size() - 1, s);
+            cell.push_back(idx);
+        }
+    }
+
+    // the ensemble caps its steps like Engine::step; count time in the steps it takes
+    const double dt = std::min(cfg.dt, 1.0 / 15.0);
+    std::vector<double> prev1, prev2;
+    const auto steps = static_cast<std::uint64_t>(std::ceil(cfg.t_max / dt));
+
+    for (std::uint64_t k = 1; k <= steps && ens.size() > 0; ++k) {
+        prev1 = ens.th1;
+        prev2 = ens.th2;
+        ens.step(dt);
+
+        // angles are kept in [-pi, pi], so passing over the top shows up as a wrap
+        const float t = float(double(k) * dt);
+        for (std::size_t j = 0; j < ens.size();) {
+            const bool flipped = std::abs(ens.th1[j] - prev1[j]) > PI
+                              || std::abs(ens.th2[j] - prev2[j]) > PI;
+            if (!flipped) { ++j; continue; }
+
+            // early exit: retire the cell, keep the ensemble dense
+            out[cell[j]] = t;
+            ens.swap_remove(j);
+            cell[j] = cell.back();
+            cell.pop_back();
+            prev1[j] = prev1.back(); prev1.pop_back();
+            prev2[j] = prev2.back(); prev2.pop_back();
+        }
+    }
+}
+
+} // namespace
+
+ChaosMap chaos_map(const ChaosMapConfig& cfg, const ChaosMapProgress& progress) {
+    ChaosMap m;
+    m.width = cfg.width;
+    m.height = cfg.height;
+    m.t_max = cfg.t_max;
+    m.flip_time.assign(cfg.width * cfg.height, -1.0f);
+    if (cfg.width == 0 || cfg.height == 0 || !(cfg.dt > 0.0)) return m;
+
+    const std::size_t tile = std::max<std::size_t>(cfg.tile, 1);
+    const std::size_t tiles_x = (cfg.width + tile - 1) / tile;
+    const std::size_t tiles_y = (cfg.height + tile - 1) / tile;
+    const std::size_t total = tiles_x * tiles_y;
+
+    std::mutex progress_m;
+    std::size_t done = 0;
+
+    ThreadPool pool(cfg.threads);
+    pool.parallel_for(total, [&](std::size_t t, unsigned) {
+        const std::size_t tx = t % tiles_x, ty = t / tiles_x;
+        const TileRect r{ tx * tile, ty * tile,
+                          std::min(cfg.width, (tx + 1) * tile),
+                          std::min(cfg.height, (ty + 1) * tile) };
+        run_tile(cfg, r, m.flip_time.data());
+
+        std::lock_guard<std::mutex> lk(progress_m);
+        ++done;
+        if (progress) progress(done, total);
+    });
+
+    return m;
+}
+
+bool write_chaos_map_png(const std::string& path, const ChaosMap& m) {
+    std::vector<std::uint8_t> px(m.flip_time.size());
+    const double denom = std::log1p(std::max(m.t_max, 1e-9));
+    for (std::size_t i = 0; i < px.size(); ++i) {
+        const double t = m.flip_time[i];
+        if (t < 0.0) { px[i] = 0; continue; }
+        const double v = 1.0 - std::log1p(t) / denom;
+        px[i] = std::uint8_t(std::lround(32.0 + 223.0 * std::clamp(v, 0.0, 1.0)));
+    }
+    return write_png_gray(path, m.width, m.height, px.data());
+}
+
+} // namespace ds
@@ -0,0 +1,196 @@
+#include <doubleswing/dopri.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ds {
+
+namespace {
+
+// Dormand-Prince 5(4) tableau (Hairer, Norsett & Wanner, DOPRI5)
+constexpr double C2 = 1.0/5.0, C3 = 3.0/10.0, C4 = 4.0/5.0, C5 = 8.0/9.0;
+
+constexpr double A21 = 1.0/5.0;
+constexpr double A31 = 3.0/40.0, A32 = 9.0/40.0;
+constexpr double A41 = 44.0/45.0, A42 = -56.0/15.0, A43 = 32.0/9.0;
+constexpr double A51 = 19372.0/6561.0, A52 = -25360.0/2187.0, A53 = 64448.0/6561.0, A54 = -212.0/729.0;
+constexpr double A61 = 9017.0/3168.0, A62 = -355.0/33.0, A63 = 46732.0/5247.0, A64 = 49.0/176.0,
+                 A65 = -5103.0/18656.0;
+constexpr double A71 = 35.0/384.0, A73 = 500.0/1113.0, A74 = 125.0/192.0, A75 = -2187.0/6784.0,
+                 A76 = 11.0/84.0;
+
+// 5th minus embedded 4th order weights
+constexpr double E1 = 71.0/57600.0, E3 = -71.0/16695.0, E4 = 71.0/1920.0, E5 = -17253.0/339200.0,
+                 E6 = 22.0/525.0, E7 = -1.0/40.0;
+
+// dense output
+constexpr double D1 = -12715105075.0/11282082432.0, D3 = 87487479700.0/32700410799.0,
+                 D4 = -10690763975.0/1880347072.0, D5 = 701980252875.0/199316789632.0,
+                 D6 = -1453857185.0/822651844.0, D7 = 69997945.0/29380423.0;
+
+// step size controller (order 5 error estimate -> exponent 1/5)
+constexpr double SAFETY = 0.9;
+constexpr double FAC_MIN = 0.2;
+constexpr double FAC_MAX = 10.0;
+
+State to_state(const double* x) {
+    return State{ normalize_angle(x[0]), x[1], normalize_angle(x[2]), x[3] };
+}
+
+} // namespace
+
+DormandPrince::DormandPrince(const Params& params, const State& s0, const DopriConfig& config)
+    : p(params), cfg(config), eng(params, s0) {
+    reset(s0);
+}
+
+void DormandPrince::deriv(const double* x, double* dx) {
+    double a1, a2;
+    eng.accel(State{ x[0], x[1], x[2], x[3] }, a1, a2);
+    dx[0] = x[1];
+    dx[1] = a1;
+    dx[2] = x[3];
+    dx[3] = a2;
+    ++accel_evals;
+}
+
+void DormandPrince::reset(const State& s, double t0) {
+    eng.p = p;
+    t = t0;
+    last_h = 0.0;
+    y[0] = normalize_angle(s.th1); y[1] = s.w1;
+    y[2] = normalize_angle(s.th2); y[3] = s.w2;
+    deriv(y, k1);
+
+    // a zero-length "last step" so interpolate(time()) works right away
+    for (int i = 0; i < 4; ++i) {
+        rcont[0][i] = y[i];
+        for (int j = 1; j < 5; ++j) rcont[j][i] = 0.0;
+    }
+
+    if (h <= 0.0) h = cfg.h_init > 0.0 ? cfg.h_init : initial_step();
+}
+
+double DormandPrince::initial_step() {
+    // Hairer's starting step heuristic (one extra derivative evaluation)
+    double d0 = 0.0, d1 = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const double sk = cfg.atol + cfg.rtol * std::abs(y[i]);
+        d0 += (y[i] / sk) * (y[i] / sk);
+        d1 += (k1[i] / sk) * (k1[i] / sk);
+    }
+    d0 = std::sqrt(d0 / 4.0);
+    d1 = std::sqrt(d1 / 4.0);
+    double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+    h0 = std::min(h0, cfg.h_max);
+
+    double y1[4], f1[4];
+    for (int i = 0; i < 4; ++i) y1[i] = y[i] + h0 * k1[i];
+    deriv(y1, f1);
+
+    double d2 = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const double sk = cfg.atol + cfg.rtol * std::abs(y[i]);
+        d2 += ((f1[i] - k1[i]) / sk) * ((f1[i] - k1[i]) / sk);
+    }
+    d2 = std::sqrt(d2 / 4.0) / h0;
+
+    const double dm = std::max(d1, d2);
+    const double h1 = dm <= 1e-15 ? std::max(1e-6, h0 * 1e-3) : std::pow(0.01 / dm, 1.0 / 5.0);
+    return std::clamp(std::min(100.0 * h0, h1), cfg.h_min, cfg.h_max);
+}
+
+double DormandPrince::step() {
+    eng.p = p;
+
+    double k2[4], k3[4], k4[4], k5[4], k6[4], k7[4];
+    double tmp[4], y1[4];
+
+    for (;;) {
+        h = std::clamp(h, cfg.h_min, cfg.h_max);
+
+        for (int i = 0; i < 4; ++i) tmp[i] = y[i] + h*(A21*k1[i]);
+        deriv(tmp, k2);
+        for (int i = 0; i < 4; ++i) tmp[i] = y[i] + h*(A31*k1[i] + A32*k2[i]);
+        deriv(tmp, k3);
+        for (int i = 0; i < 4; ++i) tmp[i] = y[i] + h*(A41*k1[i] + A42*k2[i] + A43*k3[i]);
+        deriv(tmp, k4);
+        for (int i = 0; i < 4; ++i) tmp[i] = y[i] + h*(A51*k1[i] + A52*k2[i] + A53*k3[i] + A54*k4[i]);
+        deriv(tmp, k5);
+        for (int i = 0; i < 4; ++i)
+            tmp[i] = y[i] + h*(A61*k1[i] + A62*k2[i] + A63*k3[i] + A64*k4[i] + A65*k5[i]);
+        deriv(tmp, k6);
+        for (int i = 0; i < 4; ++i)
+            y1[i] = y[i] + h*(A71*k1[i] + A73*k3[i] + A74*k4[i] + A75*k5[i] + A76*k6[i]);
+        deriv(y1, k7);
+
+        // RMS error relative to the mixed tolerance
+        double err = 0.0;
+        for (int i = 0; i < 4; ++i) {
+            const double e = h*(E1*k1[i] + E3*k3[i] + E4*k4[i] + E5*k5[i] + E6*k6[i] + E7*k7[i]);
+            const double sk = cfg.atol + cfg.rtol * std::max(std::abs(y[i]), std::abs(y1[i]));
+            err += (e / sk) * (e / sk);
+        }
+        err = std::sqrt(err / 4.0);
+        // NaN from a trial step that overflowed: reject and shrink as hard as allowed
+        if (std::isnan(err)) err = HUGE_VAL;
+
+        const double fac = err > 0.0 ? SAFETY * std::pow(err, -1.0 / 5.0) : FAC_MAX;
+
+        if (err <= 1.0 || h <= cfg.h_min) {
+            // dense output coefficients, relative to the unwrapped end point
+            for (int i = 0; i < 4; ++i) {
+                const double ydiff = y1[i] - y[i];
+                const double bspl = h*k1[i] - ydiff;
+                rcont[0][i] = y[i];
+                rcont[1][i] = ydiff;
+                rcont[2][i] = bspl;
+                rcont[3][i] = ydiff - h*k7[i] - bspl;
+                rcont[4][i] = h*(D1*k1[i] + D3*k3[i] + D4*k4[i] + D5*k5[i] + D6*k6[i] + D7*k7[i]);
+            }
+
+            t += h;
+            last_h = h;
+            for (int i = 0; i < 4; ++i) { y[i] = y1[i]; k1[i] = k7[i]; }
+
+            // wrapping shifts by 2*pi, the derivatives (FSAL k1) are unchanged
+            y[0] = normalize_angle(y[0]);
+            y[2] = normalize_angle(y[2]);
+
+            ++accepted;
+            h *= std::clamp(fac, FAC_MIN, FAC_MAX);
+            return last_h;
+        }
+
+        ++rejected;
+        h *= std::clamp(fac, FAC_MIN, 1.0);
+    }
+}
+
+State DormandPrince::interpolate(double t_out) const {
+    if (last_h <= 0.0) return state();
+
+    const double s = (t_out - (t - last_h)) / last_h;
+    const double s1 = 1.0 - s;
+
+    double x[4];
+    for (int i = 0; i < 4; ++i)
+        x[i] = rcont[0][i] + s*(rcont[1][i] + s1*(rcont[2][i] + s*(rcont[3][i] + s1*rcont[4][i])));
+    return to_state(x);
+}
+
+State DormandPrince::advance_to(double t_out) {
+    // +inf would never be reached, and a blown-up state only crawls at h_min
+    if (!std::isfinite(t_out)) return state();
+    while (t < t_out) {
+        if (!std::isfinite(y[0] + y[1] + y[2] + y[3])) return state();
+        step();
+    }
+    return interpolate(t_out);
+}
+
+State DormandPrince::state() const {
+    return to_state(y);
+}
+
+} // namespace ds
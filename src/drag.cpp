@@ -1,41 +1,126 @@
 #include <doubleswing/drag.hpp>
+#include <doubleswing/stats.hpp>
 #include <doubleswing/util.hpp>
 #include <algorithm>
+#include <cmath>
 
 namespace ds {
 
-double unwrap_delta(double new_theta, double prev_theta) {
+template <class Real>
+Real unwrap_delta(Real new_theta, Real prev_theta) {
     // return delta in [-pi, pi]
-    double d = std::fmod(new_theta - prev_theta, 2.0 * PI);
-    if (d >  PI) d -= 2.0 * PI;
-    if (d < -PI) d += 2.0 * PI;
+    constexpr Real pi = Real(PI), two_pi = Real(2.0 * PI);
+    Real d = std::fmod(new_theta - prev_theta, two_pi);
+    if (d >  pi) d -= two_pi;
+    if (d < -pi) d += two_pi;
     return d;
 }
 
-double DragFilter::update(double theta, double dt, double alpha, double omega_max) {
-    if (dt <= 0.0) return omega;
+template <class Real>
+Real DragFilterOf<Real>::update(Real theta, Real dt, Real alpha, Real omega_max) {
+    if (dt <= Real(0)) return omega;
+    DS_STAT(DragUpdates);
 
     theta = normalize_angle(theta);
 
     if (!has_prev) {
         prev_theta = theta;
-        omega = 0.0;
+        omega = Real(0);
         has_prev = true;
         return omega;
     }
 
-    const double dtheta = unwrap_delta(theta, prev_theta);
-    double omega_raw = dtheta / dt;
+    const Real dtheta = unwrap_delta(theta, prev_theta);
+    Real omega_raw = dtheta / dt;
 
     // clamp raw omega (biggest anti-explosion control)
+    if constexpr (stats_enabled) {
+        if (std::abs(omega_raw) > omega_max) {
+            DS_STAT(DragSaturations);
+            DS_TRACE(DragSaturation, omega_raw);
+        }
+    }
     omega_raw = clamp_abs(omega_raw, omega_max);
 
     // low-pass filter
-    alpha = std::clamp(alpha, 0.0, 1.0);
-    omega = (1.0 - alpha) * omega + alpha * omega_raw;
+    alpha = std::clamp(alpha, Real(0), Real(1));
+    omega = (Real(1) - alpha) * omega + alpha * omega_raw;
 
     prev_theta = theta;
     return omega;
 }
 
+template <class Real>
+void DragEstimatorOf<Real>::reset(Real th, Real t) {
+    theta = normalize_angle(th);
+    omega = Real(0);
+    alpha = Real(0);
+    time = t;
+    has_prev = true;
+}
+
+template <class Real>
+void DragEstimatorOf<Real>::update(Real th, Real t) {
+    DS_STAT(DragUpdates);
+    if (!has_prev) {
+        reset(th, t);
+        return;
+    }
+
+    Real dt = t - time;
+    if (dt < Real(0)) dt = Real(0);
+
+    // predict to the sample with constant acceleration (theta continuous, not wrapped)
+    const Real th_p = theta + omega * dt + Real(0.5) * alpha * dt * dt;
+    const Real w_p = omega + alpha * dt;
+    const Real r = unwrap_delta(th, th_p);
+
+    if (dt <= Real(0)) {
+        // a coalesced duplicate: only the position moves
+        theta = th_p + r;
+        return;
+    }
+
+    // critically damped g-h-k gains for a memory of tau
+    const Real f = std::exp(-dt / tau);
+    const Real g = Real(1) - f * f * f;
+    const Real h = Real(1.5) * (Real(1) - f) * (Real(1) - f) * (Real(1) + f);
+    const Real k = Real(0.5) * (Real(1) - f) * (Real(1) - f) * (Real(1) - f);
+
+    theta = th_p + g * r;
+    omega = w_p + h * r / dt;
+    alpha = alpha + Real(2) * k * r / (dt * dt);
+    time = t;
+
+    if constexpr (stats_enabled) {
+        if (std::abs(omega) > omega_max || std::abs(alpha) > alpha_max) {
+            DS_STAT(DragSaturations);
+            DS_TRACE(DragSaturation, omega);
+        }
+    }
+    omega = clamp_abs(omega, omega_max);
+    alpha = clamp_abs(alpha, alpha_max);
+
+    // keep the unwrapped angle from growing without bound on a long spin
+    if (std::abs(theta) > Real(64.0L * PI_L)) theta = normalize_angle(theta);
+}
+
+template <class Real>
+DragEstimateOf<Real> DragEstimatorOf<Real>::at(Real t) const {
+    const Real dt = std::clamp(t + lead - time, -max_lead, max_lead);
+    if (t + lead - time > max_lead) {
+        // no samples for a while: the pointer is not moving
+        return { normalize_angle(theta + omega * dt + Real(0.5) * alpha * dt * dt), Real(0), Real(0) };
+    }
+    return { normalize_angle(theta + omega * dt + Real(0.5) * alpha * dt * dt),
+             clamp_abs(omega + alpha * dt, omega_max), alpha };
+}
+
+template double unwrap_delta<double>(double, double);
+template float unwrap_delta<float>(float, float);
+template struct DragFilterOf<double>;
+template struct DragFilterOf<float>;
+template struct DragEstimatorOf<double>;
+template struct DragEstimatorOf<float>;
+
 } // namespace ds
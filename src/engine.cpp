@@ -1,172 +1,135 @@
 #include <doubleswing/engine.hpp>
+#include <doubleswing/engine_policy.hpp>
+#include <doubleswing/stats.hpp>
 #include <doubleswing/util.hpp>
 #include <cmath>
 #include <algorithm>
 
 namespace ds {
 
-Engine::Engine(const Params& params, const State& s0) : p(params), s(s0) {
-    // keep angles sane at construction
-    s.th1 = normalize_angle(s.th1);
-    s.th2 = normalize_angle(s.th2);
-}
-
-void Engine::accel(const State& st, double& a1, double& a2) const {
-    // Angles measured from vertical
-    const double th1 = st.th1;
-    const double th2 = st.th2;
-    const double w1  = st.w1;
-    const double w2  = st.w2;
-
-    const double m1 = p.m1;
-    const double m2 = p.m2;
-    const double l1 = p.l1;
-    const double l2 = p.l2;
-    const double g  = p.g;
-
-    const double dth = th1 - th2;
-
-    const double denom = (2.0*m1 + m2 - m2*std::cos(2.0*dth));
-
-    // Protect against denom ~ 0 spikes
-    const double eps = 1e-12;
-    const double denom1 = std::max(std::abs(denom), eps) * (denom < 0 ? -1.0 : 1.0);
-
-    // th1''
-    a1 = (-g*(2.0*m1 + m2)*std::sin(th1)
-          - m2*g*std::sin(th1 - 2.0*th2)
-          - 2.0*std::sin(dth)*m2*(w2*w2*l2 + w1*w1*l1*std::cos(dth)))
-         / (l1 * denom1);
-
-    // th2''
-    a2 = ( 2.0*std::sin(dth) *
-          ( w1*w1*l1*(m1 + m2)
-            + g*(m1 + m2)*std::cos(th1)
-            + w2*w2*l2*m2*std::cos(dth) ) )
-         / (l2 * denom1);
-
-    // Simple viscous damping on angular velocities
-    if (p.damping != 0.0) {
-        a1 -= p.damping * w1;
-        a2 -= p.damping * w2;
-    }
-}
-
-void Engine::bob1_cart_accel(const ds::Params& p,
-                                    double th1, double w1, double a1,
-                                    double& xdd, double& ydd) {
-    // x = l1*sin(th1), y = l1*cos(th1)
-    // xdd = l1*(a1*cos(th1) - w1^2*sin(th1))
-    // ydd = l1*(-a1*sin(th1) - w1^2*cos(th1))
-    const double s = std::sin(th1);
-    const double c = std::cos(th1);
-    xdd = p.l1 * (a1 * c - (w1*w1) * s);
-    ydd = p.l1 * (-a1 * s - (w1*w1) * c);
-}
+namespace {
 
-double Engine::accel_theta2_moving_pivot(double th2, double w2, double xdd, double ydd) const {
-    // Equation for pendulum angle from vertical when pivot accelerates:
-    // th2'' = -(g/l2) * sin(th2) - (xdd*cos(th2) + ydd*sin(th2))/l2 - damping*w2
-    const double s2 = std::sin(th2);
-    const double c2 = std::cos(th2);
+// Engine's settings map onto one of 18 policy instantiations (damping on/off x trig
+// tier x integrator) per scalar type, always with the normalize_angle wrap.
+template <class Real, bool Damped, TrigMode Trig, Integrator Method = Integrator::RK4>
+using RuntimePolicy = EnginePolicy<Real, Damped, Trig, Method, AngleWrap::Loop>;
 
-    double a2 = -(p.g / p.l2) * s2
-                - (xdd * c2 + ydd * s2) / p.l2;
+template <class Real>
+using StepFn  = void (*)(const ParamsOf<Real>&, StateOf<Real>&, Real);
+template <class Real>
+using AccelFn = void (*)(const ParamsOf<Real>&, const StateOf<Real>&, Real&, Real&);
 
-    if (p.damping != 0.0) a2 -= p.damping * w2;
-    return a2;
+template <class Real, bool Damped, TrigMode Trig, Integrator Method>
+void step_kernel(const ParamsOf<Real>& p, StateOf<Real>& s, Real dt) {
+    detail::step<RuntimePolicy<Real, Damped, Trig, Method>>(p, s, dt);
 }
 
-void Engine::rk4_th2(double& th2, double& w2, double dt, double xdd, double ydd) const {
-    auto deriv = [&](double th, double w) {
-        // d/dt th = w, d/dt w = a(th,w)
-        const double a = accel_theta2_moving_pivot(th, w, xdd, ydd);
-        return std::pair<double,double>(w, a);
-    };
-
-    const auto [k1_th, k1_w] = deriv(th2, w2);
-
-    const auto [k2_th, k2_w] = deriv(th2 + 0.5*dt*k1_th, w2 + 0.5*dt*k1_w);
-
-    const auto [k3_th, k3_w] = deriv(th2 + 0.5*dt*k2_th, w2 + 0.5*dt*k2_w);
-
-    const auto [k4_th, k4_w] = deriv(th2 + dt*k3_th, w2 + dt*k3_w);
+template <class Real, bool Damped, TrigMode Trig>
+void accel_kernel(const ParamsOf<Real>& p, const StateOf<Real>& s, Real& a1, Real& a2) {
+    detail::accel<RuntimePolicy<Real, Damped, Trig>>(p, s, a1, a2);
+}
 
-    th2 += (dt/6.0) * (k1_th + 2*k2_th + 2*k3_th + k4_th);
-    w2  += (dt/6.0) * (k1_w  + 2*k2_w  + 2*k3_w  + k4_w);
+template <class Real, bool Damped, TrigMode Trig>
+StepFn<Real> pick_step(Integrator m) {
+    switch (m) {
+        case Integrator::ImplicitMidpoint: return &step_kernel<Real, Damped, Trig, Integrator::ImplicitMidpoint>;
+        case Integrator::GaussLegendre4:   return &step_kernel<Real, Damped, Trig, Integrator::GaussLegendre4>;
+        case Integrator::RK4:              break;
+    }
+    return &step_kernel<Real, Damped, Trig, Integrator::RK4>;
+}
 
-    th2 = normalize_angle(th2);
+template <class Real, bool Damped>
+StepFn<Real> pick_step(TrigMode t, Integrator m) {
+    switch (t) {
+        case TrigMode::Identities: return pick_step<Real, Damped, TrigMode::Identities>(m);
+        case TrigMode::Polynomial: return pick_step<Real, Damped, TrigMode::Polynomial>(m);
+        case TrigMode::Libm:       break;
+    }
+    return pick_step<Real, Damped, TrigMode::Libm>(m);
 }
 
-void Engine::step_drag_p1(double dt, double th1, double w1, double a1) {
-    dt = std::clamp(dt, 0.0, 1.0/15.0);
+template <class Real, bool Damped>
+AccelFn<Real> pick_accel(TrigMode t) {
+    switch (t) {
+        case TrigMode::Identities: return &accel_kernel<Real, Damped, TrigMode::Identities>;
+        case TrigMode::Polynomial: return &accel_kernel<Real, Damped, TrigMode::Polynomial>;
+        case TrigMode::Libm:       break;
+    }
+    return &accel_kernel<Real, Damped, TrigMode::Libm>;
+}
 
-    // impose th1 dynamics from mouse
-    s.th1 = normalize_angle(th1);
-    s.w1  = w1;
+// dt cap shared by step and step_drag_p1 (counted with DS_STATS)
+template <class Real>
+Real clamp_dt(Real dt) {
+    constexpr Real max_dt = Real(1.0/15.0);
+    if constexpr (stats_enabled) {
+        if (dt > max_dt) {
+            DS_STAT(DtClamps);
+            DS_TRACE(DtClamp, dt);
+        }
+    }
+    return std::clamp(dt, Real(0), max_dt);
+}
 
-    // compute bob1 cartesian acceleration due to imposed motion
-    double xdd, ydd;
-    bob1_cart_accel(p, s.th1, s.w1, a1, xdd, ydd);
+} // namespace
 
-    // integrate only th2,w2 under moving-pivot equation
-    double th2 = s.th2;
-    double w2  = s.w2;
-    rk4_th2(th2, w2, dt, xdd, ydd);
+template <class Real>
+EngineOf<Real>::EngineOf(const params_type& params, const state_type& s0) : p(params), s(s0) {
+    // keep angles sane at construction
+    s.th1 = normalize_angle(s.th1);
+    s.th2 = normalize_angle(s.th2);
+}
 
-    s.th2 = th2;
-    s.w2  = w2;
+template <class Real>
+void EngineOf<Real>::accel(const state_type& st, Real& a1, Real& a2) const {
+    const AccelFn<Real> f = p.damping != Real(0) ? pick_accel<Real, true>(trig) : pick_accel<Real, false>(trig);
+    f(p, st, a1, a2);
 }
 
-void Engine::rk4(State& st, double dt) const {
-    // State vector: [th1, w1, th2, w2]
-    auto deriv = [&](const State& x) -> State {
-        double a1, a2;
-        accel(x, a1, a2);
-        return State{ x.w1, a1, x.w2, a2 };
-    };
-
-    const State k1 = deriv(st);
-
-    State tmp = st;
-    tmp.th1 += 0.5 * dt * k1.th1;
-    tmp.w1  += 0.5 * dt * k1.w1;
-    tmp.th2 += 0.5 * dt * k1.th2;
-    tmp.w2  += 0.5 * dt * k1.w2;
-    const State k2 = deriv(tmp);
-
-    tmp = st;
-    tmp.th1 += 0.5 * dt * k2.th1;
-    tmp.w1  += 0.5 * dt * k2.w1;
-    tmp.th2 += 0.5 * dt * k2.th2;
-    tmp.w2  += 0.5 * dt * k2.w2;
-    const State k3 = deriv(tmp);
-
-    tmp = st;
-    tmp.th1 += dt * k3.th1;
-    tmp.w1  += dt * k3.w1;
-    tmp.th2 += dt * k3.th2;
-    tmp.w2  += dt * k3.w2;
-    const State k4 = deriv(tmp);
-
-    st.th1 += (dt / 6.0) * (k1.th1 + 2.0*k2.th1 + 2.0*k3.th1 + k4.th1);
-    st.w1  += (dt / 6.0) * (k1.w1  + 2.0*k2.w1  + 2.0*k3.w1  + k4.w1);
-    st.th2 += (dt / 6.0) * (k1.th2 + 2.0*k2.th2 + 2.0*k3.th2 + k4.th2);
-    st.w2  += (dt / 6.0) * (k1.w2  + 2.0*k2.w2  + 2.0*k3.w2  + k4.w2);
-
-    // Bound angles to avoid precision blowups over long runs
-    st.th1 = normalize_angle(st.th1);
-    st.th2 = normalize_angle(st.th2);
+template <class Real>
+void EngineOf<Real>::step_drag_p1(Real dt, Real th1, Real w1, Real a1) {
+    DS_STAT(DragSteps);
+    dt = clamp_dt(dt);
+
+    // impose th1 dynamics from mouse, integrate only th2,w2 under the moving-pivot equation
+    if (p.damping != Real(0))
+        detail::step_drag_p1<RuntimePolicy<Real, true, TrigMode::Libm>>(p, s, dt, th1, w1, a1);
+    else
+        detail::step_drag_p1<RuntimePolicy<Real, false, TrigMode::Libm>>(p, s, dt, th1, w1, a1);
 }
 
-void Engine::step(double dt) {
+template <class Real>
+void EngineOf<Real>::step(Real dt) {
     // cap dt so tab-outs don't explode
-    dt = std::clamp(dt, 0.0, 1.0/15.0);
+    DS_STAT(Steps);
+    dt = clamp_dt(dt);
+    if (linear_tol > Real(0) && step_linear(dt)) return;
+
+    const StepFn<Real> f = p.damping != Real(0) ? pick_step<Real, true>(trig, integrator)
+                                                : pick_step<Real, false>(trig, integrator);
+    if constexpr (stats_enabled) {
+        // undamped runs should conserve energy; whatever changes is integration error
+        if (p.damping == Real(0)) {
+            const double e0 = energy_breakdown().total();
+            f(p, s, dt);
+            detail::add_drift(energy_breakdown().total() - e0, double(dt));
+            return;
+        }
+    }
+    f(p, s, dt);
+}
 
-    rk4(s, dt);
+template <class Real>
+bool EngineOf<Real>::step_linear(Real dt) {
+    if (!modes.built_for(p) && !modes.build(p)) return false;
+    if (!(modes.linear_error(s) <= linear_tol)) return false;
+    modes.advance(s, std::max(dt, Real(0)));
+    return true;
 }
 
-void Engine::bob_positions(double& x1, double& y1, double& x2, double& y2) const {
+template <class Real>
+void EngineOf<Real>::bob_positions(Real& x1, Real& y1, Real& x2, Real& y2) const {
     // coords in meters, pivot at (0,0), +y downward for convenience in screen space
     // Note: for +y up, flip signs in the renderer
     x1 =  p.l1 * std::sin(s.th1);
@@ -176,22 +139,12 @@ void Engine::bob_positions(double& x1, double& y1, double& x2, double& y2) const
     y2 = y1 + p.l2 * std::cos(s.th2);
 }
 
-ds::EnergyBreakdown Engine::energy_breakdown() const {
-    const double th1 = s.th1, th2 = s.th2;
-    const double w1 = s.w1, w2 = s.w2;
-
-    const double m1 = p.m1, m2 = p.m2;
-    const double l1 = p.l1, l2 = p.l2;
-    const double g  = p.g;
-
-    const double v1_sq = (l1*w1)*(l1*w1);
-    const double v2_sq = v1_sq + (l2*w2)*(l2*w2) + 2.0*l1*l2*w1*w2*std::cos(th1 - th2);
-
-    const double ke = 0.5*m1*v1_sq + 0.5*m2*v2_sq;
-
-    const double pe = (m1 + m2)*g*l1*(1 - cos(th1)) + m2*g*l2*(1 - cos(th2));
-
-    return {ke, pe};
+template <class Real>
+ds::EnergyBreakdown EngineOf<Real>::energy_breakdown() const {
+    return detail::energy_breakdown(p, s);
 }
 
+template class EngineOf<double>;
+template class EngineOf<float>;
+
 } // namespace ds
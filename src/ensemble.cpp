@@ -0,0 +1,194 @@
+#include <doubleswing/ensemble.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+
+#include "ensemble_kernels.hpp"
+
+namespace ds {
+
+const char* backend_name(SimdBackend b) {
+    switch (b) {
+        case SimdBackend::Auto:    return "auto";
+        case SimdBackend::Scalar:  return "scalar";
+        case SimdBackend::AVX2:    return "avx2";
+        case SimdBackend::AVX512:  return "avx512";
+        case SimdBackend::Wasm128: return "wasm128";
+    }
+    return "?";
+}
+
+bool EnsembleEngine::backend_available(SimdBackend b) {
+    switch (b) {
+        case SimdBackend::Auto:
+        case SimdBackend::Scalar:
+            return true;
+        case SimdBackend::AVX2:
+#if defined(DS_ENSEMBLE_AVX2)
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+            return false;
+#endif
+        case SimdBackend::AVX512:
+#if defined(DS_ENSEMBLE_AVX512)
+            return __builtin_cpu_supports("avx512f");
+#else
+            return false;
+#endif
+        case SimdBackend::Wasm128:
+#if defined(DS_ENSEMBLE_WASM_SIMD)
+            return true; // a module built with -msimd128 only loads where SIMD is supported
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+EnsembleEngine::EnsembleEngine(const Params& params, std::size_t n, const State& s0) : p(params) {
+    set_backend(SimdBackend::Auto);
+    resize(n, s0);
+}
+
+void EnsembleEngine::resize(std::size_t n, const State& s0) {
+    // same angle normalization as the Engine constructor
+    th1.resize(n, normalize_angle(s0.th1));
+    w1.resize(n, s0.w1);
+    th2.resize(n, normalize_angle(s0.th2));
+    w2.resize(n, s0.w2);
+
+    if (has_member_params()) {
+        l1.resize(n, p.l1);
+        l2.resize(n, p.l2);
+        m1.resize(n, p.m1);
+        m2.resize(n, p.m2);
+        g.resize(n, p.g);
+        damping.resize(n, p.damping);
+    }
+}
+
+void EnsembleEngine::swap_remove(std::size_t i) {
+    auto take_last = [i](std::vector<double>& v) {
+        v[i] = v.back();
+        v.pop_back();
+    };
+    take_last(th1); take_last(w1);
+    take_last(th2); take_last(w2);
+
+    if (has_member_params()) {
+        take_last(l1); take_last(l2);
+        take_last(m1); take_last(m2);
+        take_last(g);
+        take_last(damping);
+    }
+}
+
+void EnsembleEngine::set_state(std::size_t i, const State& s) {
+    th1[i] = normalize_angle(s.th1);
+    w1[i]  = s.w1;
+    th2[i] = normalize_angle(s.th2);
+    w2[i]  = s.w2;
+}
+
+State EnsembleEngine::state(std::size_t i) const {
+    return State{ th1[i], w1[i], th2[i], w2[i] };
+}
+
+void EnsembleEngine::set_member_params(std::size_t i, const Params& mp) {
+    if (!has_member_params()) {
+        const std::size_t n = size();
+        l1.assign(n, p.l1);
+        l2.assign(n, p.l2);
+        m1.assign(n, p.m1);
+        m2.assign(n, p.m2);
+        g.assign(n, p.g);
+        damping.assign(n, p.damping);
+        per_member = true;
+    }
+    l1[i] = mp.l1; l2[i] = mp.l2;
+    m1[i] = mp.m1; m2[i] = mp.m2;
+    g[i] = mp.g;
+    damping[i] = mp.damping;
+}
+
+Params EnsembleEngine::member_params(std::size_t i) const {
+    if (!has_member_params()) return p;
+    return Params{ l1[i], l2[i], m1[i], m2[i], g[i], damping[i] };
+}
+
+void EnsembleEngine::clear_member_params() {
+    l1.clear(); l2.clear();
+    m1.clear(); m2.clear();
+    g.clear();
+    damping.clear();
+    per_member = false;
+}
+
+void EnsembleEngine::set_backend(SimdBackend b) {
+    if (b == SimdBackend::Auto) {
+        if (backend_available(SimdBackend::AVX512))       b = SimdBackend::AVX512;
+        else if (backend_available(SimdBackend::AVX2))    b = SimdBackend::AVX2;
+        else if (backend_available(SimdBackend::Wasm128)) b = SimdBackend::Wasm128;
+        else                                              b = SimdBackend::Scalar;
+    }
+    // fall back rather than fault on a CPU that lacks the ISA
+    active = backend_available(b) ? b : SimdBackend::Scalar;
+}
+
+void EnsembleEngine::step(double dt) {
+    step(dt, 0, size());
+}
+
+void EnsembleEngine::step_scalar(double dt, std::size_t begin, std::size_t end) {
+    // Run the real Engine per member: bit-for-bit the same as Engine::step.
+    for (std::size_t i = begin; i < end; ++i) {
+        Engine e(member_params(i), state(i));
+        e.step(dt);
+        th1[i] = e.s.th1; w1[i] = e.s.w1;
+        th2[i] = e.s.th2; w2[i] = e.s.w2;
+    }
+}
+
+void EnsembleEngine::step(double dt, std::size_t begin, std::size_t end) {
+    end = std::min(end, size());
+    if (begin >= end) return;
+
+    if (active == SimdBackend::Scalar) {
+        step_scalar(dt, begin, end);
+        return;
+    }
+
+    // cap dt so tab-outs don't explode (matches Engine::step)
+    dt = std::clamp(dt, 0.0, 1.0/15.0);
+
+    const bool pm = has_member_params();
+    detail::EnsembleKernelArgs a{};
+    a.th1 = th1.data() + begin; a.w1 = w1.data() + begin;
+    a.th2 = th2.data() + begin; a.w2 = w2.data() + begin;
+    if (pm) {
+        a.l1 = l1.data() + begin; a.l2 = l2.data() + begin;
+        a.m1 = m1.data() + begin; a.m2 = m2.data() + begin;
+        a.g  = g.data() + begin;
+        a.damping = damping.data() + begin;
+    }
+    a.sl1 = p.l1; a.sl2 = p.l2;
+    a.sm1 = p.m1; a.sm2 = p.m2;
+    a.sg = p.g;
+    a.sdamping = p.damping;
+    a.n = end - begin;
+    a.dt = dt;
+
+    switch (active) {
+#if defined(DS_ENSEMBLE_AVX512)
+        case SimdBackend::AVX512:  detail::ensemble_rk4_avx512(a); return;
+#endif
+#if defined(DS_ENSEMBLE_AVX2)
+        case SimdBackend::AVX2:    detail::ensemble_rk4_avx2(a); return;
+#endif
+#if defined(DS_ENSEMBLE_WASM_SIMD)
+        case SimdBackend::Wasm128: detail::ensemble_rk4_wasm128(a); return;
+#endif
+        default: step_scalar(dt, begin, end); return;
+    }
+}
+
+} // namespace ds
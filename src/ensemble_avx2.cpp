@@ -0,0 +1,51 @@
+// Built with -mavx2 -mfma; only called after a runtime CPU check.
+#include <immintrin.h>
+#include <cstdint>
+
+#include "ensemble_simd.hpp"
+
+namespace ds::detail {
+namespace {
+
+struct Avx2 {
+    using T = __m256d;
+    using M = __m256d;
+    static constexpr std::size_t W = 4;
+
+    static T load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, T v) { _mm256_storeu_pd(p, v); }
+    static T set1(double v) { return _mm256_set1_pd(v); }
+
+    static T add(T a, T b) { return _mm256_add_pd(a, b); }
+    static T sub(T a, T b) { return _mm256_sub_pd(a, b); }
+    static T mul(T a, T b) { return _mm256_mul_pd(a, b); }
+    static T div(T a, T b) { return _mm256_div_pd(a, b); }
+    static T fma(T a, T b, T c) { return _mm256_fmadd_pd(a, b, c); }
+    static T fnma(T a, T b, T c) { return _mm256_fnmadd_pd(a, b, c); }
+
+    static T round(T a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static T abs(T a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static T max(T a, T b) { return _mm256_max_pd(a, b); }
+    static T copysign(T mag, T sgn) {
+        const T sign = _mm256_set1_pd(-0.0);
+        return _mm256_or_pd(_mm256_andnot_pd(sign, mag), _mm256_and_pd(sign, sgn));
+    }
+
+    // k + 1.5*2^52 puts the integer value of k in the low mantissa bits
+    static M bit(T k, int b) {
+        const __m256i ki = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(6755399441055744.0)));
+        const __m256i m = _mm256_set1_epi64x(std::int64_t(1) << b);
+        return _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(ki, m), m));
+    }
+    static T select(M m, T a, T b) { return _mm256_blendv_pd(b, a, m); }
+    static T neg_if(M m, T a) { return _mm256_xor_pd(a, _mm256_and_pd(m, _mm256_set1_pd(-0.0))); }
+    static M mxor(M a, M b) { return _mm256_xor_pd(a, b); }
+};
+
+} // namespace
+
+void ensemble_rk4_avx2(const EnsembleKernelArgs& a) {
+    rk4_dispatch<Avx2>(a);
+}
+
+} // namespace ds::detail
@@ -0,0 +1,59 @@
+// Built with -mavx512f; only called after a runtime CPU check.
+#include <immintrin.h>
+#include <cstdint>
+
+#include "ensemble_simd.hpp"
+
+namespace ds::detail {
+namespace {
+
+struct Avx512 {
+    using T = __m512d;
+    using M = __mmask8;
+    static constexpr std::size_t W = 8;
+
+    static T load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, T v) { _mm512_storeu_pd(p, v); }
+    static T set1(double v) { return _mm512_set1_pd(v); }
+
+    static T add(T a, T b) { return _mm512_add_pd(a, b); }
+    static T sub(T a, T b) { return _mm512_sub_pd(a, b); }
+    static T mul(T a, T b) { return _mm512_mul_pd(a, b); }
+    static T div(T a, T b) { return _mm512_div_pd(a, b); }
+    static T fma(T a, T b, T c) { return _mm512_fmadd_pd(a, b, c); }
+    static T fnma(T a, T b, T c) { return _mm512_fnmadd_pd(a, b, c); }
+
+    static T round(T a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static T abs(T a) { return _mm512_abs_pd(a); }
+    static T max(T a, T b) { return _mm512_max_pd(a, b); }
+
+    // integer ops only (AVX512F has no _pd logic ops without DQ)
+    static __m512i bits(T a) { return _mm512_castpd_si512(a); }
+    static T from_bits(__m512i a) { return _mm512_castsi512_pd(a); }
+
+    static T copysign(T mag, T sgn) {
+        const __m512i sign = _mm512_set1_epi64(std::int64_t(1) << 63);
+        return from_bits(_mm512_or_si512(_mm512_andnot_si512(sign, bits(mag)),
+                                         _mm512_and_si512(sign, bits(sgn))));
+    }
+
+    // k + 1.5*2^52 puts the integer value of k in the low mantissa bits
+    static M bit(T k, int b) {
+        const __m512i ki = bits(_mm512_add_pd(k, _mm512_set1_pd(6755399441055744.0)));
+        return _mm512_test_epi64_mask(ki, _mm512_set1_epi64(std::int64_t(1) << b));
+    }
+    static T select(M m, T a, T b) { return _mm512_mask_blend_pd(m, b, a); }
+    static T neg_if(M m, T a) {
+        const __m512i sign = _mm512_set1_epi64(std::int64_t(1) << 63);
+        return from_bits(_mm512_mask_xor_epi64(bits(a), m, bits(a), sign));
+    }
+    static M mxor(M a, M b) { return static_cast<M>(a ^ b); }
+};
+
+} // namespace
+
+void ensemble_rk4_avx512(const EnsembleKernelArgs& a) {
+    rk4_dispatch<Avx512>(a);
+}
+
+} // namespace ds::detail
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+
+// Private interface between EnsembleEngine and the per-ISA kernels.
+// The ISA translation units are built with -mavx2/-mavx512f/-msimd128, so everything they see
+// from here must be plain data: no inline functions or templates that the linker could
+// fold with a copy compiled for a different target.
+
+namespace ds::detail {
+
+struct EnsembleKernelArgs {
+    double* th1;
+    double* w1;
+    double* th2;
+    double* w2;
+
+    // per-member params, all null when the ensemble shares one Params
+    const double* l1;
+    const double* l2;
+    const double* m1;
+    const double* m2;
+    const double* g;
+    const double* damping;
+
+    // shared params (used when the pointers above are null)
+    double sl1, sl2, sm1, sm2, sg, sdamping;
+
+    std::size_t n;
+    double dt;
+};
+
+#if defined(DS_ENSEMBLE_AVX2)
+void ensemble_rk4_avx2(const EnsembleKernelArgs& a);
+#endif
+
+#if defined(DS_ENSEMBLE_AVX512)
+void ensemble_rk4_avx512(const EnsembleKernelArgs& a);
+#endif
+
+#if defined(DS_ENSEMBLE_WASM_SIMD)
+void ensemble_rk4_wasm128(const EnsembleKernelArgs& a);
+#endif
+
+} // namespace ds::detail
@@ -0,0 +1,242 @@
+#pragma once
+#include "ensemble_kernels.hpp"
+
+// Width-generic RK4 for EnsembleEngine. Included by each ISA translation unit after it
+// defines its vector ops struct `V`:
+//   T, M, W                          vector type, lane mask type, lane count
+//   load, store, set1                unaligned memory ops
+//   add, sub, mul, div, fma, fnma    fma(a,b,c) = a*b+c, fnma(a,b,c) = c-a*b
+//   round, abs, max, copysign        round is to nearest integer
+//   bit(k, b), select, neg_if, mxor  k holds integer-valued lanes; select(m,a,b) = m ? a : b
+// Everything lives in an anonymous namespace so each ISA gets its own private copy.
+
+namespace ds::detail {
+namespace {
+
+constexpr double K_PI        = 3.14159265358979323846;
+constexpr double K_TWO_PI    = 2.0 * K_PI;
+constexpr double K_INV_TWO_PI = 1.0 / K_TWO_PI;
+constexpr double K_TWO_OVER_PI = 0.63661977236758134308;
+
+// pi/2 split into three parts (Cody-Waite); the first two have trailing zero bits
+// so k*PIO2_1 and k*PIO2_2 are exact for the angles the engine produces.
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_2 = 6.07710050630396597660e-11;
+constexpr double PIO2_3 = 2.02226624871116645580e-21;
+
+// fdlibm __kernel_sin / __kernel_cos minimax coefficients on [-pi/4, pi/4]
+constexpr double S1 = -1.66666666666666324348e-01;
+constexpr double S2 =  8.33333333332248946124e-03;
+constexpr double S3 = -1.98412698298579493134e-04;
+constexpr double S4 =  2.75573137070700676789e-06;
+constexpr double S5 = -2.50507602534068634195e-08;
+constexpr double S6 =  1.58969099521155010221e-10;
+
+constexpr double C1 =  4.16666666666666019037e-02;
+constexpr double C2 = -1.38888888888741095749e-03;
+constexpr double C3 =  2.48015872894767294178e-05;
+constexpr double C4 = -2.75573143513906633035e-07;
+constexpr double C5 =  2.08757232129817482790e-09;
+constexpr double C6 = -1.13596475577881948265e-11;
+
+template <class V>
+inline void vsincos(typename V::T x, typename V::T& s, typename V::T& c) {
+    using T = typename V::T;
+
+    // x = k*(pi/2) + r, |r| <= pi/4
+    const T k = V::round(V::mul(x, V::set1(K_TWO_OVER_PI)));
+    T r = V::fnma(k, V::set1(PIO2_1), x);
+    r = V::fnma(k, V::set1(PIO2_2), r);
+    r = V::fnma(k, V::set1(PIO2_3), r);
+
+    const T z = V::mul(r, r);
+
+    T ps = V::set1(S6);
+    ps = V::fma(ps, z, V::set1(S5));
+    ps = V::fma(ps, z, V::set1(S4));
+    ps = V::fma(ps, z, V::set1(S3));
+    ps = V::fma(ps, z, V::set1(S2));
+    ps = V::fma(ps, z, V::set1(S1));
+    const T sin_r = V::fma(V::mul(z, r), ps, r);
+
+    T pc = V::set1(C6);
+    pc = V::fma(pc, z, V::set1(C5));
+    pc = V::fma(pc, z, V::set1(C4));
+    pc = V::fma(pc, z, V::set1(C3));
+    pc = V::fma(pc, z, V::set1(C2));
+    pc = V::fma(pc, z, V::set1(C1));
+    const T cos_r = V::fma(V::mul(z, z), pc, V::fnma(V::set1(0.5), z, V::set1(1.0)));
+
+    // quadrant q = k mod 4:  sin -> s, c, -s, -c   cos -> c, -s, -c, s
+    const auto q1 = V::bit(k, 0);
+    const auto q2 = V::bit(k, 1);
+    s = V::neg_if(q2, V::select(q1, cos_r, sin_r));
+    c = V::neg_if(V::mxor(q1, q2), V::select(q1, sin_r, cos_r));
+}
+
+// Same as ds::normalize_angle for the small overshoots RK4 produces.
+template <class V>
+inline typename V::T vwrap(typename V::T a) {
+    const auto k = V::round(V::mul(a, V::set1(K_INV_TWO_PI)));
+    return V::fnma(k, V::set1(K_TWO_PI), a);
+}
+
+template <class V>
+struct VParams {
+    typename V::T l1, l2, m1, m2, g, damping;
+};
+
+// Mirrors Engine::accel term by term.
+template <class V>
+inline void vaccel(const VParams<V>& p,
+                   typename V::T th1, typename V::T w1,
+                   typename V::T th2, typename V::T w2,
+                   typename V::T& a1, typename V::T& a2) {
+    using T = typename V::T;
+    const T two = V::set1(2.0);
+
+    const T dth = V::sub(th1, th2);
+
+    T s_th1, c_th1, s_dth, c_dth, s_2dth, c_2dth, s_mix, c_mix;
+    vsincos<V>(th1, s_th1, c_th1);
+    vsincos<V>(dth, s_dth, c_dth);
+    vsincos<V>(V::mul(two, dth), s_2dth, c_2dth);
+    vsincos<V>(V::sub(th1, V::mul(two, th2)), s_mix, c_mix);
+
+    const T m12 = V::add(p.m1, p.m2);
+    const T two_m1_m2 = V::add(V::mul(two, p.m1), p.m2);
+
+    const T denom = V::sub(two_m1_m2, V::mul(p.m2, c_2dth));
+    const T denom1 = V::copysign(V::max(V::abs(denom), V::set1(1e-12)), denom);
+
+    const T w1sq = V::mul(w1, w1);
+    const T w2sq = V::mul(w2, w2);
+
+    // th1''
+    T n1 = V::mul(V::mul(V::sub(V::set1(0.0), p.g), two_m1_m2), s_th1);
+    n1 = V::sub(n1, V::mul(V::mul(p.m2, p.g), s_mix));
+    const T inner1 = V::add(V::mul(w2sq, p.l2), V::mul(V::mul(w1sq, p.l1), c_dth));
+    n1 = V::sub(n1, V::mul(V::mul(V::mul(two, s_dth), p.m2), inner1));
+    a1 = V::div(n1, V::mul(p.l1, denom1));
+
+    // th2''
+    T inner2 = V::mul(V::mul(w1sq, p.l1), m12);
+    inner2 = V::add(inner2, V::mul(V::mul(p.g, m12), c_th1));
+    inner2 = V::add(inner2, V::mul(V::mul(V::mul(w2sq, p.l2), p.m2), c_dth));
+    a2 = V::div(V::mul(V::mul(two, s_dth), inner2), V::mul(p.l2, denom1));
+
+    // damping == 0 leaves a1/a2 unchanged, so no branch
+    a1 = V::fnma(p.damping, w1, a1);
+    a2 = V::fnma(p.damping, w2, a2);
+}
+
+// One RK4 step on a single vector block.
+template <class V>
+inline void vrk4(const VParams<V>& p, typename V::T dt,
+                 typename V::T& th1, typename V::T& w1,
+                 typename V::T& th2, typename V::T& w2) {
+    using T = typename V::T;
+    const T half_dt = V::mul(V::set1(0.5), dt);
+
+    T k1a1, k1a2;
+    vaccel<V>(p, th1, w1, th2, w2, k1a1, k1a2);
+    const T k1t1 = w1, k1t2 = w2;
+
+    const T t2th1 = V::add(th1, V::mul(half_dt, k1t1));
+    const T t2w1  = V::add(w1,  V::mul(half_dt, k1a1));
+    const T t2th2 = V::add(th2, V::mul(half_dt, k1t2));
+    const T t2w2  = V::add(w2,  V::mul(half_dt, k1a2));
+    T k2a1, k2a2;
+    vaccel<V>(p, t2th1, t2w1, t2th2, t2w2, k2a1, k2a2);
+    const T k2t1 = t2w1, k2t2 = t2w2;
+
+    const T t3th1 = V::add(th1, V::mul(half_dt, k2t1));
+    const T t3w1  = V::add(w1,  V::mul(half_dt, k2a1));
+    const T t3th2 = V::add(th2, V::mul(half_dt, k2t2));
+    const T t3w2  = V::add(w2,  V::mul(half_dt, k2a2));
+    T k3a1, k3a2;
+    vaccel<V>(p, t3th1, t3w1, t3th2, t3w2, k3a1, k3a2);
+    const T k3t1 = t3w1, k3t2 = t3w2;
+
+    const T t4th1 = V::add(th1, V::mul(dt, k3t1));
+    const T t4w1  = V::add(w1,  V::mul(dt, k3a1));
+    const T t4th2 = V::add(th2, V::mul(dt, k3t2));
+    const T t4w2  = V::add(w2,  V::mul(dt, k3a2));
+    T k4a1, k4a2;
+    vaccel<V>(p, t4th1, t4w1, t4th2, t4w2, k4a1, k4a2);
+    const T k4t1 = t4w1, k4t2 = t4w2;
+
+    const T two = V::set1(2.0);
+    const T sixth = V::div(dt, V::set1(6.0));
+    auto comb = [&](T a, T b, T c, T d) {
+        return V::mul(sixth, V::add(V::add(V::add(a, V::mul(two, b)), V::mul(two, c)), d));
+    };
+
+    th1 = vwrap<V>(V::add(th1, comb(k1t1, k2t1, k3t1, k4t1)));
+    w1  = V::add(w1, comb(k1a1, k2a1, k3a1, k4a1));
+    th2 = vwrap<V>(V::add(th2, comb(k1t2, k2t2, k3t2, k4t2)));
+    w2  = V::add(w2, comb(k1a2, k2a2, k3a2, k4a2));
+}
+
+template <class V, bool PerMember>
+inline void rk4_block(const EnsembleKernelArgs& a, std::size_t i,
+                      double* th1, double* w1, double* th2, double* w2,
+                      const double* const* prm) {
+    VParams<V> p;
+    if constexpr (PerMember) {
+        p = { V::load(prm[0] + i), V::load(prm[1] + i), V::load(prm[2] + i),
+              V::load(prm[3] + i), V::load(prm[4] + i), V::load(prm[5] + i) };
+    } else {
+        p = { V::set1(a.sl1), V::set1(a.sl2), V::set1(a.sm1),
+              V::set1(a.sm2), V::set1(a.sg), V::set1(a.sdamping) };
+    }
+
+    auto t1 = V::load(th1), v1 = V::load(w1);
+    auto t2 = V::load(th2), v2 = V::load(w2);
+    vrk4<V>(p, V::set1(a.dt), t1, v1, t2, v2);
+    V::store(th1, t1); V::store(w1, v1);
+    V::store(th2, t2); V::store(w2, v2);
+}
+
+template <class V, bool PerMember>
+inline void rk4_all(const EnsembleKernelArgs& a) {
+    constexpr std::size_t W = V::W;
+    const double* prm[6] = { a.l1, a.l2, a.m1, a.m2, a.g, a.damping };
+
+    std::size_t i = 0;
+    for (; i + W <= a.n; i += W)
+        rk4_block<V, PerMember>(a, i, a.th1 + i, a.w1 + i, a.th2 + i, a.w2 + i, prm);
+
+    if (i == a.n) return;
+
+    // tail: run one padded block so every member goes through the same kernel
+    const std::size_t rem = a.n - i;
+    double th1[W] = {}, w1[W] = {}, th2[W] = {}, w2[W] = {};
+    double pp[6][W] = {};
+    const double* tail_prm[6];
+    for (std::size_t j = 0; j < rem; ++j) {
+        th1[j] = a.th1[i + j]; w1[j] = a.w1[i + j];
+        th2[j] = a.th2[i + j]; w2[j] = a.w2[i + j];
+    }
+    for (int k = 0; k < 6; ++k) {
+        for (std::size_t j = 0; j < W; ++j)
+            pp[k][j] = PerMember ? prm[k][i + (j < rem ? j : 0)] : 1.0;
+        tail_prm[k] = pp[k];
+    }
+
+    rk4_block<V, PerMember>(a, 0, th1, w1, th2, w2, tail_prm);
+
+    for (std::size_t j = 0; j < rem; ++j) {
+        a.th1[i + j] = th1[j]; a.w1[i + j] = w1[j];
+        a.th2[i + j] = th2[j]; a.w2[i + j] = w2[j];
+    }
+}
+
+template <class V>
+inline void rk4_dispatch(const EnsembleKernelArgs& a) {
+    if (a.l1) rk4_all<V, true>(a);
+    else      rk4_all<V, false>(a);
+}
+
+} // namespace
+} // namespace ds::detail
@@ -0,0 +1,52 @@
+// Built with -msimd128 (Emscripten). WebAssembly SIMD has no fused multiply-add in
+// its baseline, so fma/fnma are a separate multiply and add.
+#include <wasm_simd128.h>
+#include <cstdint>
+
+#include "ensemble_simd.hpp"
+
+namespace ds::detail {
+namespace {
+
+struct Wasm128 {
+    using T = v128_t;
+    using M = v128_t;
+    static constexpr std::size_t W = 2;
+
+    static T load(const double* p) { return wasm_v128_load(p); }
+    static void store(double* p, T v) { wasm_v128_store(p, v); }
+    static T set1(double v) { return wasm_f64x2_splat(v); }
+
+    static T add(T a, T b) { return wasm_f64x2_add(a, b); }
+    static T sub(T a, T b) { return wasm_f64x2_sub(a, b); }
+    static T mul(T a, T b) { return wasm_f64x2_mul(a, b); }
+    static T div(T a, T b) { return wasm_f64x2_div(a, b); }
+    static T fma(T a, T b, T c) { return wasm_f64x2_add(wasm_f64x2_mul(a, b), c); }
+    static T fnma(T a, T b, T c) { return wasm_f64x2_sub(c, wasm_f64x2_mul(a, b)); }
+
+    static T round(T a) { return wasm_f64x2_nearest(a); }
+    static T abs(T a) { return wasm_f64x2_abs(a); }
+    static T max(T a, T b) { return wasm_f64x2_max(a, b); }
+    static T copysign(T mag, T sgn) {
+        const T sign = wasm_f64x2_splat(-0.0);
+        return wasm_v128_or(wasm_v128_andnot(mag, sign), wasm_v128_and(sgn, sign));
+    }
+
+    // k + 1.5*2^52 puts the integer value of k in the low mantissa bits
+    static M bit(T k, int b) {
+        const v128_t ki = wasm_f64x2_add(k, wasm_f64x2_splat(6755399441055744.0));
+        const v128_t m = wasm_i64x2_splat(std::int64_t(1) << b);
+        return wasm_i64x2_eq(wasm_v128_and(ki, m), m);
+    }
+    static T select(M m, T a, T b) { return wasm_v128_bitselect(a, b, m); }
+    static T neg_if(M m, T a) { return wasm_v128_xor(a, wasm_v128_and(m, wasm_f64x2_splat(-0.0))); }
+    static M mxor(M a, M b) { return wasm_v128_xor(a, b); }
+};
+
+} // namespace
+
+void ensemble_rk4_wasm128(const EnsembleKernelArgs& a) {
+    rk4_dispatch<Wasm128>(a);
+}
+
+} // namespace ds::detail
@@ -0,0 +1,136 @@
+#include <doubleswing/image_io.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace ds {
+
+namespace {
+
+struct File {
+    std::FILE* f;
+    explicit File(const std::string& path) : f(std::fopen(path.c_str(), "wb")) {}
+    ~File() { if (f) std::fclose(f); }
+    bool close() { const bool ok = f && std::fclose(f) == 0; f = nullptr; return ok; }
+};
+
+void put_u32_le(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(std::uint8_t(v >> (8 * i)));
+}
+
+void put_u32_be(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    for (int i = 3; i >= 0; --i) out.push_back(std::uint8_t(v >> (8 * i)));
+}
+
+void put_f32_le(std::vector<std::uint8_t>& out, float v) {
+    std::uint32_t u;
+    std::memcpy(&u, &v, sizeof u);
+    put_u32_le(out, u);
+}
+
+bool write_floats(std::FILE* f, const float* row, std::size_t n) {
+    std::vector<std::uint8_t> buf;
+    buf.reserve(n * 4);
+    for (std::size_t i = 0; i < n; ++i) put_f32_le(buf, row[i]);
+    return std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+}
+
+std::uint32_t crc32(const std::uint8_t* p, std::size_t n, std::uint32_t crc = 0) {
+    static std::uint32_t table[256];
+    static const bool init = [] {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)init;
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < n; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+bool write_chunk(std::FILE* f, const char type[4], const std::vector<std::uint8_t>& data) {
+    std::vector<std::uint8_t> chunk;
+    chunk.reserve(data.size() + 12);
+    put_u32_be(chunk, static_cast<std::uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    put_u32_be(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    return std::fwrite(chunk.data(), 1, chunk.size(), f) == chunk.size();
+}
+
+} // namespace
+
+bool write_pfm(const std::string& path, std::size_t width, std::size_t height, const float* data) {
+    File file(path);
+    if (!file.f) return false;
+
+    // negative scale = little-endian; PFM stores rows bottom to top
+    if (std::fprintf(file.f, "Pf\n%zu %zu\n-1.0\n", width, height) < 0) return false;
+    for (std::size_t y = height; y-- > 0;)
+        if (!write_floats(file.f, data + y * width, width)) return false;
+
+    return file.close();
+}
+
+bool write_raw_f32(const std::string& path, std::size_t width, std::size_t height, const float* data) {
+    File file(path);
+    if (!file.f) return false;
+
+    for (std::size_t y = 0; y < height; ++y)
+        if (!write_floats(file.f, data + y * width, width)) return false;
+
+    return file.close();
+}
+
+bool write_png_gray(const std::string& path, std::size_t width, std::size_t height, const std::uint8_t* data) {
+    File file(path);
+    if (!file.f) return false;
+
+    static const std::uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (std::fwrite(sig, 1, 8, file.f) != 8) return false;
+
+    std::vector<std::uint8_t> ihdr;
+    put_u32_be(ihdr, static_cast<std::uint32_t>(width));
+    put_u32_be(ihdr, static_cast<std::uint32_t>(height));
+    ihdr.insert(ihdr.end(), { 8, 0, 0, 0, 0 }); // 8-bit gray, deflate, no filter, no interlace
+    if (!write_chunk(file.f, "IHDR", ihdr)) return false;
+
+    // scanlines with filter byte 0
+    std::vector<std::uint8_t> raw;
+    raw.reserve(height * (width + 1));
+    for (std::size_t y = 0; y < height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), data + y * width, data + (y + 1) * width);
+    }
+
+    // zlib stream of stored deflate blocks (<= 65535 bytes each)
+    std::vector<std::uint8_t> z = { 0x78, 0x01 };
+    std::uint32_t a = 1, b = 0;
+    for (std::uint8_t v : raw) { a = (a + v) % 65521; b = (b + a) % 65521; }
+
+    std::size_t pos = 0;
+    do {
+        const std::size_t len = std::min<std::size_t>(raw.size() - pos, 65535);
+        const bool last = pos + len == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back(std::uint8_t(len));
+        z.push_back(std::uint8_t(len >> 8));
+        z.push_back(std::uint8_t(~len));
+        z.push_back(std::uint8_t(~len >> 8));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+    put_u32_be(z, (b << 16) | a);
+
+    if (!write_chunk(file.f, "IDAT", z)) return false;
+    if (!write_chunk(file.f, "IEND", {})) return false;
+
+    return file.close();
+}
+
+} // namespace ds
@@ -0,0 +1,289 @@
+#include <doubleswing/lyapunov.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+
+namespace ds {
+
+namespace {
+
+// Forward-mode dual number carrying K directional derivatives.
+// Value parts are computed in the same order as the plain double code,
+// so they round identically.
+template <int K>
+struct Dual {
+    double v = 0.0;
+    double d[K] = {};
+};
+
+template <int K>
+Dual<K> operator+(const Dual<K>& a, const Dual<K>& b) {
+    Dual<K> r; r.v = a.v + b.v;
+    for (int i = 0; i < K; ++i) r.d[i] = a.d[i] + b.d[i];
+    return r;
+}
+
+template <int K>
+Dual<K> operator-(const Dual<K>& a, const Dual<K>& b) {
+    Dual<K> r; r.v = a.v - b.v;
+    for (int i = 0; i < K; ++i) r.d[i] = a.d[i] - b.d[i];
+    return r;
+}
+
+template <int K>
+Dual<K> operator-(double a, const Dual<K>& b) {
+    Dual<K> r; r.v = a - b.v;
+    for (int i = 0; i < K; ++i) r.d[i] = -b.d[i];
+    return r;
+}
+
+template <int K>
+Dual<K> operator*(const Dual<K>& a, const Dual<K>& b) {
+    Dual<K> r; r.v = a.v * b.v;
+    for (int i = 0; i < K; ++i) r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+    return r;
+}
+
+template <int K>
+Dual<K> operator*(double a, const Dual<K>& b) {
+    Dual<K> r; r.v = a * b.v;
+    for (int i = 0; i < K; ++i) r.d[i] = a * b.d[i];
+    return r;
+}
+
+template <int K>
+Dual<K> operator*(const Dual<K>& a, double b) { return b * a; }
+
+template <int K>
+Dual<K> operator/(const Dual<K>& a, const Dual<K>& b) {
+    Dual<K> r; r.v = a.v / b.v;
+    for (int i = 0; i < K; ++i) r.d[i] = (a.d[i] - r.v * b.d[i]) / b.v;
+    return r;
+}
+
+template <int K>
+Dual<K> sin(const Dual<K>& a) {
+    Dual<K> r; r.v = std::sin(a.v);
+    const double c = std::cos(a.v);
+    for (int i = 0; i < K; ++i) r.d[i] = c * a.d[i];
+    return r;
+}
+
+template <int K>
+Dual<K> cos(const Dual<K>& a) {
+    Dual<K> r; r.v = std::cos(a.v);
+    const double s = -std::sin(a.v);
+    for (int i = 0; i < K; ++i) r.d[i] = s * a.d[i];
+    return r;
+}
+
+template <int K>
+struct DState {
+    Dual<K> th1, w1;
+    Dual<K> th2, w2;
+};
+
+// Engine::accel on duals (same expression order).
+template <int K>
+void accel_tl(const Params& p, const DState<K>& st, Dual<K>& a1, Dual<K>& a2) {
+    const Dual<K>& th1 = st.th1;
+    const Dual<K>& th2 = st.th2;
+    const Dual<K>& w1  = st.w1;
+    const Dual<K>& w2  = st.w2;
+
+    const double m1 = p.m1;
+    const double m2 = p.m2;
+    const double l1 = p.l1;
+    const double l2 = p.l2;
+    const double g  = p.g;
+
+    const Dual<K> dth = th1 - th2;
+
+    const Dual<K> denom = (2.0*m1 + m2 - m2*cos(2.0*dth));
+
+    // same clamp as Engine::accel; inside the clamp the denominator is constant
+    const double eps = 1e-12;
+    Dual<K> denom1 = denom;
+    if (std::abs(denom.v) < eps) {
+        denom1 = Dual<K>{};
+        denom1.v = eps * (denom.v < 0 ? -1.0 : 1.0);
+    }
+
+    a1 = (-g*(2.0*m1 + m2)*sin(th1)
+          - m2*g*sin(th1 - 2.0*th2)
+          - 2.0*sin(dth)*m2*(w2*w2*l2 + w1*w1*l1*cos(dth)))
+         / (l1 * denom1);
+
+    a2 = ( 2.0*sin(dth) *
+          ( w1*w1*l1*(m1 + m2)
+            + g*(m1 + m2)*cos(th1)
+            + w2*w2*l2*m2*cos(dth) ) )
+         / (l2 * denom1);
+
+    if (p.damping != 0.0) {
+        a1 = a1 - p.damping * w1;
+        a2 = a2 - p.damping * w2;
+    }
+}
+
+// Engine::rk4 on the augmented (state, tangents) system.
+template <int K>
+void rk4_tl(const Params& p, DState<K>& st, double dt) {
+    auto deriv = [&](const DState<K>& x) -> DState<K> {
+        Dual<K> a1, a2;
+        accel_tl(p, x, a1, a2);
+        return DState<K>{ x.w1, a1, x.w2, a2 };
+    };
+
+    auto axpy = [](const DState<K>& x, double h, const DState<K>& k) -> DState<K> {
+        return DState<K>{ x.th1 + h * k.th1, x.w1 + h * k.w1,
+                          x.th2 + h * k.th2, x.w2 + h * k.w2 };
+    };
+
+    const DState<K> k1 = deriv(st);
+    const DState<K> k2 = deriv(axpy(st, 0.5 * dt, k1));
+    const DState<K> k3 = deriv(axpy(st, 0.5 * dt, k2));
+    const DState<K> k4 = deriv(axpy(st, dt, k3));
+
+    auto comb = [&](const Dual<K>& a, const Dual<K>& b, const Dual<K>& c, const Dual<K>& d) {
+        return (dt / 6.0) * (a + 2.0*b + 2.0*c + d);
+    };
+
+    st.th1 = st.th1 + comb(k1.th1, k2.th1, k3.th1, k4.th1);
+    st.w1  = st.w1  + comb(k1.w1,  k2.w1,  k3.w1,  k4.w1);
+    st.th2 = st.th2 + comb(k1.th2, k2.th2, k3.th2, k4.th2);
+    st.w2  = st.w2  + comb(k1.w2,  k2.w2,  k3.w2,  k4.w2);
+
+    // wrapping shifts the angle by a constant, tangents are unaffected
+    st.th1.v = normalize_angle(st.th1.v);
+    st.th2.v = normalize_angle(st.th2.v);
+}
+
+template <int K>
+void step_tl(const Params& p, State& s, std::array<State, 4>& t, double dt) {
+    DState<K> st;
+    st.th1.v = s.th1; st.w1.v = s.w1;
+    st.th2.v = s.th2; st.w2.v = s.w2;
+    for (int i = 0; i < K; ++i) {
+        st.th1.d[i] = t[i].th1; st.w1.d[i] = t[i].w1;
+        st.th2.d[i] = t[i].th2; st.w2.d[i] = t[i].w2;
+    }
+
+    rk4_tl<K>(p, st, dt);
+
+    s = State{ st.th1.v, st.w1.v, st.th2.v, st.w2.v };
+    for (int i = 0; i < K; ++i)
+        t[i] = State{ st.th1.d[i], st.w1.d[i], st.th2.d[i], st.w2.d[i] };
+}
+
+double dot(const State& a, const State& b) {
+    return a.th1*b.th1 + a.w1*b.w1 + a.th2*b.th2 + a.w2*b.w2;
+}
+
+} // namespace
+
+VariationalEngine::VariationalEngine(const Params& params, const State& s0, int tangents)
+    : p(params), s(s0), k(std::clamp(tangents, 1, 4)) {
+    // keep angles sane at construction (as Engine does)
+    s.th1 = normalize_angle(s.th1);
+    s.th2 = normalize_angle(s.th2);
+
+    tangent[0] = State{1.0, 0.0, 0.0, 0.0};
+    tangent[1] = State{0.0, 1.0, 0.0, 0.0};
+    tangent[2] = State{0.0, 0.0, 1.0, 0.0};
+    tangent[3] = State{0.0, 0.0, 0.0, 1.0};
+}
+
+void VariationalEngine::step(double dt) {
+    // same cap as Engine::step
+    dt = std::clamp(dt, 0.0, 1.0/15.0);
+
+    switch (k) {
+        case 1:  step_tl<1>(p, s, tangent, dt); break;
+        case 2:  step_tl<2>(p, s, tangent, dt); break;
+        case 3:  step_tl<3>(p, s, tangent, dt); break;
+        default: step_tl<4>(p, s, tangent, dt); break;
+    }
+}
+
+void VariationalEngine::orthonormalize(double* norms) {
+    for (int i = 0; i < k; ++i) {
+        State& v = tangent[i];
+        for (int j = 0; j < i; ++j) {
+            const double c = dot(v, tangent[j]);
+            v.th1 -= c * tangent[j].th1; v.w1 -= c * tangent[j].w1;
+            v.th2 -= c * tangent[j].th2; v.w2 -= c * tangent[j].w2;
+        }
+        const double n = std::sqrt(dot(v, v));
+        norms[i] = n;
+        if (n > 0.0) {
+            v.th1 /= n; v.w1 /= n;
+            v.th2 /= n; v.w2 /= n;
+        }
+    }
+}
+
+LyapunovResult lyapunov(const Params& p, const State& s0, const LyapunovConfig& cfg) {
+    LyapunovResult r;
+    const double dt = std::clamp(cfg.dt, 0.0, 1.0/15.0);
+    if (dt <= 0.0) return r;
+
+    VariationalEngine ve(p, s0, cfg.full_spectrum ? 4 : 1);
+    const std::size_t renorm = std::max<std::size_t>(cfg.renorm_steps, 1);
+    double norms[4];
+
+    // transient: let the tangents line up with the unstable directions
+    const auto transient = static_cast<std::size_t>(std::llround(cfg.t_transient / dt));
+    for (std::size_t i = 1; i <= transient; ++i) {
+        ve.step(dt);
+        if (i % renorm == 0) ve.orthonormalize(norms);
+    }
+    ve.orthonormalize(norms);
+
+    const auto steps = static_cast<std::size_t>(std::llround(cfg.t_measure / dt));
+    if (steps == 0) return r;
+
+    double sums[4] = {};
+    for (std::size_t i = 1; i <= steps; ++i) {
+        ve.step(dt);
+        if (i % renorm == 0 || i == steps) {
+            ve.orthonormalize(norms);
+            for (int j = 0; j < ve.k; ++j) sums[j] += std::log(norms[j]);
+        }
+    }
+
+    const double t = double(steps) * dt;
+    r.lle = sums[0] / t;
+    if (cfg.full_spectrum) {
+        for (int j = 0; j < 4; ++j) r.spectrum[j] = sums[j] / t;
+        std::sort(r.spectrum.begin(), r.spectrum.end(), std::greater<double>());
+        r.lle = r.spectrum[0];
+    }
+    return r;
+}
+
+std::vector<LyapunovResult> lyapunov_batch(
+        const Params& p, const std::vector<State>& s0, const LyapunovConfig& cfg,
+        unsigned threads,
+        const std::function<void(std::size_t, std::size_t)>& progress) {
+    std::vector<LyapunovResult> out(s0.size());
+
+    std::mutex progress_m;
+    std::size_t done = 0;
+
+    ThreadPool pool(threads);
+    pool.parallel_for(s0.size(), [&](std::size_t i, unsigned) {
+        out[i] = lyapunov(p, s0[i], cfg);
+
+        if (!progress) return;
+        std::lock_guard<std::mutex> lk(progress_m);
+        progress(++done, s0.size());
+    });
+
+    return out;
+}
+
+} // namespace ds
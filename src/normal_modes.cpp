@@ -0,0 +1,126 @@
+#include <doubleswing/engine.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ds {
+
+namespace {
+
+// Propagator of a damped oscillator x'' + 2 gamma x' + w2 x = 0 over t: after t,
+//   x = c x0 + s (v0 + gamma x0),   v = c v0 - s (w2 x0 + gamma v0)
+// with c, s the decay times (cos, sin / wd), or their hyperbolic / critical limits.
+template <class Real>
+void mode_propagator(Real w2, Real gamma, Real t, Real& c, Real& s) {
+    const Real disc = w2 - gamma * gamma;
+    if (disc > Real(0)) {
+        const Real wd = std::sqrt(disc);
+        const Real decay = std::exp(-gamma * t);
+        c = decay * std::cos(wd * t);
+        s = decay * std::sin(wd * t) / wd;
+    } else if (disc < Real(0)) {
+        // overdamped: exp(-gamma t) cosh / sinh as two exponentials, so a long t
+        // cannot overflow
+        const Real k = std::sqrt(-disc);
+        const Real slow = std::exp((k - gamma) * t);
+        const Real fast = std::exp(-(k + gamma) * t);
+        c = Real(0.5) * (slow + fast);
+        s = Real(0.5) * (slow - fast) / k;
+    } else {
+        const Real decay = std::exp(-gamma * t);
+        c = decay;
+        s = decay * t;
+    }
+}
+
+} // namespace
+
+template <class Real>
+bool NormalModesOf<Real>::build(const ParamsOf<Real>& params) {
+    p = params;
+    valid = false;
+    step_dt = Real(-1);
+    const Real l1 = p.l1, l2 = p.l2, m1 = p.m1, m2 = p.m2, g = p.g;
+    if (!(l1 > Real(0) && l2 > Real(0) && m1 > Real(0) && m2 > Real(0) && g > Real(0)) ||
+        !std::isfinite(p.damping))
+        return false;
+
+    mass[0] = (m1 + m2) * l1 * l1;
+    mass[1] = m2 * l1 * l2;
+    mass[2] = m2 * l2 * l2;
+    stiff[0] = (m1 + m2) * g * l1;
+    stiff[1] = m2 * g * l2;
+
+    // det(K - lambda M) = 0; the smaller root in the form without cancellation
+    const Real a = mass[0] * mass[2] - mass[1] * mass[1];
+    const Real b = stiff[0] * mass[2] + stiff[1] * mass[0];
+    const Real c = stiff[0] * stiff[1];
+    const Real r = std::sqrt(std::max(b * b - Real(4) * a * c, Real(0)));
+    const Real lambda[2] = { Real(2) * c / (b + r), (b + r) / (Real(2) * a) };
+
+    for (int j = 0; j < 2; ++j) {
+        omega[j] = std::sqrt(lambda[j]);
+        // (K - lambda M) v = 0, first row; mass[1] > 0 keeps the first entry nonzero
+        const Real v0 = lambda[j] * mass[1];
+        const Real v1 = stiff[0] - lambda[j] * mass[0];
+        const Real n = std::hypot(v0, v1);
+        shape[0][j] = v0 / n;
+        shape[1][j] = v1 / n;
+    }
+    const Real det = shape[0][0] * shape[1][1] - shape[0][1] * shape[1][0];
+    inv[0][0] =  shape[1][1] / det;
+    inv[0][1] = -shape[0][1] / det;
+    inv[1][0] = -shape[1][0] / det;
+    inv[1][1] =  shape[0][0] / det;
+
+    // Relative to the restoring terms (~ g * angle), the dropped terms are about
+    // angle^2 / 6 (sin), delta^2 / 2 (cos of the angle difference on the inertia
+    // coupling) and, for the centripetal terms, l * omega^2 * delta / g with omega up
+    // to the fast mode's omega * amplitude.
+    const Real reach = std::max(l1, m2 * l2 / (m1 + m2));
+    error_scale = Real(0.5) + reach * lambda[1] / g;
+    valid = true;
+    return true;
+}
+
+template <class Real>
+bool NormalModesOf<Real>::built_for(const ParamsOf<Real>& params) const {
+    return valid && p.l1 == params.l1 && p.l2 == params.l2 && p.m1 == params.m1 &&
+           p.m2 == params.m2 && p.g == params.g && p.damping == params.damping;
+}
+
+template <class Real>
+Real NormalModesOf<Real>::linear_error(const StateOf<Real>& s) const {
+    // quadratic energy; K is diagonal, so the largest |th1 - th2| it allows is
+    // sqrt(2 E (1/k1 + 1/k2)), which also bounds each angle
+    const Real ke = Real(0.5) * (mass[0] * s.w1 * s.w1 + Real(2) * mass[1] * s.w1 * s.w2 + mass[2] * s.w2 * s.w2);
+    const Real pe = Real(0.5) * (stiff[0] * s.th1 * s.th1 + stiff[1] * s.th2 * s.th2);
+    const Real reach2 = Real(2) * (ke + pe) * (Real(1) / stiff[0] + Real(1) / stiff[1]);
+    return error_scale * reach2;
+}
+
+template <class Real>
+void NormalModesOf<Real>::advance(StateOf<Real>& s, Real dt) {
+    const Real gamma = Real(0.5) * p.damping;
+    if (dt != step_dt) {
+        // a fixed-rate caller pays for the transcendentals once
+        for (int j = 0; j < 2; ++j) mode_propagator(omega[j] * omega[j], gamma, dt, prop[j][0], prop[j][1]);
+        step_dt = dt;
+    }
+    Real x[2], v[2];
+    for (int j = 0; j < 2; ++j) {
+        const Real w2 = omega[j] * omega[j], c = prop[j][0], sd = prop[j][1];
+        const Real x0 = inv[j][0] * s.th1 + inv[j][1] * s.th2;
+        const Real v0 = inv[j][0] * s.w1 + inv[j][1] * s.w2;
+        x[j] = c * x0 + sd * (v0 + gamma * x0);
+        v[j] = c * v0 - sd * (w2 * x0 + gamma * v0);
+    }
+    s.th1 = shape[0][0] * x[0] + shape[0][1] * x[1];
+    s.th2 = shape[1][0] * x[0] + shape[1][1] * x[1];
+    s.w1  = shape[0][0] * v[0] + shape[0][1] * v[1];
+    s.w2  = shape[1][0] * v[0] + shape[1][1] * v[1];
+}
+
+template struct NormalModesOf<double>;
+template struct NormalModesOf<float>;
+
+} // namespace ds
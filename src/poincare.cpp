@@ -0,0 +1,189 @@
+#include <doubleswing/poincare.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace ds {
+
+namespace {
+
+// angle b moved by whole turns to sit next to a (b itself when it already does)
+double unwrap_angle(double a, double b) {
+    return std::abs(b - a) <= PI ? b : a + std::remainder(b - a, 2.0 * PI);
+}
+
+State unwrap_to(const State& a, const State& b) {
+    return State{ unwrap_angle(a.th1, b.th1), b.w1, unwrap_angle(a.th2, b.th2), b.w2 };
+}
+
+// g(s), unwrapped to sit next to ref when the section is an angle
+double section_value(const Section& sec, const State& s, double ref) {
+    const double g = sec.g(s);
+    return sec.angle ? unwrap_angle(ref, g) : g;
+}
+
+bool crossed(CrossDir dir, double g0, double g1) {
+    const bool rising  = g0 < 0.0 && g1 >= 0.0;
+    const bool falling = g0 > 0.0 && g1 <= 0.0;
+    switch (dir) {
+        case CrossDir::Rising:  return rising;
+        case CrossDir::Falling: return falling;
+        case CrossDir::Both:    break;
+    }
+    return rising || falling;
+}
+
+// Illinois regula falsi on [a, b] with f(a), f(b) of opposite sign (or one of them 0).
+template <class F>
+double illinois(const F& f, double a, double fa, double b, double fb, double tol) {
+    if (fa == 0.0) return a;
+    if (fb == 0.0) return b;
+    int side = 0;
+    for (int i = 0; i < 60 && b - a > tol; ++i) {
+        const double x = std::clamp((a * fb - b * fa) / (fb - fa), a, b);
+        const double fx = f(x);
+        if (fx == 0.0) return x;
+        if ((fx < 0.0) == (fa < 0.0)) {
+            a = x; fa = fx;
+            if (side == -1) fb *= 0.5;
+            side = -1;
+        } else {
+            b = x; fb = fx;
+            if (side == 1) fa *= 0.5;
+            side = 1;
+        }
+    }
+    return std::abs(fa) < std::abs(fb) ? a : b;
+}
+
+// cubic Hermite through (y0, f0) at s = 0 and (y1, f1) at s = 1, step length h
+double hermite(double y0, double f0, double y1, double f1, double h, double s) {
+    const double s2 = s * s, s3 = s2 * s;
+    return (2.0*s3 - 3.0*s2 + 1.0) * y0 + (s3 - 2.0*s2 + s) * h * f0
+         + (3.0*s2 - 2.0*s3) * y1 + (s3 - s2) * h * f1;
+}
+
+// Crossing inside the step of length h that starts at `start` (e.p, integrator, trig)
+// and ends at `end` (unwrapped to start). Returns the fraction of the step and the
+// state there, unwrapped.
+double refine(const Engine& e, const State& start, const State& end, double g0, double g1,
+              const Section& sec, double h, double t_tol, State& at) {
+    double a1, a2, b1, b2;
+    e.accel(start, a1, a2);
+    e.accel(end, b1, b2);
+
+    // first guess from the Hermite fit through the step's end points
+    auto model = [&](double s) {
+        return section_value(sec, State{ hermite(start.th1, start.w1, end.th1, end.w1, h, s),
+                            hermite(start.w1, a1, end.w1, b1, h, s),
+                            hermite(start.th2, start.w2, end.th2, end.w2, h, s),
+                            hermite(start.w2, a2, end.w2, b2, h, s) }, g0);
+    };
+    const double tol = std::max(t_tol / h, 1e-15);
+    const double guess = illinois(model, 0.0, g0, 1.0, g1, tol);
+
+    // then pin it down on sub-steps of the real integrator
+    Engine sub = e;
+    auto substep = [&](double s) {
+        sub.s = start;
+        sub.step(s * h);
+        return unwrap_to(start, sub.s);
+    };
+
+    double lo = 0.0, glo = g0, hi = 1.0, ghi = g1;
+    if (guess > 0.0 && guess < 1.0) {
+        const double gg = section_value(sec, substep(guess), g0);
+        if (gg == 0.0) {
+            at = substep(guess);
+            return guess;
+        }
+        if ((gg < 0.0) == (g0 < 0.0)) { lo = guess; glo = gg; }
+        else                          { hi = guess; ghi = gg; }
+    }
+    const double s = illinois([&](double x) { return section_value(sec, substep(x), g0); }, lo, glo, hi, ghi, tol);
+    at = s >= 1.0 ? end : substep(s);
+    return s;
+}
+
+} // namespace
+
+Section th1_section(double th, CrossDir dir) {
+    return Section{ [th](const State& s) { return std::remainder(s.th1 - th, 2.0 * PI); }, dir, true };
+}
+
+Section th2_section(double th, CrossDir dir) {
+    return Section{ [th](const State& s) { return std::remainder(s.th2 - th, 2.0 * PI); }, dir, true };
+}
+
+std::size_t trace_section(const Params& p, const State& s0, const Section& sec, const PoincareConfig& cfg,
+                          const std::function<bool(const SectionHit&)>& hit) {
+    const double dt = std::clamp(cfg.dt, 0.0, 1.0 / 15.0);
+    if (dt <= 0.0 || !sec.g) return 0;
+
+    Engine e(p, s0);
+    e.integrator = cfg.integrator;
+    e.trig = cfg.trig;
+
+    // no steps for a NaN or negative horizon, or one whose step count is past uint64_t
+    const double n = std::ceil(cfg.t_max / dt);
+    const auto steps = n >= 0.0 && n < 1e18 ? static_cast<std::uint64_t>(n) : 0;
+    std::size_t hits = 0;
+    State cur = e.s;
+    double g0 = sec.g(cur);
+
+    for (std::uint64_t k = 1; k <= steps; ++k) {
+        e.step(dt);
+        if (!std::isfinite(e.s.th1) || !std::isfinite(e.s.th2) ||
+            !std::isfinite(e.s.w1) || !std::isfinite(e.s.w2)) break;
+
+        const State end = unwrap_to(cur, e.s);
+        const double g1 = section_value(sec, end, g0);
+
+        if (crossed(sec.dir, g0, g1)) {
+            State at;
+            const double s = refine(e, cur, end, g0, g1, sec, dt, cfg.t_tol, at);
+            const SectionHit h{ (double(k - 1) + s) * dt,
+                                State{ normalize_angle(at.th1), at.w1, normalize_angle(at.th2), at.w2 } };
+            ++hits;
+            if (!hit(h) || hits == cfg.max_hits) break;
+        }
+
+        // the next step starts from the wrapped state; g only changes if a wrap happened
+        // (or, for an angle section, when it went past +-pi itself)
+        const bool wrapped = e.s.th1 != end.th1 || e.s.th2 != end.th2;
+        g0 = wrapped || sec.angle ? sec.g(e.s) : g1;
+        cur = e.s;
+    }
+    return hits;
+}
+
+std::size_t poincare_batch(const Params& p, const std::vector<State>& s0, const Section& sec,
+                           const PoincareConfig& cfg, const PoincareSink& sink,
+                           unsigned threads, std::size_t chunk) {
+    const std::size_t total = s0.size();
+    chunk = std::max<std::size_t>(chunk, 1);
+    std::vector<PoincareRun> buf(std::min(chunk, total));
+
+    ThreadPool pool(threads);
+    std::size_t done = 0;
+    while (done < total) {
+        const std::size_t n = std::min(chunk, total - done);
+        pool.parallel_for(n, [&](std::size_t i, unsigned) {
+            PoincareRun& r = buf[i];
+            r.index = done + i;
+            r.hits.clear(); // keeps the capacity from the previous chunk
+            (void)trace_section(p, s0[done + i], sec, cfg, [&](const SectionHit& h) {
+                r.hits.push_back(h);
+                return true;
+            });
+        });
+
+        if (sink && !sink(buf.data(), n)) break;
+        done += n;
+    }
+    return done;
+}
+
+} // namespace ds
@@ -0,0 +1,78 @@
+#include <doubleswing/precision.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace ds {
+
+namespace {
+
+double angle_diff(const State& a, const State& b) {
+    // exact wrap for any size, so an angle gone non-finite reads as NaN, not as 0
+    return std::max(std::abs(std::remainder(a.th1 - b.th1, 2.0 * PI)),
+                    std::abs(std::remainder(a.th2 - b.th2, 2.0 * PI)));
+}
+
+bool finite(const State& s) {
+    return std::isfinite(s.th1) && std::isfinite(s.w1) && std::isfinite(s.th2) && std::isfinite(s.w2);
+}
+
+template <class E>
+E configured(const Params& p, const State& s0, const DivergenceConfig& cfg) {
+    E e(params_as<typename E::real>(p), state_as<typename E::real>(s0));
+    e.integrator = cfg.integrator;
+    e.trig = cfg.trig;
+    return e;
+}
+
+} // namespace
+
+DivergenceReport divergence_report(const Params& p, const State& s0, const DivergenceConfig& cfg) {
+    DivergenceReport r;
+    const double dt = std::clamp(cfg.dt, 0.0, 1.0 / 15.0);
+    if (dt <= 0.0) return r;
+
+    Engine ref = configured<Engine>(p, s0, cfg);
+    Engine half = configured<Engine>(p, s0, cfg);
+    EngineF lo = configured<EngineF>(p, s0, cfg);
+
+    const double e0 = ref.energy_breakdown().total();
+    const bool track_energy = p.damping == 0.0 && e0 != 0.0;
+
+    const auto steps = static_cast<std::uint64_t>(std::ceil(cfg.t_max / dt));
+    const auto one_second = std::min(steps, static_cast<std::uint64_t>(std::ceil(1.0 / dt)));
+
+    for (std::uint64_t k = 1; k <= steps; ++k) {
+        const double t = double(k) * dt;
+        ref.step(dt);
+        half.step(0.5 * dt);
+        half.step(0.5 * dt);
+        lo.step(float(dt));
+
+        const State fs = state_from(lo.s);
+        const double d_float = angle_diff(ref.s, fs);
+        const double d_trunc = angle_diff(ref.s, half.s);
+
+        if (k == one_second) {
+            r.float_error_1s = d_float;
+            r.truncation_error_1s = d_trunc;
+        }
+        if (track_energy) {
+            if (finite(ref.s))
+                r.energy_error_double = std::max(r.energy_error_double,
+                                                 std::abs(ref.energy_breakdown().total() - e0) / std::abs(e0));
+            if (finite(fs))
+                r.energy_error_float = std::max(r.energy_error_float,
+                                                std::abs(lo.energy_breakdown().total() - e0) / std::abs(e0));
+        }
+
+        // !(d <= tol) also catches NaN from a blown-up run
+        if (r.float_time < 0.0 && !(d_float <= cfg.tol)) r.float_time = t;
+        if (r.truncation_time < 0.0 && !(d_trunc <= cfg.tol)) r.truncation_time = t;
+        if (!finite(ref.s)) break;
+    }
+    return r;
+}
+
+} // namespace ds
@@ -0,0 +1,334 @@
+#include <doubleswing/replay.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ds {
+
+namespace {
+
+constexpr char MAGIC[8] = { 'D', 'S', 'R', 'P', 'L', '0', '0', '1' };
+constexpr std::size_t HEADER = 32;
+constexpr std::uint32_t VERSION = 2; // 2: linear_tol in Checkpoint and SetConfig
+constexpr std::uint32_t MAX_FIELDS = 15;
+
+void put_u32(std::uint8_t* o, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) o[i] = std::uint8_t(v >> (8 * i));
+}
+
+void put_u64(std::uint8_t* o, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) o[i] = std::uint8_t(v >> (8 * i));
+}
+
+std::uint32_t get_u32(const std::uint8_t* b) {
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= std::uint32_t(b[i]) << (8 * i);
+    return v;
+}
+
+std::uint64_t get_u64(const std::uint8_t* b) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= std::uint64_t(b[i]) << (8 * i);
+    return v;
+}
+
+double get_f64(const std::uint8_t* b) {
+    const std::uint64_t u = get_u64(b);
+    double v;
+    std::memcpy(&v, &u, 8);
+    return v;
+}
+
+// fields per record kind (End has none)
+std::uint32_t field_count(ReplayRecord k) {
+    switch (k) {
+        case ReplayRecord::Checkpoint: return 15;
+        case ReplayRecord::SetState:   return 4;
+        case ReplayRecord::SetParams:  return 6;
+        case ReplayRecord::SetDt:      return 1;
+        case ReplayRecord::SetConfig:  return 3;
+        case ReplayRecord::DragP1:     return 3;
+        case ReplayRecord::End:        return 0;
+    }
+    return 0;
+}
+
+// integrator and trig fields must name an enumerator exactly; int(NaN) or int(1e300) is undefined
+bool enum_ok(double v, int last) {
+    return v >= 0.0 && v <= double(last) && v == std::floor(v);
+}
+
+bool config_ok(double integrator, double trig) {
+    return enum_ok(integrator, int(Integrator::GaussLegendre4)) && enum_ok(trig, int(TrigMode::Polynomial));
+}
+
+bool same_bits(const State& a, const State& b) {
+    return std::memcmp(&a, &b, sizeof(State)) == 0;
+}
+
+} // namespace
+
+// ---- recorder ----
+
+Recorder::~Recorder() {
+    close();
+}
+
+bool Recorder::open(const std::string& path, std::uint64_t checkpoint_every) {
+    close();
+    if (checkpoint_every == 0) return false;
+
+    f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+
+    every = checkpoint_every;
+    count = 0;
+    t = 0.0;
+    buf.clear();
+
+    std::uint8_t h[HEADER] = {};
+    std::memcpy(h, MAGIC, 8);
+    put_u32(h + 8, VERSION);
+    put_u64(h + 16, every);
+    ok = std::fwrite(h, 1, HEADER, f) == HEADER;
+
+    checkpoint();
+    return flush();
+}
+
+void Recorder::put(ReplayRecord kind, const double* v, std::uint32_t n) {
+    const std::size_t at = buf.size();
+    buf.resize(at + 16 + 8 * std::size_t(n));
+    put_u32(buf.data() + at, static_cast<std::uint32_t>(kind));
+    put_u32(buf.data() + at + 4, n);
+    put_u64(buf.data() + at + 8, count);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        std::uint64_t u;
+        std::memcpy(&u, &v[i], 8);
+        put_u64(buf.data() + at + 16 + 8 * i, u);
+    }
+}
+
+void Recorder::checkpoint() {
+    const State& s = eng.s;
+    const Params& p = eng.p;
+    const double v[15] = { s.th1, s.w1, s.th2, s.w2, p.l1, p.l2, p.m1, p.m2, p.g, p.damping,
+                           step_dt, double(eng.integrator), double(eng.trig), eng.linear_tol, t };
+    put(ReplayRecord::Checkpoint, v, 15);
+}
+
+bool Recorder::flush() {
+    if (!f) return false;
+    if (!buf.empty() && std::fwrite(buf.data(), 1, buf.size(), f) != buf.size()) ok = false;
+    buf.clear();
+    if (std::fflush(f) != 0) ok = false;
+    return ok;
+}
+
+void Recorder::set_state(const State& s) {
+    eng.s = s;
+    if (!f) return;
+    const double v[4] = { s.th1, s.w1, s.th2, s.w2 };
+    put(ReplayRecord::SetState, v, 4);
+}
+
+void Recorder::set_params(const Params& p) {
+    eng.p = p;
+    if (!f) return;
+    const double v[6] = { p.l1, p.l2, p.m1, p.m2, p.g, p.damping };
+    put(ReplayRecord::SetParams, v, 6);
+}
+
+void Recorder::set_dt(double dt) {
+    step_dt = dt;
+    if (!f) return;
+    put(ReplayRecord::SetDt, &dt, 1);
+}
+
+void Recorder::set_config(Integrator integrator, TrigMode trig, double linear_tol) {
+    eng.integrator = integrator;
+    eng.trig = trig;
+    eng.linear_tol = linear_tol;
+    if (!f) return;
+    const double v[3] = { double(integrator), double(trig), linear_tol };
+    put(ReplayRecord::SetConfig, v, 3);
+}
+
+void Recorder::step() {
+    eng.step(step_dt);
+    after_step();
+}
+
+void Recorder::step_drag_p1(double th1, double w1, double a1) {
+    if (f) {
+        const double v[3] = { th1, w1, a1 };
+        put(ReplayRecord::DragP1, v, 3);
+    }
+    eng.step_drag_p1(step_dt, th1, w1, a1);
+    after_step();
+}
+
+void Recorder::after_step() {
+    // same clamp as Engine::step, so time() matches what was simulated
+    t += std::clamp(step_dt, 0.0, 1.0 / 15.0);
+    ++count;
+    if (f && count % every == 0) {
+        checkpoint();
+        flush();
+    }
+}
+
+bool Recorder::close() {
+    if (!f) return false;
+    put(ReplayRecord::End, nullptr, 0);
+    flush();
+    if (std::fclose(f) != 0) ok = false;
+    f = nullptr;
+    return ok;
+}
+
+// ---- replayer ----
+
+bool Replayer::open(const std::string& path) {
+    ev.clear();
+    cps.clear();
+    total = 0;
+    ended = false;
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::vector<std::uint8_t> data;
+    std::uint8_t tmp[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(tmp, 1, sizeof tmp, file)) > 0) data.insert(data.end(), tmp, tmp + n);
+    std::fclose(file);
+
+    if (data.size() < HEADER || std::memcmp(data.data(), MAGIC, 8) != 0) return false;
+    if (get_u32(data.data() + 8) != VERSION) return false;
+
+    // stop at the first truncated or malformed record
+    std::size_t at = HEADER;
+    while (at + 16 <= data.size() && !ended) {
+        const std::uint8_t* r = data.data() + at;
+        const std::uint32_t raw_kind = get_u32(r);
+        const std::uint32_t fields = get_u32(r + 4);
+        const std::uint64_t step = get_u64(r + 8);
+        if (raw_kind > std::uint32_t(ReplayRecord::End)) break;
+        const auto kind = static_cast<ReplayRecord>(raw_kind);
+        if (fields != field_count(kind) || fields > MAX_FIELDS) break;
+        if (at + 16 + 8 * std::size_t(fields) > data.size()) break;
+        if (step < total) break; // steps never go backwards
+
+        double v[MAX_FIELDS] = {};
+        for (std::uint32_t i = 0; i < fields; ++i) v[i] = get_f64(r + 16 + 8 * i);
+        if (kind == ReplayRecord::Checkpoint && !config_ok(v[11], v[12])) break;
+        if (kind == ReplayRecord::SetConfig && !config_ok(v[0], v[1])) break;
+        at += 16 + 8 * std::size_t(fields);
+        total = step;
+
+        if (kind == ReplayRecord::End) {
+            ended = true;
+        } else if (kind == ReplayRecord::Checkpoint) {
+            Checkpoint c;
+            c.step = step;
+            c.s = State{ v[0], v[1], v[2], v[3] };
+            c.p = Params{ v[4], v[5], v[6], v[7], v[8], v[9] };
+            c.dt = v[10];
+            c.integrator = static_cast<Integrator>(int(v[11]));
+            c.trig = static_cast<TrigMode>(int(v[12]));
+            c.linear_tol = v[13];
+            c.time = v[14];
+            c.event = ev.size();
+            cps.push_back(c);
+        } else {
+            Event e{ step, kind, {} };
+            std::copy(v, v + std::min<std::uint32_t>(fields, 6), e.v);
+            ev.push_back(e);
+        }
+    }
+
+    if (cps.empty() || cps.front().step != 0) return false;
+
+    // Without End, trust only the steps up to the last checkpoint: events past it may
+    // belong to a step the crash interrupted.
+    if (!ended) {
+        total = cps.back().step;
+        ev.resize(cps.back().event);
+    }
+
+    restore(cps.front());
+    return true;
+}
+
+void Replayer::restore(const Checkpoint& c) {
+    eng.p = c.p;
+    eng.s = c.s;
+    eng.integrator = c.integrator;
+    eng.trig = c.trig;
+    eng.linear_tol = c.linear_tol;
+    step_dt = c.dt;
+    t = c.time;
+    cur = c.step;
+    next = c.event;
+}
+
+std::uint64_t Replayer::advance(std::uint64_t n) {
+    std::uint64_t done = 0;
+    while (done < n && cur < total) {
+        bool drag = false;
+        double d[3] = {};
+        for (; next < ev.size() && ev[next].step == cur; ++next) {
+            const double* v = ev[next].v;
+            switch (ev[next].kind) {
+                case ReplayRecord::SetState:  eng.s = State{ v[0], v[1], v[2], v[3] }; break;
+                case ReplayRecord::SetParams: eng.p = Params{ v[0], v[1], v[2], v[3], v[4], v[5] }; break;
+                case ReplayRecord::SetDt:     step_dt = v[0]; break;
+                case ReplayRecord::SetConfig:
+                    eng.integrator = static_cast<Integrator>(int(v[0]));
+                    eng.trig = static_cast<TrigMode>(int(v[1]));
+                    eng.linear_tol = v[2];
+                    break;
+                case ReplayRecord::DragP1:
+                    drag = true;
+                    std::copy(v, v + 3, d);
+                    break;
+                case ReplayRecord::Checkpoint:
+                case ReplayRecord::End:
+                    break;
+            }
+        }
+
+        if (drag) eng.step_drag_p1(step_dt, d[0], d[1], d[2]);
+        else eng.step(step_dt);
+
+        t += std::clamp(step_dt, 0.0, 1.0 / 15.0);
+        ++cur;
+        ++done;
+    }
+    return done;
+}
+
+void Replayer::seek(std::uint64_t k) {
+    k = std::min(k, total);
+    // nearest checkpoint at or before k; keep going from here if that is closer
+    auto it = std::upper_bound(cps.begin(), cps.end(), k,
+                               [](std::uint64_t s, const Checkpoint& c) { return s < c.step; });
+    const Checkpoint& c = *std::prev(it);
+    if (k < cur || c.step > cur) restore(c);
+    advance(k - cur);
+}
+
+bool Replayer::verify(std::uint64_t& bad_step) {
+    restore(cps.front());
+    for (std::size_t i = 1; i < cps.size(); ++i) {
+        advance(cps[i].step - cur);
+        if (!same_bits(eng.s, cps[i].s)) {
+            bad_step = cps[i].step;
+            return false;
+        }
+    }
+    advance(total - cur);
+    return true;
+}
+
+} // namespace ds
@@ -0,0 +1,111 @@
+#include <doubleswing/stats.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ds {
+
+namespace {
+
+struct Registry {
+    std::mutex m;
+    std::vector<detail::StatsBlock*> live;
+    EngineStats retired;   // folded in from exited threads
+    EngineStats baseline;  // totals at the last reset
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+std::atomic<TraceHook> g_hook{nullptr};
+std::atomic<void*> g_hook_user{nullptr};
+
+void accumulate(EngineStats& s, const detail::StatsBlock& b) {
+    auto c = [&](Counter k) { return b.counts[int(k)].load(std::memory_order_relaxed); };
+    s.steps            += c(Counter::Steps);
+    s.drag_steps       += c(Counter::DragSteps);
+    s.dt_clamps        += c(Counter::DtClamps);
+    s.accel_calls      += c(Counter::AccelCalls);
+    s.denom_clamps     += c(Counter::DenomClamps);
+    s.drag_updates     += c(Counter::DragUpdates);
+    s.drag_saturations += c(Counter::DragSaturations);
+    s.drift_energy     += b.drift_energy.load(std::memory_order_relaxed);
+    s.drift_time       += b.drift_time.load(std::memory_order_relaxed);
+}
+
+EngineStats totals(Registry& r) {
+    EngineStats s = r.retired;
+    for (const detail::StatsBlock* b : r.live) accumulate(s, *b);
+    return s;
+}
+
+// Owns the calling thread's block; on thread exit its counts move to Registry::retired.
+struct ThreadBlock {
+    std::unique_ptr<detail::StatsBlock> block;
+
+    ~ThreadBlock() {
+        if (!block) return;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.m);
+        accumulate(r.retired, *block);
+        r.live.erase(std::remove(r.live.begin(), r.live.end(), block.get()), r.live.end());
+        detail::tls_stats = nullptr;
+    }
+};
+
+thread_local ThreadBlock t_block;
+
+} // namespace
+
+namespace detail {
+
+StatsBlock* register_stats_thread() {
+    Registry& r = registry();
+    t_block.block = std::make_unique<StatsBlock>();
+    std::lock_guard<std::mutex> lk(r.m);
+    r.live.push_back(t_block.block.get());
+    return t_block.block.get();
+}
+
+void fire_trace(TracePoint point, double value) {
+    if (const TraceHook hook = g_hook.load(std::memory_order_acquire))
+        hook(point, value, g_hook_user.load(std::memory_order_relaxed));
+}
+
+} // namespace detail
+
+EngineStats engine_stats() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    const EngineStats t = totals(r);
+    const EngineStats& b = r.baseline;
+
+    EngineStats s;
+    s.steps            = t.steps - b.steps;
+    s.drag_steps       = t.drag_steps - b.drag_steps;
+    s.dt_clamps        = t.dt_clamps - b.dt_clamps;
+    s.accel_calls      = t.accel_calls - b.accel_calls;
+    s.denom_clamps     = t.denom_clamps - b.denom_clamps;
+    s.drag_updates     = t.drag_updates - b.drag_updates;
+    s.drag_saturations = t.drag_saturations - b.drag_saturations;
+    s.drift_energy     = t.drift_energy - b.drift_energy;
+    s.drift_time       = t.drift_time - b.drift_time;
+    return s;
+}
+
+void reset_engine_stats() {
+    // counters belong to their threads, so a reset moves the baseline instead
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    r.baseline = totals(r);
+}
+
+void set_trace_hook(TraceHook hook, void* user) {
+    g_hook_user.store(user, std::memory_order_relaxed);
+    g_hook.store(hook, std::memory_order_release);
+}
+
+} // namespace ds
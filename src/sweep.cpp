@@ -0,0 +1,97 @@
+#include <doubleswing/sweep.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ds {
+
+std::size_t sweep_size(const SweepConfig& cfg) {
+    std::size_t n = 1;
+    for (const SweepAxis* a : { &cfg.l1, &cfg.l2, &cfg.m1, &cfg.m2, &cfg.g, &cfg.damping })
+        n *= std::max<std::size_t>(a->n, 1);
+    return n;
+}
+
+Params sweep_params(const SweepConfig& cfg, std::size_t index) {
+    double v[6];
+    const SweepAxis* axes[6] = { &cfg.l1, &cfg.l2, &cfg.m1, &cfg.m2, &cfg.g, &cfg.damping };
+    for (int i = 0; i < 6; ++i) {
+        const std::size_t n = std::max<std::size_t>(axes[i]->n, 1);
+        v[i] = axes[i]->at(index % n);
+        index /= n;
+    }
+    return Params{ v[0], v[1], v[2], v[3], v[4], v[5] };
+}
+
+SweepPoint sweep_point(const SweepConfig& cfg, std::size_t index) {
+    SweepPoint r;
+    r.index = index;
+    r.p = sweep_params(cfg, index);
+
+    Engine e(r.p, cfg.s0);
+    e.integrator = cfg.integrator;
+    e.trig = cfg.trig;
+
+    const double dt = std::clamp(cfg.dt, 0.0, 1.0 / 15.0);
+    // no steps for a NaN or negative horizon, or one whose step count is past uint64_t
+    const double n = dt > 0.0 ? std::ceil(cfg.t_max / dt) : 0.0;
+    const auto steps = n >= 0.0 && n < 1e18 ? static_cast<std::uint64_t>(n) : 0;
+    const bool damped = r.p.damping > 0.0;
+
+    const double e0 = e.energy_breakdown().total();
+    const double scale = e0 > 0.0 ? e0 : 1.0;
+    double e_low = e0;
+    double en = e0;
+    r.max_w = std::max(std::abs(e.s.w1), std::abs(e.s.w2));
+
+    for (std::uint64_t k = 1; k <= steps; ++k) {
+        const double prev1 = e.s.th1, prev2 = e.s.th2;
+        e.step(dt);
+
+        const double w = std::max(std::abs(e.s.w1), std::abs(e.s.w2));
+        if (!(w <= cfg.w_limit) || !std::isfinite(e.s.th1) || !std::isfinite(e.s.th2)) {
+            r.diverged = true;
+            r.max_w = std::isfinite(w) ? std::max(r.max_w, w) : HUGE_VAL;
+            break;
+        }
+        r.max_w = std::max(r.max_w, w);
+
+        // angles are kept in [-pi, pi], so passing over the top shows up as a wrap
+        if (r.flip_time < 0.0 && (std::abs(e.s.th1 - prev1) > PI || std::abs(e.s.th2 - prev2) > PI))
+            r.flip_time = double(k) * dt;
+
+        en = e.energy_breakdown().total();
+        if (damped) {
+            e_low = std::min(e_low, en);
+            r.energy_drift = std::max(r.energy_drift, (en - e_low) / scale);
+        } else {
+            r.energy_drift = std::max(r.energy_drift, std::abs(en - e0) / scale);
+        }
+    }
+
+    r.energy_ratio = e0 > 0.0 ? en / e0 : 1.0;
+    return r;
+}
+
+std::size_t sweep(const SweepConfig& cfg, const SweepSink& sink, const SweepProgress& progress) {
+    const std::size_t total = sweep_size(cfg);
+    const std::size_t chunk = std::max<std::size_t>(cfg.chunk, 1);
+    std::vector<SweepPoint> buf(std::min(chunk, total));
+
+    ThreadPool pool(cfg.threads);
+    std::size_t done = 0;
+    while (done < total) {
+        const std::size_t n = std::min(chunk, total - done);
+        pool.parallel_for(n, [&](std::size_t i, unsigned) { buf[i] = sweep_point(cfg, done + i); });
+
+        if (sink && !sink(buf.data(), n)) break;
+        done += n;
+        if (progress) progress(done, total);
+    }
+    return done;
+}
+
+} // namespace ds
@@ -0,0 +1,174 @@
+#include <doubleswing/taylor.hpp>
+#include <doubleswing/util.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ds {
+
+namespace {
+
+constexpr int N = TAYLOR_MAX_ORDER + 1;
+
+// coefficient k of u * v
+template <class Real>
+Real mul(const Real* u, const Real* v, int k) {
+    Real r = Real(0);
+    for (int j = 0; j <= k; ++j) r += u[j] * v[k - j];
+    return r;
+}
+
+// coefficient k of sin(u) and cos(u), from s' = u' c, c' = -u' s
+template <class Real>
+void sincos(const Real* u, Real* s, Real* c, int k) {
+    if (k == 0) {
+        s[0] = std::sin(u[0]);
+        c[0] = std::cos(u[0]);
+        return;
+    }
+    Real ss = Real(0), cs = Real(0);
+    for (int j = 1; j <= k; ++j) {
+        ss += Real(j) * u[j] * c[k - j];
+        cs += Real(j) * u[j] * s[k - j];
+    }
+    s[k] =  ss / Real(k);
+    c[k] = -cs / Real(k);
+}
+
+// coefficient k of q = num / den, given q's lower coefficients
+template <class Real>
+Real div(Real num_k, const Real* den, const Real* q, int k) {
+    Real r = num_k;
+    for (int j = 1; j <= k; ++j) r -= den[j] * q[k - j];
+    return r / den[0];
+}
+
+template <class Real>
+Real norm(const Real (&c)[4][N], int k) {
+    return std::max({ std::abs(c[0][k]), std::abs(c[1][k]), std::abs(c[2][k]), std::abs(c[3][k]) });
+}
+
+template <class Real>
+Real horner(const Real* c, int n, Real s) {
+    Real r = c[n];
+    for (int k = n - 1; k >= 0; --k) r = r * s + c[k];
+    return r;
+}
+
+} // namespace
+
+template <class Real>
+TaylorOf<Real>::TaylorOf(const Params& params, const State& s0, const TaylorConfig& cfg)
+    : p(params_as<Real>(params)) {
+    tol = cfg.tol > 0.0 ? Real(cfg.tol) : std::numeric_limits<Real>::epsilon();
+    // Jorba & Zou: order ~ -ln(tol) / 2 + 1 balances the per-step work against the step size
+    n = cfg.order > 0 ? cfg.order : int(std::ceil(-0.5 * std::log(double(tol)))) + 1;
+    n = std::clamp(n, 10, TAYLOR_MAX_ORDER);
+    h_max = Real(cfg.h_max);
+    reset(s0);
+}
+
+template <class Real>
+void TaylorOf<Real>::reset(const State& s, Real t0) {
+    const state_type x = state_as<Real>(s);
+    t = t0;
+    last_h = Real(0);
+    y[0] = normalize_angle(x.th1); y[1] = x.w1;
+    y[2] = normalize_angle(x.th2); y[3] = x.w2;
+}
+
+// Series of (th1, w1, th2, w2) about y, to order n, into coef. Same equations as
+// detail::accel's identities branch:
+//   a1 = (-g (2 m1 + m2) sin th1 - m2 g sin(th1 - 2 th2) - 2 m2 sin d (l2 w2^2 + l1 w1^2 cos d)) / (l1 D)
+//   a2 = 2 sin d (l1 (m1 + m2) w1^2 + g (m1 + m2) cos th1 + l2 m2 w2^2 cos d) / (l2 D)
+//   D = 2 m1 + 2 m2 sin^2 d,  d = th1 - th2,  minus damping * w.
+template <class Real>
+void TaylorOf<Real>::coefficients() {
+    Real* th1 = coef[0];
+    Real* w1  = coef[1];
+    Real* th2 = coef[2];
+    Real* w2  = coef[3];
+
+    // intermediate series
+    Real d[N], e[N], s1[N], c1[N], sd[N], cd[N], se[N], ce[N];
+    Real w1sq[N], w2sq[N], den[N], q1[N], q2[N], a1[N], a2[N];
+
+    const Real m1 = p.m1, m2 = p.m2, l1 = p.l1, l2 = p.l2, g = p.g, damping = p.damping;
+    const Real m12 = m1 + m2;
+
+    for (int i = 0; i < 4; ++i) coef[i][0] = y[i];
+
+    for (int k = 0; k < n; ++k) {
+        d[k] = th1[k] - th2[k];
+        e[k] = d[k] - th2[k]; // th1 - 2 th2
+        sincos(th1, s1, c1, k);
+        sincos(d, sd, cd, k);
+        sincos(e, se, ce, k);
+
+        w1sq[k] = mul(w1, w1, k);
+        w2sq[k] = mul(w2, w2, k);
+        den[k] = Real(2) * m2 * mul(sd, sd, k) + (k == 0 ? Real(2) * m1 : Real(0));
+
+        q1[k] = l2 * w2sq[k] + l1 * mul(w1sq, cd, k);
+        q2[k] = l1 * m12 * w1sq[k] + g * m12 * c1[k] + l2 * m2 * mul(w2sq, cd, k);
+
+        const Real n1 = -g * (Real(2) * m1 + m2) * s1[k] - m2 * g * se[k] - Real(2) * m2 * mul(sd, q1, k);
+        const Real n2 = Real(2) * mul(sd, q2, k);
+
+        a1[k] = div(n1 / l1, den, a1, k);
+        a2[k] = div(n2 / l2, den, a2, k);
+
+        const Real inv = Real(1) / Real(k + 1);
+        th1[k + 1] = w1[k] * inv;
+        th2[k + 1] = w2[k] * inv;
+        w1[k + 1] = (a1[k] - damping * w1[k]) * inv;
+        w2[k + 1] = (a2[k] - damping * w2[k]) * inv;
+    }
+}
+
+template <class Real>
+Real TaylorOf<Real>::step() {
+    coefficients();
+
+    // largest h with the last two terms at tol (relative to the state's size):
+    // the series converges like (h / rho)^k, so the truncated tail is about that big
+    const Real scale = tol * std::max(Real(1), norm(coef, 0));
+    Real h = h_max;
+    for (const int k : { n - 1, n }) {
+        const Real c = norm(coef, k);
+        if (c > Real(0)) h = std::min(h, std::pow(scale / c, Real(1) / Real(k)));
+    }
+
+    for (int i = 0; i < 4; ++i) y[i] = horner(coef[i], n, h);
+    y[0] = normalize_angle(y[0]);
+    y[2] = normalize_angle(y[2]);
+
+    t += h;
+    last_h = h;
+    ++steps;
+    return h;
+}
+
+template <class Real>
+typename TaylorOf<Real>::state_type TaylorOf<Real>::interpolate(Real t_out) const {
+    if (last_h <= Real(0)) return state();
+    const Real s = t_out - (t - last_h);
+    return state_type{ normalize_angle(horner(coef[0], n, s)), horner(coef[1], n, s),
+                       normalize_angle(horner(coef[2], n, s)), horner(coef[3], n, s) };
+}
+
+template <class Real>
+typename TaylorOf<Real>::state_type TaylorOf<Real>::advance_to(Real t_out) {
+    while (t < t_out) step();
+    return interpolate(t_out);
+}
+
+template <class Real>
+typename TaylorOf<Real>::state_type TaylorOf<Real>::state() const {
+    return state_type{ y[0], y[1], y[2], y[3] };
+}
+
+template class TaylorOf<double>;
+template class TaylorOf<long double>;
+
+} // namespace ds
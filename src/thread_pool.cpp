@@ -0,0 +1,100 @@
+#include <doubleswing/thread_pool.hpp>
+#include <algorithm>
+
+namespace ds {
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    slices = std::make_unique<Slice[]>(threads);
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back([this, i] { worker_loop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        stop = true;
+    }
+    cv_start.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t, unsigned)>& fn) {
+    if (count == 0) return;
+
+    std::lock_guard<std::mutex> run_lk(run_m);
+
+    // contiguous starting slices, one per worker
+    const std::size_t n = workers.size();
+    for (std::size_t w = 0; w < n; ++w) {
+        std::lock_guard<std::mutex> lk(slices[w].m);
+        slices[w].begin = count * w / n;
+        slices[w].end   = count * (w + 1) / n;
+    }
+
+    std::unique_lock<std::mutex> lk(m);
+    job = &fn;
+    running = static_cast<unsigned>(n);
+    ++generation;
+    cv_start.notify_all();
+    cv_done.wait(lk, [this] { return running == 0; });
+    job = nullptr;
+}
+
+bool ThreadPool::next_task(unsigned id, std::size_t& task) {
+    Slice& own = slices[id];
+    {
+        std::lock_guard<std::mutex> lk(own.m);
+        if (own.begin < own.end) {
+            task = own.begin++;
+            return true;
+        }
+    }
+
+    // own slice is empty: steal the back half of someone else's
+    const unsigned n = size();
+    for (unsigned k = 1; k < n; ++k) {
+        Slice& victim = slices[(id + k) % n];
+        std::size_t b, e;
+        {
+            std::lock_guard<std::mutex> lk(victim.m);
+            const std::size_t left = victim.end - victim.begin;
+            if (victim.begin >= victim.end) continue;
+            b = victim.begin + left / 2;
+            e = victim.end;
+            victim.end = b;
+        }
+        task = b;
+        if (b + 1 < e) {
+            std::lock_guard<std::mutex> lk(own.m);
+            own.begin = b + 1;
+            own.end = e;
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(unsigned id) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        const std::function<void(std::size_t, unsigned)>* fn;
+        {
+            std::unique_lock<std::mutex> lk(m);
+            cv_start.wait(lk, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+            fn = job;
+        }
+
+        std::size_t task;
+        while (next_task(id, task)) (*fn)(task, id);
+
+        std::lock_guard<std::mutex> lk(m);
+        if (--running == 0) cv_done.notify_one();
+    }
+}
+
+} // namespace ds
@@ -0,0 +1,388 @@
+#include <doubleswing/trajectory.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define DS_TRAJ_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ds {
+
+// Raw chunks are the in-memory States; the format assumes a little-endian host.
+static_assert(sizeof(State) == 4 * sizeof(double), "State must be four packed doubles");
+
+namespace {
+
+constexpr char MAGIC[8] = { 'D', 'S', 'T', 'R', 'J', '0', '0', '1' };
+constexpr std::size_t HEADER = 128;
+
+void put_u32(std::uint8_t* o, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) o[i] = std::uint8_t(v >> (8 * i));
+}
+
+void put_u64(std::uint8_t* o, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) o[i] = std::uint8_t(v >> (8 * i));
+}
+
+void put_f64(std::uint8_t* o, double v) {
+    std::uint64_t u;
+    std::memcpy(&u, &v, 8);
+    put_u64(o, u);
+}
+
+std::uint32_t get_u32(const std::uint8_t* b) {
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= std::uint32_t(b[i]) << (8 * i);
+    return v;
+}
+
+std::uint64_t get_u64(const std::uint8_t* b) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= std::uint64_t(b[i]) << (8 * i);
+    return v;
+}
+
+double get_f64(const std::uint8_t* b) {
+    const std::uint64_t u = get_u64(b);
+    double v;
+    std::memcpy(&v, &u, 8);
+    return v;
+}
+
+// round to the quantum grid; non-finite and out-of-range values saturate
+std::uint64_t quantize(double x, double q) {
+    const double r = std::nearbyint(x / q);
+    if (!(r == r)) return 0;
+    const double lim = 4.0e18;
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(std::clamp(r, -lim, lim)));
+}
+
+double dequantize(std::uint64_t v, double q) {
+    return double(static_cast<std::int64_t>(v)) * q;
+}
+
+// residuals use wrapping unsigned arithmetic, so encode/decode is exact for any input
+void put_varint(std::vector<std::uint8_t>& o, std::uint64_t v) {
+    v = (v << 1) ^ (0 - (v >> 63)); // zigzag
+    while (v >= 0x80) {
+        o.push_back(std::uint8_t(v | 0x80));
+        v >>= 7;
+    }
+    o.push_back(std::uint8_t(v));
+}
+
+bool get_varint(const std::uint8_t*& b, const std::uint8_t* end, std::uint64_t& v) {
+    std::uint64_t z = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (b == end) return false;
+        const std::uint8_t c = *b++;
+        z |= std::uint64_t(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            v = (z >> 1) ^ (0 - (z & 1));
+            return true;
+        }
+    }
+    return false;
+}
+
+void fields(const State& s, double* x) {
+    x[0] = s.th1; x[1] = s.w1; x[2] = s.th2; x[3] = s.w2;
+}
+
+} // namespace
+
+// ---- writer ----
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+}
+
+bool TrajectoryWriter::open(const std::string& path, const Params& params, double t_start, double step,
+                            const TrajectoryOptions& options) {
+    close();
+    if (options.chunk_samples == 0 || !(step > 0.0)) return false;
+    if (options.encoding == TrajEncoding::Quantized &&
+        !(options.angle_quantum > 0.0 && options.rate_quantum > 0.0)) return false;
+
+    f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+
+    p = params;
+    t0 = t_start;
+    dt = step;
+    opt = options;
+    count = 0;
+    index.clear();
+    pending.clear();
+    pending.reserve(opt.chunk_samples);
+
+    // placeholder header, rewritten by close()
+    const std::uint8_t zero[HEADER] = {};
+    ok = std::fwrite(zero, 1, HEADER, f) == HEADER;
+    offset = HEADER;
+    return ok;
+}
+
+bool TrajectoryWriter::append(const State& s) {
+    if (!f || !ok) return false;
+    pending.push_back(s);
+    ++count;
+    if (pending.size() == opt.chunk_samples) return flush_chunk();
+    return true;
+}
+
+bool TrajectoryWriter::flush_chunk() {
+    if (pending.empty()) return ok;
+
+    const std::uint8_t* data;
+    std::size_t n;
+    if (opt.encoding == TrajEncoding::Raw) {
+        data = reinterpret_cast<const std::uint8_t*>(pending.data());
+        n = pending.size() * sizeof(State);
+    } else {
+        const double quantum[4] = { opt.angle_quantum, opt.rate_quantum, opt.angle_quantum, opt.rate_quantum };
+        buf.assign(32, 0);
+        std::uint64_t prev[4] = {}, prev2[4] = {};
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            double x[4];
+            fields(pending[i], x);
+            for (int k = 0; k < 4; ++k) {
+                const std::uint64_t q = quantize(x[k], quantum[k]);
+                if (i == 0)      put_u64(buf.data() + 8 * k, q);
+                else if (i == 1) put_varint(buf, q - prev[k]);
+                else             put_varint(buf, q - (2 * prev[k] - prev2[k]));
+                prev2[k] = prev[k];
+                prev[k] = q;
+            }
+        }
+        buf.resize((buf.size() + 7) & ~std::size_t(7), 0);
+        data = buf.data();
+        n = buf.size();
+    }
+
+    index.push_back(offset);
+    if (std::fwrite(data, 1, n, f) != n) ok = false;
+    offset += n;
+    pending.clear();
+    return ok;
+}
+
+bool TrajectoryWriter::close() {
+    if (!f) return false;
+
+    flush_chunk();
+    index.push_back(offset); // end of the last chunk = start of the index
+
+    std::vector<std::uint8_t> tail(index.size() * 8);
+    for (std::size_t i = 0; i < index.size(); ++i) put_u64(tail.data() + 8 * i, index[i]);
+    if (std::fwrite(tail.data(), 1, tail.size(), f) != tail.size()) ok = false;
+
+    std::uint8_t h[HEADER] = {};
+    std::memcpy(h, MAGIC, 8);
+    put_u32(h + 8, static_cast<std::uint32_t>(opt.encoding));
+    put_u32(h + 12, opt.chunk_samples);
+    put_f64(h + 16, p.l1);
+    put_f64(h + 24, p.l2);
+    put_f64(h + 32, p.m1);
+    put_f64(h + 40, p.m2);
+    put_f64(h + 48, p.g);
+    put_f64(h + 56, p.damping);
+    put_f64(h + 64, t0);
+    put_f64(h + 72, dt);
+    put_f64(h + 80, opt.angle_quantum);
+    put_f64(h + 88, opt.rate_quantum);
+    put_u64(h + 96, count);
+    put_u64(h + 104, index.size() - 1);
+    put_u64(h + 112, offset);
+    if (std::fseek(f, 0, SEEK_SET) != 0 || std::fwrite(h, 1, HEADER, f) != HEADER) ok = false;
+
+    if (std::fclose(f) != 0) ok = false;
+    f = nullptr;
+    return ok;
+}
+
+// ---- reader ----
+
+TrajectoryReader::~TrajectoryReader() {
+    close();
+}
+
+void TrajectoryReader::close() {
+#if defined(DS_TRAJ_MMAP)
+    if (mapped && base) munmap(const_cast<std::uint8_t*>(base), bytes);
+#endif
+    base = nullptr;
+    bytes = 0;
+    mapped = false;
+    owned.clear();
+    owned.shrink_to_fit();
+    index = nullptr;
+    count = chunks = per_chunk = 0;
+    cache.clear();
+    cached = SIZE_MAX;
+}
+
+bool TrajectoryReader::open(const std::string& path) {
+    close();
+
+#if defined(DS_TRAJ_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* m = mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED) {
+            base = static_cast<const std::uint8_t*>(m);
+            bytes = std::size_t(st.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    if (!mapped) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        std::uint8_t tmp[1 << 16];
+        std::size_t n;
+        while ((n = std::fread(tmp, 1, sizeof tmp, file)) > 0) owned.insert(owned.end(), tmp, tmp + n);
+        std::fclose(file);
+        base = owned.data();
+        bytes = owned.size();
+    }
+
+    const auto fail = [this] { close(); return false; };
+    if (bytes < HEADER || std::memcmp(base, MAGIC, 8) != 0) return fail();
+
+    const std::uint32_t e = get_u32(base + 8);
+    if (e > static_cast<std::uint32_t>(TrajEncoding::Quantized)) return fail();
+    enc = static_cast<TrajEncoding>(e);
+    per_chunk = get_u32(base + 12);
+    p.l1 = get_f64(base + 16);
+    p.l2 = get_f64(base + 24);
+    p.m1 = get_f64(base + 32);
+    p.m2 = get_f64(base + 40);
+    p.g = get_f64(base + 48);
+    p.damping = get_f64(base + 56);
+    start = get_f64(base + 64);
+    step = get_f64(base + 72);
+    qa = get_f64(base + 80);
+    qr = get_f64(base + 88);
+    const std::uint64_t n_samples = get_u64(base + 96);
+    const std::uint64_t n_chunks = get_u64(base + 104);
+    const std::uint64_t index_off = get_u64(base + 112);
+
+    if (per_chunk == 0 || !(step > 0.0)) return fail();
+    if (n_chunks != (n_samples + per_chunk - 1) / per_chunk) return fail();
+    if (index_off < HEADER || index_off > bytes || (bytes - index_off) / 8 < n_chunks + 1) return fail();
+
+    count = std::size_t(n_samples);
+    chunks = std::size_t(n_chunks);
+    index = base + index_off;
+
+    // offsets must be increasing, in bounds and aligned; Raw chunks must be exactly
+    // contiguous so all() can view the whole series
+    std::uint64_t prev = HEADER;
+    for (std::size_t c = 0; c <= chunks; ++c) {
+        const std::uint64_t off = chunk_offset(c);
+        if (off < prev || off > index_off || off % 8 != 0) return fail();
+        if (c > 0 && enc == TrajEncoding::Raw && off - prev != chunk_size(c - 1) * sizeof(State)) return fail();
+        if (c > 0 && enc == TrajEncoding::Quantized && off - prev < 32) return fail();
+        prev = off;
+    }
+    if (chunk_offset(0) != HEADER || chunk_offset(chunks) != index_off) return fail();
+
+    return true;
+}
+
+std::uint64_t TrajectoryReader::chunk_offset(std::size_t c) const {
+    return get_u64(index + 8 * c);
+}
+
+std::size_t TrajectoryReader::chunk_size(std::size_t c) const {
+    return std::min(per_chunk, count - c * per_chunk);
+}
+
+std::size_t TrajectoryReader::index_at(double t) const {
+    if (count == 0) return 0;
+    const double k = std::floor((t - start) / step);
+    if (!(k > 0.0)) return 0;
+    if (k >= double(count - 1)) return count - 1;
+    return std::size_t(k);
+}
+
+StateSpan TrajectoryReader::all() const {
+    if (enc != TrajEncoding::Raw || !base) return {};
+    return { reinterpret_cast<const State*>(base + HEADER), count };
+}
+
+bool TrajectoryReader::decode(std::size_t c) const {
+    if (cached == c) return true;
+    cached = SIZE_MAX;
+
+    const std::uint8_t* b = base + chunk_offset(c);
+    const std::uint8_t* end = base + chunk_offset(c + 1);
+    const std::size_t n = chunk_size(c);
+    const double quantum[4] = { qa, qr, qa, qr };
+
+    cache.resize(n);
+    std::uint64_t prev[4] = {}, prev2[4] = {};
+    for (std::size_t i = 0; i < n; ++i) {
+        double x[4];
+        for (int k = 0; k < 4; ++k) {
+            std::uint64_t q;
+            if (i == 0) {
+                q = get_u64(b + 8 * k);
+            } else {
+                std::uint64_t r;
+                if (!get_varint(b, end, r)) return false;
+                q = i == 1 ? prev[k] + r : 2 * prev[k] - prev2[k] + r;
+            }
+            prev2[k] = prev[k];
+            prev[k] = q;
+            x[k] = dequantize(q, quantum[k]);
+        }
+        if (i == 0) b += 32;
+        cache[i] = State{ x[0], x[1], x[2], x[3] };
+    }
+
+    cached = c;
+    return true;
+}
+
+StateSpan TrajectoryReader::chunk(std::size_t c) const {
+    if (c >= chunks) return {};
+    if (enc == TrajEncoding::Raw)
+        return { reinterpret_cast<const State*>(base + chunk_offset(c)), chunk_size(c) };
+    if (!decode(c)) return {};
+    return { cache.data(), cache.size() };
+}
+
+State TrajectoryReader::at(std::size_t i) const {
+    if (i >= count) return State{};
+    const StateSpan s = chunk(i / per_chunk);
+    const std::size_t k = i % per_chunk;
+    return k < s.size ? s[k] : State{};
+}
+
+bool TrajectoryReader::read(std::size_t first, std::size_t n, State* out) const {
+    if (first > count || n > count - first) return false;
+    while (n > 0) {
+        const std::size_t c = first / per_chunk, k = first % per_chunk;
+        const StateSpan s = chunk(c);
+        if (s.size != chunk_size(c)) return false;
+        const std::size_t m = std::min(n, s.size - k);
+        std::copy(s.data + k, s.data + k + m, out);
+        out += m;
+        first += m;
+        n -= m;
+    }
+    return true;
+}
+
+} // namespace ds
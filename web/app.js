@@ -3,6 +3,7 @@ console.log("init: app.js");
 import { loadSprite } from "./gfx/sprites.js";
 import { setupCanvasResize } from "./gfx/viewport.js";
 import { initEngine } from "./engine/wasm.js";
+import { initWorkerEngine } from "./engine/worker_engine.js";
 import { makeParams, syncEngineParams } from "./engine/params.js";
 import { getUIElements, getStatusEl, getEnergyBarEls, setStatus } from "./ui/elements.js";
 import { initThemeToggle } from "./ui/themeToggle.js";
@@ -11,7 +12,6 @@ import { makeReadoutUpdater } from "./ui/readout.js";
 import { makeEnergyBarUpdater } from "./ui/energybar.js";
 import { createDragController } from "./input/drag.js";
 import { makeDrawer } from "./gfx/draw.js";
-import { thetaFromMouse } from "./utils/math.js";
 import { initInfoModal } from "./ui/infoModal.js";
 
 // DOM
@@ -31,9 +31,10 @@ const bob1Sprite = loadSprite("./assets/bob1.png");
 const bob2Sprite = loadSprite("./assets/bob2.png");
 const sprites = { bob1: bob1Sprite, bob2: bob2Sprite };
 
-// params + engine
+// params + engine: physics in a worker when SharedArrayBuffer is available
+// (cross-origin isolated page), otherwise stepped here once per frame
 const params = makeParams();
-const engine = await initEngine(params);
+const engine = (await initWorkerEngine(params)) ?? (await initEngine(params));
 
 // UI
 const ui = getUIElements();
@@ -45,19 +46,12 @@ setInputsFromParams(ui, params);
 // ensure engine params match
 syncEngineParams(engine, params);
 
-// timing/filters
+// timing (the fixed-step loop and its accumulator live in WASM, ds_advance)
 let last = performance.now();
-let acc = 0.0;
 
-const FIXED_DT = 1 / 240;
-const MAX_FRAME = 1 / 15;
-const MAX_STEPS = 8;
-
-
-
-function resetFiltersAndTiming(dragController) {
-    dragController.resetFilter();
-    acc = 0.0; // prevents burst of steps after UI changes
+// drops accumulated time (no burst of steps after UI changes) and the drag history
+function resetFiltersAndTiming() {
+    engine.resetFrame();
 }
 
 let isInfoOpen = () => false;
@@ -70,7 +64,7 @@ const drag = createDragController({
 
 function resyncClock() {
     last = performance.now();
-    acc = 0.0;
+    engine.resetFrame();
 }
 
 const infoModal = initInfoModal({
@@ -81,9 +75,8 @@ const infoModal = initInfoModal({
     onToggle: () => {
         // forgive UI-induced frame hitch
         resyncClock();
-        // prevent stuck drag / omega filter weirdness
+        // prevent stuck drag
         drag?.cancelDrag?.();
-        drag?.resetFilter?.();
     }
 });
 
@@ -96,7 +89,7 @@ bindUIControls({
     params,
     engine,
     syncEngineParams,
-    resetFiltersAndTiming: () => resetFiltersAndTiming(drag),
+    resetFiltersAndTiming,
     getDragging: drag.getDragging,
 });
 
@@ -104,30 +97,23 @@ bindUIControls({
 addEventListener("keydown", (e) => {
     if (e.key === "r" || e.key === "R") {
         engine.ds_reset(engine.h, params.th1, params.w1, params.th2, params.w2);
-        resetFiltersAndTiming(drag);
+        resetFiltersAndTiming();
         setStatus(statusEl, "Reset animation.", "ok");
     }
 });
 
 // readout + energy bar
-const updateReadout = makeReadoutUpdater({ ui, params, engine, getDragging: drag.getDragging });
-const updateEnergyBar = makeEnergyBarUpdater({ engine, els: energyEls });
+const updateReadout = makeReadoutUpdater({ ui, params, getDragging: drag.getDragging, getStats: engine.stats });
+const updateEnergyBar = makeEnergyBarUpdater({ els: energyEls });
 
 // draw
-const draw = makeDrawer({ ctx, viewW, viewH, params, engine, sprites });
+const draw = makeDrawer({ ctx, viewW, viewH, params, sprites });
 
 // animation
 function frame(t) {
-    let frameDt = (t - last) / 1000;
+    const frameDt = (t - last) / 1000;
     last = t;
 
-    frameDt = Math.min(frameDt, MAX_FRAME);
-    acc += frameDt;
-    acc = Math.min(acc, MAX_STEPS * FIXED_DT); // prevent "catch-up bursts" after closing info window
-
-    const mp = drag.getLastPointerPos();
-    const dragging = drag.getDragging();
-
     const ox = viewW() * 0.5;
     const oy = viewH() * 0.5;
 
@@ -135,50 +121,21 @@ function frame(t) {
     const usable = Math.min(viewW(), viewH()) - margin * 2;
     const ppm = (usable * 0.5) / (params.l1 + params.l2);
 
-    // needed for bob2 dragging
-    let p1px = null;
-    if (dragging === 2 && mp) {
-        engine.ds_update_positions(engine.h);
-        const x1 = engine.ds_x1(),
-            y1 = engine.ds_y1();
-        p1px = { x: ox + x1 * ppm, y: oy + y1 * ppm };
-    }
-
-    let steps = 0;
-    while (acc >= FIXED_DT && steps < MAX_STEPS) {
-        if (dragging === 1 && mp) {
-            const dx = mp.x - ox;
-            const dy = mp.y - oy;
-            const th1 = thetaFromMouse(dx, dy);
-            let w1 = drag.updateFilteredOmega(th1, FIXED_DT);
-            if (Math.abs(w1) < 0.05) w1 = 0.0;
-            const a1 = 0.0;
-            engine.ds_step_drag_p1(engine.h, FIXED_DT, th1, w1, a1);
-        } else {
-            if (dragging === 2 && mp && p1px) {
-                const dx = mp.x - p1px.x;
-                const dy = mp.y - p1px.y;
-                const th2 = thetaFromMouse(dx, dy);
-                const w2 = drag.updateFilteredOmega(th2, FIXED_DT);
-                engine.ds_set_th2(engine.h, th2);
-                engine.ds_set_w2(engine.h, w2);
-            }
-            engine.ds_step(engine.h, FIXED_DT);
-        }
-
-        steps++;
-        acc -= FIXED_DT;
+    // every pointer sample since the last frame, each at its own event time
+    for (const s of drag.takeSamples()) {
+        engine.pointer(s.mode, (s.x - ox) / ppm, (s.y - oy) / ppm, s.t / 1000);
     }
 
-    engine.ds_update_positions(engine.h);
-    const x1 = engine.ds_x1(),
-        y1 = engine.ds_y1(),
-        x2 = engine.ds_x2(),
-        y2 = engine.ds_y2();
+    // worker: interpolated state out (frameDt is irrelevant, physics keeps its own
+    // clock); otherwise one WASM call that clamps dt, runs the fixed substeps up to now
+    // and fills the output view
+    const out = engine.render
+        ? engine.render()
+        : engine.advance(frameDt, performance.now() / 1000);
 
-    draw(x1, y1, x2, y2);
-    updateReadout();
-    updateEnergyBar();
+    draw(out);
+    updateReadout(out);
+    updateEnergyBar(out);
 
     requestAnimationFrame(frame);
 }
@@ -1,14 +1,56 @@
+#include <doubleswing/drag.hpp>
 #include <doubleswing/engine.hpp>
+#include <doubleswing/stats.hpp>
+#include <cmath>
+
+// Per-frame output written by ds_frame / ds_snapshot.
+// Keep in sync with FRAME in web/engine/layout.js.
+enum FrameOut {
+    OUT_X1, OUT_Y1, OUT_X2, OUT_Y2,
+    OUT_TH1, OUT_W1, OUT_TH2, OUT_W2,
+    OUT_KE, OUT_PE, OUT_E,
+    OUT_STEPS,
+    OUT_LEN
+};
+
+// Output of ds_stats (stats.hpp counters; all zero unless built with DOUBLESWING_STATS).
+// Keep in sync with STATS in web/engine/layout.js.
+enum StatsOut {
+    ST_ENABLED,
+    ST_STEPS, ST_DRAG_STEPS, ST_DT_CLAMPS,
+    ST_ACCEL_CALLS, ST_DENOM_CLAMPS,
+    ST_DRAG_UPDATES, ST_DRAG_SATURATIONS,
+    ST_DRIFT_PER_S,
+    ST_LEN
+};
+
+// fixed-step loop, same constants the JS loop used
+constexpr double FIXED_DT = 1.0 / 240.0;
+constexpr double MAX_FRAME = 1.0 / 15.0;
+constexpr int MAX_STEPS = 8;
+
+// drag estimator tuning (DragEstimator defaults otherwise; omega_max was OMEGA_MAX in
+// web/input/drag.js)
+constexpr double DRAG_OMEGA_MAX = 15.0;
+constexpr double DRAG_W1_DEADZONE = 0.05;
 
 extern "C" {
 
-    struct EngineHandle { ds::Engine eng; };
+    struct EngineHandle {
+        ds::Engine eng;
+        double acc = 0.0;
+        int drag_mode = 0;
+        ds::DragEstimator drag;
+        alignas(8) double out[OUT_LEN] = {};
+    };
 
     EngineHandle* ds_create(double l1, double l2, double m1, double m2, double g, double damping,
                             double th1, double w1, double th2, double w2) {
         ds::Params p{l1, l2, m1, m2, g, damping};
         ds::State  s{th1, w1, th2, w2};
-        return new EngineHandle{ ds::Engine(p, s) };
+        EngineHandle* h = new EngineHandle{ ds::Engine(p, s) };
+        h->drag.omega_max = DRAG_OMEGA_MAX;
+        return h;
     }
 
     void ds_destroy(EngineHandle* h) { delete h; }
@@ -56,4 +98,109 @@ extern "C" {
     double ds_ke(EngineHandle* h) { return h->eng.energy_breakdown().ke; }
     double ds_pe(EngineHandle* h) { return h->eng.energy_breakdown().pe; }
     double ds_energy(EngineHandle* h) { return h->eng.energy_breakdown().total();  }
+
+    // ---- one call per frame ----
+
+    // Heap address of the output array; JS wraps it once in a Float64Array.
+    double* ds_frame_buffer(EngineHandle* h) { return h->out; }
+
+    // Fill the output array from the current state without stepping.
+    void ds_snapshot(EngineHandle* h) {
+        double* o = h->out;
+        h->eng.bob_positions(o[OUT_X1], o[OUT_Y1], o[OUT_X2], o[OUT_Y2]);
+        o[OUT_TH1] = h->eng.s.th1; o[OUT_W1] = h->eng.s.w1;
+        o[OUT_TH2] = h->eng.s.th2; o[OUT_W2] = h->eng.s.w2;
+        const ds::EnergyBreakdown en = h->eng.energy_breakdown();
+        o[OUT_KE] = en.ke;
+        o[OUT_PE] = en.pe;
+        o[OUT_E]  = en.total();
+    }
+
+    // Drop accumulated time and the drag history (after UI changes or a hitch).
+    void ds_frame_reset(EngineHandle* h) {
+        h->acc = 0.0;
+        h->drag_mode = 0; // the next pointer sample starts a fresh grab
+    }
+
+    // One pointer sample taken at time t (seconds on the caller's clock, the same one
+    // ds_advance's `now` is on; samples in time order). drag_mode is 0 (none), 1 (bob 1)
+    // or 2 (bob 2); (mx, my) is the pointer relative to the pivot in metres, +y down.
+    // A new grab starts the estimator at rest at the current angle.
+    void ds_pointer(EngineHandle* h, int drag_mode, double mx, double my, double t) {
+        if (drag_mode != h->drag_mode) {
+            h->drag_mode = drag_mode;
+            if (drag_mode == 1) h->drag.reset(h->eng.s.th1, t);
+            if (drag_mode == 2) h->drag.reset(h->eng.s.th2, t);
+        }
+        if (drag_mode == 1) {
+            h->drag.update(std::atan2(mx, my), t);
+        } else if (drag_mode == 2) {
+            // bob 2 is dragged relative to where bob 1 is at the sample
+            double x1, y1, x2, y2;
+            h->eng.bob_positions(x1, y1, x2, y2);
+            h->drag.update(std::atan2(mx - x1, my - y1), t);
+        }
+    }
+
+    // Advance by frame_dt (clamped) in up to MAX_STEPS fixed substeps ending at `now`,
+    // then write the snapshot. Between pointer samples the dragged rod follows the
+    // estimator at each substep's start time, which also supplies bob 1's angular
+    // acceleration. Returns the number of substeps taken.
+    int ds_advance(EngineHandle* h, double frame_dt, double now) {
+        h->acc += std::fmin(std::fmax(frame_dt, 0.0), MAX_FRAME);
+        h->acc = std::fmin(h->acc, MAX_STEPS * FIXED_DT);
+
+        int steps = 0;
+        while (h->acc >= FIXED_DT && steps < MAX_STEPS) {
+            // acc is the time up to `now` not stepped yet, so this substep starts at
+            // now - acc
+            const double t = now - h->acc;
+            if (h->drag_mode == 1) {
+                ds::DragEstimate e = h->drag.at(t);
+                if (std::fabs(e.omega) < DRAG_W1_DEADZONE) e.omega = e.alpha = 0.0;
+                h->eng.step_drag_p1(FIXED_DT, e.theta, e.omega, e.alpha);
+            } else {
+                if (h->drag_mode == 2) {
+                    const ds::DragEstimate e = h->drag.at(t);
+                    h->eng.s.th2 = e.theta;
+                    h->eng.s.w2 = e.omega;
+                }
+                h->eng.step(FIXED_DT);
+            }
+            ++steps;
+            h->acc -= FIXED_DT;
+        }
+
+        ds_snapshot(h);
+        h->out[OUT_STEPS] = steps;
+        return steps;
+    }
+
+    // Advance by one rendered frame with the pointer as sampled at `now`
+    // (ds_pointer, then ds_advance).
+    int ds_frame(EngineHandle* h, double frame_dt, double now, int drag_mode, double mx, double my) {
+        ds_pointer(h, drag_mode, mx, my, now);
+        return ds_advance(h, frame_dt, now);
+    }
+
+    // ---- instrumentation ----
+
+    static double g_stats[ST_LEN];
+
+    // Refresh and return the stats array (module-wide, not per handle).
+    double* ds_stats() {
+        const ds::EngineStats st = ds::engine_stats();
+        g_stats[ST_ENABLED]          = ds::stats_enabled ? 1.0 : 0.0;
+        g_stats[ST_STEPS]            = double(st.steps);
+        g_stats[ST_DRAG_STEPS]       = double(st.drag_steps);
+        g_stats[ST_DT_CLAMPS]        = double(st.dt_clamps);
+        g_stats[ST_ACCEL_CALLS]      = double(st.accel_calls);
+        g_stats[ST_DENOM_CLAMPS]     = double(st.denom_clamps);
+        g_stats[ST_DRAG_UPDATES]     = double(st.drag_updates);
+        g_stats[ST_DRAG_SATURATIONS] = double(st.drag_saturations);
+        g_stats[ST_DRIFT_PER_S]      = st.drift_per_second();
+        return g_stats;
+    }
+
+    void ds_stats_reset() { ds::reset_engine_stats(); }
 }
@@ -0,0 +1,17 @@
+// Registers coi_sw.js (cross-origin isolation headers) and reloads once so this page
+// is served through it. A no-op where the page is already isolated (serve.py) or
+// service workers are unavailable (file://, plain http on another host).
+(() => {
+    if (window.crossOriginIsolated || !window.isSecureContext || !("serviceWorker" in navigator)) return;
+
+    const KEY = "coi_sw.reloaded"; // once per tab: a browser that stays unisolated must not loop
+    navigator.serviceWorker
+        .register(new URL("./coi_sw.js", document.currentScript.src))
+        .then(() => navigator.serviceWorker.ready)
+        .then(() => {
+            if (sessionStorage.getItem(KEY)) return;
+            sessionStorage.setItem(KEY, "1");
+            location.reload();
+        })
+        .catch((err) => console.warn(`coi_sw.js not registered (${err}); physics stays on the main thread`));
+})();
@@ -0,0 +1,29 @@
+// Service worker that adds the cross-origin isolation headers a static host such as
+// GitHub Pages cannot send. The physics worker (engine/worker_engine.js) and the
+// threaded ensemble module need SharedArrayBuffer, which only isolated pages get.
+// Registered by the pages themselves (index.html, ensemble.html); the first visit
+// reloads once so the page is served through it.
+//
+// Only same-origin responses are rewritten. COEP is "credentialless", so the
+// cross-origin fonts and scripts the page loads still work without CORP headers.
+// Browsers without credentialless COEP stay unisolated and use the main-thread loop.
+
+self.addEventListener("install", () => self.skipWaiting());
+self.addEventListener("activate", (e) => e.waitUntil(self.clients.claim()));
+
+self.addEventListener("fetch", (e) => {
+    const req = e.request;
+    if (new URL(req.url).origin !== self.location.origin) return;
+    if (req.cache === "only-if-cached" && req.mode !== "same-origin") return;
+
+    e.respondWith(
+        fetch(req).then((res) => {
+            if (res.status === 0) return res; // opaque: headers cannot be added
+            const headers = new Headers(res.headers);
+            headers.set("Cross-Origin-Opener-Policy", "same-origin");
+            headers.set("Cross-Origin-Embedder-Policy", "credentialless");
+            headers.set("Cross-Origin-Resource-Policy", "same-origin");
+            return new Response(res.body, { status: res.status, statusText: res.statusText, headers });
+        })
+    );
+});
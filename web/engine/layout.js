@@ -0,0 +1,20 @@
+console.log("init: engine/layout.js");
+
+// Layout of the per-frame output buffer (FrameOut in web/bindings.cpp).
+export const FRAME = {
+    X1: 0, Y1: 1, X2: 2, Y2: 3,
+    TH1: 4, W1: 5, TH2: 6, W2: 7,
+    KE: 8, PE: 9, E: 10,
+    STEPS: 11,
+    LEN: 12,
+};
+
+// Layout of the ds_stats array (StatsOut in web/bindings.cpp).
+export const STATS = {
+    ENABLED: 0,
+    STEPS: 1, DRAG_STEPS: 2, DT_CLAMPS: 3,
+    ACCEL_CALLS: 4, DENOM_CLAMPS: 5,
+    DRAG_UPDATES: 6, DRAG_SATURATIONS: 7,
+    DRIFT_PER_S: 8,
+    LEN: 9,
+};
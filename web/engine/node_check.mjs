@@ -0,0 +1,270 @@
+// Headless check of the physics worker protocol under Node:
+//   node web/engine/node_check.mjs [seconds] [--require-wasm]
+//
+// 1. Ring: a producer thread pushes 200k records through a 64-slot ring whose indices
+//    start just below the Int32 wrap; every record must arrive once, in order, intact,
+//    and every failed push must be counted in DROPPED.
+// 2. Loop: runPhysicsLoop in a worker with a stub engine that echoes its inputs, while
+//    this thread sends pointer commands and then stalls for 300 ms. The loop must keep
+//    the wall-clock step rate through the stall (no simulated time lost), publish one
+//    evenly spaced sample per step with no gaps, and apply each command on the first
+//    step due after its timestamp.
+// 3. If web/doubleswing.js loads under Node (a build from CMakeLists.txt), the same
+//    loop with the real engine: a drag of bob 1 by timestamped pointer samples must
+//    bring it to the pointer's angle, and the state must stay finite. With
+//    --require-wasm (CI), a module that does not load is a failure, not a skip.
+// Exits non-zero on failure.
+
+import { Worker, isMainThread, workerData, parentPort } from "node:worker_threads";
+import { createRing, RING } from "./ring.js";
+import { FRAME } from "./layout.js";
+import { CMD, SAMPLE, CONTROL, FIXED_DT, INPUT_CAPACITY, OUTPUT_CAPACITY, createChannels, epochMs, runPhysicsLoop } from "./physics_loop.js";
+
+const RING_RECORDS = 200000;
+const RING_CAPACITY = 64;
+const RING_LEN = 3;
+const STEP_MS = FIXED_DT * 1000;
+
+// Echoes its inputs into the FRAME fields: X1, Y1 = pointer, TH1 = drag mode,
+// W1 = th1 of the last reset, KE = l1, PE = execution time of the step.
+function stubEngine() {
+    const out = new Float64Array(FRAME.LEN);
+    let l1 = 1, resetTh1 = 0;
+    const noop = () => {};
+    return {
+        h: 0,
+        frame(dt, mode, mx, my) {
+            out[FRAME.X1] = mx;
+            out[FRAME.Y1] = my;
+            out[FRAME.TH1] = mode;
+            out[FRAME.W1] = resetTh1;
+            out[FRAME.KE] = l1;
+            out[FRAME.PE] = epochMs();
+            out[FRAME.STEPS] = 1;
+            return out;
+        },
+        resetFrame: noop,
+        stats: () => null,
+        ds_set_l1: (_h, v) => { l1 = v; },
+        ds_set_l2: noop, ds_set_m1: noop, ds_set_m2: noop, ds_set_g: noop, ds_set_damping: noop,
+        ds_reset: (_h, th1) => { resetTh1 = th1; },
+    };
+}
+
+if (!isMainThread) {
+    if (workerData.role === "producer") {
+        const ring = createRing(RING_CAPACITY, RING_LEN, workerData.buffer);
+        const rec = new Float64Array(RING_LEN);
+        let fails = 0;
+        for (let i = 0; i < RING_RECORDS; ) {
+            rec[0] = i; rec[1] = i * 0.5; rec[2] = -i;
+            const tail = ring.tail();
+            if (ring.push(rec)) ++i;
+            else {
+                ++fails;
+                ring.waitForPop(tail, 5);
+            }
+        }
+        parentPort.postMessage({ fails });
+    } else {
+        let engine = stubEngine();
+        let backend = "stub";
+        if (workerData.role === "wasm") {
+            try {
+                const { initEngine } = await import("./wasm.js");
+                engine = await initEngine(workerData.params);
+                backend = "wasm";
+            } catch (err) {
+                parentPort.postMessage({ backend: null, error: String(err?.message ?? err) });
+                process.exit(0);
+            }
+        }
+        parentPort.postMessage({ backend });
+        const steps = runPhysicsLoop(engine, workerData.channels);
+        parentPort.postMessage({ steps });
+    }
+} else {
+    const args = process.argv.slice(2);
+    const requireWasm = args.includes("--require-wasm");
+    const seconds = Number(args.find((a) => !a.startsWith("--")) ?? 1.5);
+    let ok = true;
+    const check = (name, pass, detail) => {
+        ok &&= pass;
+        console.log(`${name.padEnd(34)} ${detail}  ${pass ? "ok" : "FAIL"}`);
+    };
+    const sleep = (ms) => new Promise((r) => setTimeout(r, ms));
+    const message = (w) => new Promise((r) => w.once("message", r));
+
+    // ---- 1. ring protocol ----
+    {
+        const ring = createRing(RING_CAPACITY, RING_LEN);
+        const start = 2 ** 31 - 1000; // wraps to negative indices mid-run
+        Atomics.store(ring.ctrl, RING.HEAD, start | 0);
+        Atomics.store(ring.ctrl, RING.TAIL, start | 0);
+
+        const w = new Worker(new URL(import.meta.url), { workerData: { role: "producer", buffer: ring.buffer } });
+        const done = message(w);
+        const rec = new Float64Array(RING_LEN);
+        let next = 0, bad = 0;
+        const t0 = performance.now();
+        while (next < RING_RECORDS) {
+            if (!ring.pop(rec)) {
+                ring.waitForPush(ring.head(), 5);
+                continue;
+            }
+            if (rec[0] !== next || rec[1] !== next * 0.5 || rec[2] !== -next) ++bad;
+            ++next;
+        }
+        const { fails } = await done;
+        const ms = performance.now() - t0;
+        check("ring: order and payload", bad === 0, `${RING_RECORDS} records, ${bad} bad`);
+        check("ring: empty after drain", ring.size() === 0 && !ring.pop(rec), `size ${ring.size()}`);
+        check("ring: full pushes counted", ring.dropped() === fails, `${fails} full, DROPPED ${ring.dropped()}`);
+        check("ring: indices wrapped", Atomics.load(ring.ctrl, RING.HEAD) < 0, `head ${Atomics.load(ring.ctrl, RING.HEAD)}`);
+        console.log(`ring throughput ${(RING_RECORDS / ms / 1000).toFixed(2)} M records/s`);
+        await w.terminate();
+    }
+
+    // ---- 2. fixed-rate loop through a main-thread stall ----
+    async function runLoop(role, seconds, script) {
+        const channels = createChannels();
+        const input = createRing(INPUT_CAPACITY, CMD.LEN, channels.input);
+        const output = createRing(OUTPUT_CAPACITY, SAMPLE.LEN, channels.output);
+        const control = new Int32Array(channels.control);
+        const params = { l1: 1, l2: 1, m1: 1, m2: 1, g: 9.80665, damping: 0, th1: 2.0, w1: 0, th2: 2.5, w2: 0 };
+
+        const w = new Worker(new URL(import.meta.url), { workerData: { role, channels, params } });
+        const hello = await message(w);
+        if (!hello.backend) {
+            await w.terminate();
+            return { backend: null, error: hello.error };
+        }
+        const finished = message(w);
+
+        const samples = [];
+        const recv = [];
+        const s = new Float64Array(SAMPLE.LEN);
+        const drain = () => {
+            while (output.pop(s)) {
+                samples.push(Float64Array.from(s));
+                recv.push(epochMs());
+            }
+        };
+        const send = (kind, a = 0, b = 0, c = 0, d = 0) => {
+            const rec = Float64Array.of(kind, epochMs(), a, b, c, d);
+            if (!input.push(rec)) throw new Error("input ring full");
+            return rec[1];
+        };
+
+        while (Atomics.load(control, CONTROL.READY) === 0) await sleep(1);
+        const t0 = epochMs();
+        const marks = await script({ send, drain, sleep, t0 });
+        const t1 = epochMs();
+        Atomics.store(control, CONTROL.STOP, 1);
+        Atomics.notify(input.ctrl, RING.HEAD);
+        const { steps } = await finished;
+        drain();
+        await w.terminate();
+        return { backend: hello.backend, samples, recv, marks, steps, elapsed: t1 - t0,
+                 dropped: output.dropped(), skipped: Atomics.load(control, CONTROL.SKIPPED) };
+    }
+
+    {
+        const STALL_MS = 300;
+        const r = await runLoop("stub", seconds, async ({ send, drain, sleep, t0 }) => {
+            const marks = {};
+            const until = async (ms) => {
+                while (epochMs() - t0 < ms) { drain(); await sleep(16); } // ~60 Hz consumer
+            };
+            await until(200);
+            marks.pointer = send(CMD.POINTER, 1, 0.25, 0.75);
+            await until(400);
+            marks.stallStart = epochMs();
+            while (epochMs() - marks.stallStart < STALL_MS) {} // main thread blocked: no draining, no input
+            marks.stallEnd = epochMs();
+            marks.reset = send(CMD.RESET, 1.5, 0, 0, 0);
+            marks.params = send(CMD.PARAMS, 3, 1, 1, 1);
+            await until(seconds * 1000);
+            return marks;
+        });
+
+        const { samples, marks } = r;
+        const expected = Math.floor(r.elapsed / STEP_MS);
+        check("loop: keeps wall-clock rate", Math.abs(r.steps - expected) <= 3,
+              `${r.steps} steps in ${r.elapsed.toFixed(0)} ms (expected ~${expected})`);
+
+        let gaps = 0, uneven = 0;
+        for (let i = 1; i < samples.length; ++i) {
+            if (samples[i][SAMPLE.SEQ] !== samples[i - 1][SAMPLE.SEQ] + 1) ++gaps;
+            if (Math.abs(samples[i][SAMPLE.WALL] - samples[i - 1][SAMPLE.WALL] - STEP_MS) > 1e-3) ++uneven;
+        }
+        check("loop: one sample per step", gaps === 0 && r.dropped === 0 && samples.length === r.steps,
+              `${samples.length} samples, ${gaps} gaps, ${r.dropped} dropped`);
+        check("loop: samples evenly spaced", uneven === 0, `${uneven} uneven`);
+        check("loop: no steps skipped", r.skipped === 0, `${r.skipped} skipped`);
+
+        const inStall = samples.filter((s) => s[SAMPLE.PE] > marks.stallStart && s[SAMPLE.PE] < marks.stallEnd).length;
+        check("loop: steps through main stall", inStall >= 0.8 * (STALL_MS / STEP_MS),
+              `${inStall} steps ran during the ${STALL_MS} ms stall`);
+
+        // each command takes effect on the first step due at or after its timestamp
+        const firstAfter = (pred) => samples.find(pred);
+        const appliedOnTime = (name, stamp, pred) => {
+            const s = firstAfter(pred);
+            const before = s && samples[samples.indexOf(s) - 1];
+            const pass = !!s && s[SAMPLE.WALL] >= stamp && s[SAMPLE.WALL] - stamp <= STEP_MS && !!before && !pred(before);
+            check(`loop: ${name} on its step`, pass,
+                  s ? `due ${(s[SAMPLE.WALL] - stamp).toFixed(2)} ms after stamp` : "never applied");
+        };
+        appliedOnTime("pointer", marks.pointer, (s) => s[FRAME.X1] === 0.25 && s[FRAME.Y1] === 0.75 && s[FRAME.TH1] === 1);
+        appliedOnTime("reset", marks.reset, (s) => s[FRAME.W1] === 1.5);
+        appliedOnTime("params", marks.params, (s) => s[FRAME.KE] === 3);
+
+        // lateness of each step against its due time, and of delivery to this thread
+        const late = samples.map((s) => s[SAMPLE.PE] - s[SAMPLE.WALL]).sort((a, b) => a - b);
+        const p99 = late[Math.floor(0.99 * (late.length - 1))];
+        check("loop: step lateness p99", p99 < 20, `${p99.toFixed(2)} ms (max ${late[late.length - 1].toFixed(2)})`);
+        const lag = r.recv.map((t, i) => t - samples[i][SAMPLE.WALL])
+                          .filter((_, i) => samples[i][SAMPLE.WALL] > marks.stallEnd + 50)
+                          .sort((a, b) => a - b);
+        console.log(`delivery lag after stall: median ${lag[lag.length >> 1].toFixed(1)} ms (consumer polls at ~60 Hz)`);
+    }
+
+    // ---- 3. real engine, when this build of doubleswing.js runs under Node ----
+    {
+        // grab bob 1 (it starts at th1 = 2), sweep the pointer to th1 = pi/2 over 200 ms
+        // in ~4 ms samples, hold it there (still sampled) for ~150 ms, then let go
+        const TARGET = Math.PI / 2;
+        const r = await runLoop("wasm", 0.5, async ({ send, drain, sleep, t0 }) => {
+            const marks = {};
+            while (epochMs() - t0 < 100) { drain(); await sleep(16); }
+            for (let t = epochMs(), u = 0; u < 1; u = (epochMs() - t) / 200) {
+                const th = 2.0 + (TARGET - 2.0) * u;
+                send(CMD.POINTER, 1, Math.sin(th), Math.cos(th));
+                drain();
+                await sleep(4);
+            }
+            while (epochMs() - t0 < 450) {
+                send(CMD.POINTER, 1, Math.sin(TARGET), Math.cos(TARGET));
+                drain();
+                await sleep(4);
+            }
+            marks.release = send(CMD.POINTER, 0, 0, 0);
+            while (epochMs() - t0 < 600) { drain(); await sleep(16); }
+            return marks;
+        });
+        if (!r.backend) {
+            check("wasm: module loads", !requireWasm, `skipped (${r.error})`);
+        } else {
+            const last = r.samples[r.samples.length - 1];
+            const finite = r.samples.every((s) => s.every(Number.isFinite));
+            check("wasm: steps and finite state", r.steps > 0 && finite,
+                  `${r.steps} steps, E = ${last ? last[FRAME.E].toFixed(4) : "-"}`);
+            const held = r.samples.filter((s) => s[SAMPLE.WALL] < r.marks.release).pop();
+            const err = held ? Math.abs(Math.atan2(Math.sin(held[FRAME.TH1] - TARGET), Math.cos(held[FRAME.TH1] - TARGET))) : NaN;
+            check("wasm: drag follows the pointer", err < 0.02, `th1 ${err.toExponential(2)} rad off when released`);
+        }
+    }
+
+    process.exit(ok ? 0 : 1);
+}
@@ -0,0 +1,159 @@
+console.log("init: engine/physics_loop.js");
+
+// Fixed-rate physics loop for the worker (web/engine/physics_worker.js) and the Node
+// harness. The main thread never steps: it pushes timestamped commands into the input
+// ring and draws from timestamped samples in the output ring.
+//
+// Step k is due at start + k * FIXED_DT on the shared wall clock (epochMs), and each
+// command is applied before the first step due at or after its timestamp, so a burst
+// of catch-up steps still sees input at the time it happened. A stalled main thread
+// costs no simulated time; only a worker stalled past MAX_LAG (a suspended tab) skips
+// steps, and those are counted in control[CONTROL.SKIPPED].
+
+import { createRing } from "./ring.js";
+import { FRAME, STATS } from "./layout.js";
+
+export const FIXED_DT = 1 / 240;
+export const MAX_LAG = 1.0; // s of missed steps before the clock is rebased instead
+
+// Input records: [kind, wallMs, a, b, c, d]
+export const CMD = {
+    POINTER: 1,     // a = drag mode (0 none, 1 bob 1, 2 bob 2), b, c = pointer rel. to pivot, m, +y down;
+                    // wallMs is the pointer event's own timestamp
+    PARAMS: 2,      // a..d = l1, l2, m1, m2 (g and damping follow in a PARAMS2)
+    PARAMS2: 3,     // a = g, b = damping
+    RESET: 4,       // a..d = th1, w1, th2, w2
+    FRAME_RESET: 5, // restart the drag filter (after UI changes)
+    STATS_RESET: 6,
+    LEN: 6,
+};
+
+// Output records: the FRAME snapshot after a step, then its timing.
+export const SAMPLE = {
+    ...FRAME,
+    T: FRAME.LEN,        // simulated s since the loop started
+    WALL: FRAME.LEN + 1, // wall clock (epochMs) the step was due
+    SEQ: FRAME.LEN + 2,  // step count; consecutive samples differ by 1 unless the ring was full
+    LEN: FRAME.LEN + 3,
+};
+
+// Int32 words shared by both sides
+export const CONTROL = {
+    STOP: 0,     // main -> worker: leave the loop
+    READY: 1,    // worker -> main: 1 running, -1 failed
+    SKIPPED: 2,  // steps dropped by MAX_LAG rebases
+    LEN: 4,
+};
+
+export const INPUT_CAPACITY = 256;
+export const OUTPUT_CAPACITY = 512; // ~2 s of samples: survives a long main-thread stall
+
+// same clock in every thread (performance.now() has a per-thread origin)
+export function epochMs() {
+    return performance.timeOrigin + performance.now();
+}
+
+// Buffers for one engine; post them to the worker as-is.
+export function createChannels() {
+    return {
+        input: createRing(INPUT_CAPACITY, CMD.LEN).buffer,
+        output: createRing(OUTPUT_CAPACITY, SAMPLE.LEN).buffer,
+        control: new SharedArrayBuffer(CONTROL.LEN * 4),
+        stats: new SharedArrayBuffer(STATS.LEN * 8),
+    };
+}
+
+// engine: initEngine()'s object (needs frame, resetFrame, ds_set_*, ds_reset, stats).
+// With pointer/advance, each POINTER is one drag sample at its own timestamp and every
+// step is placed at its due time, both in seconds since the loop started; with frame
+// alone, the latest pointer is resampled every step.
+// Blocks until control[STOP] is set; returns the number of steps taken.
+export function runPhysicsLoop(engine, channels, { now = epochMs } = {}) {
+    const input = createRing(INPUT_CAPACITY, CMD.LEN, channels.input);
+    const output = createRing(OUTPUT_CAPACITY, SAMPLE.LEN, channels.output);
+    const control = new Int32Array(channels.control);
+    const sharedStats = new Float64Array(channels.stats);
+
+    const stepMs = FIXED_DT * 1000;
+    const cmd = new Float64Array(CMD.LEN);
+    const sample = new Float64Array(SAMPLE.LEN);
+    const pending = []; // commands drained but not yet due
+
+    let mode = 0, mx = 0, my = 0;
+    let start = now();
+    const origin = start; // the engine's clock: seconds since here
+    let k = 0;
+    let statsAt = 0;
+
+    function apply(c) {
+        const h = engine.h;
+        switch (c[0]) {
+            case CMD.POINTER:
+                mode = c[2]; mx = c[3]; my = c[4];
+                engine.pointer?.(mode, mx, my, (c[1] - origin) / 1000);
+                break;
+            case CMD.PARAMS:
+                engine.ds_set_l1(h, c[2]);
+                engine.ds_set_l2(h, c[3]);
+                engine.ds_set_m1(h, c[4]);
+                engine.ds_set_m2(h, c[5]);
+                break;
+            case CMD.PARAMS2:
+                engine.ds_set_g(h, c[2]);
+                engine.ds_set_damping(h, c[3]);
+                break;
+            case CMD.RESET:
+                engine.ds_reset(h, c[2], c[3], c[4], c[5]);
+                break;
+            case CMD.FRAME_RESET:
+                engine.resetFrame();
+                break;
+            case CMD.STATS_RESET:
+                engine.resetStats?.();
+                break;
+        }
+    }
+
+    Atomics.store(control, CONTROL.READY, 1);
+    Atomics.notify(control, CONTROL.READY);
+
+    while (Atomics.load(control, CONTROL.STOP) === 0) {
+        while (input.pop(cmd)) pending.push(Float64Array.from(cmd));
+
+        let due = Math.floor((now() - start) / stepMs);
+        if (due - k > MAX_LAG / FIXED_DT) {
+            // the worker itself was suspended: rebase rather than replay the gap
+            Atomics.add(control, CONTROL.SKIPPED, due - k);
+            start += (due - k) * stepMs;
+            due = k;
+        }
+
+        for (; k < due; ) {
+            const wall = start + (k + 1) * stepMs;
+            while (pending.length && pending[0][1] <= wall) apply(pending.shift());
+
+            // one fixed step: dt = FIXED_DT runs exactly one substep
+            const out = engine.advance
+                ? engine.advance(FIXED_DT, (wall - origin) / 1000)
+                : engine.frame(FIXED_DT, mode, mx, my);
+            ++k;
+            sample.set(out.subarray(0, FRAME.LEN));
+            sample[SAMPLE.T] = k * FIXED_DT;
+            sample[SAMPLE.WALL] = wall;
+            sample[SAMPLE.SEQ] = k;
+            output.push(sample); // a full ring (main thread gone) drops samples, not time
+        }
+        // commands stamped after the last due step stay pending for the next one
+
+        const t = now();
+        if (t - statsAt > 250) {
+            statsAt = t;
+            const st = engine.stats?.();
+            if (st) sharedStats.set(st);
+        }
+
+        const wait = start + (k + 1) * stepMs - now();
+        if (wait > 0) input.waitForPush(input.head(), wait);
+    }
+    return k;
+}
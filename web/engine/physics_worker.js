@@ -0,0 +1,23 @@
+// Dedicated worker that owns the WASM engine and steps it at a fixed rate
+// (physics_loop.js). Started by worker_engine.js with one message:
+//   { channels, params }  (channels from createChannels())
+// and answers { ok: true } once running, or { ok: false, error } if this build of
+// doubleswing.wasm cannot run here (not built for workers).
+
+import { initEngine } from "./wasm.js";
+import { runPhysicsLoop, CONTROL } from "./physics_loop.js";
+
+self.onmessage = async (e) => {
+    const { channels, params } = e.data;
+    const control = new Int32Array(channels.control);
+    try {
+        const engine = await initEngine(params);
+        self.postMessage({ ok: true });
+        runPhysicsLoop(engine, channels);
+        engine.ds_destroy(engine.h);
+    } catch (err) {
+        Atomics.store(control, CONTROL.READY, -1);
+        self.postMessage({ ok: false, error: String(err?.message ?? err) });
+    }
+    self.close();
+};
@@ -0,0 +1,89 @@
+console.log("init: engine/ring.js");
+
+// Single-producer single-consumer ring of fixed-length Float64 records in a
+// SharedArrayBuffer. Lock-free: the producer only writes HEAD, the consumer only
+// writes TAIL, and both are Atomics (sequentially consistent), so a record's data is
+// visible to the consumer once it sees the HEAD store that published it.
+//
+// Buffer layout: Int32 control words, then capacity * recordLen float64s.
+// HEAD and TAIL count records since creation and wrap at 2^32 (compared with | 0),
+// so a ring never runs out of indices.
+
+export const RING = {
+    HEAD: 0,    // records published (producer)
+    TAIL: 1,    // records consumed (consumer)
+    DROPPED: 2, // push() calls that found the ring full (producer)
+    CTRL_BYTES: 16,
+};
+
+export function ringBytes(capacity, recordLen) {
+    return RING.CTRL_BYTES + capacity * recordLen * 8;
+}
+
+// capacity must be a power of two; buffer is a SharedArrayBuffer of ringBytes() bytes
+// (or undefined to allocate one). Both ends wrap the same buffer with createRing.
+export function createRing(capacity, recordLen, buffer = undefined) {
+    if (capacity <= 0 || (capacity & (capacity - 1)) !== 0) throw new Error("ring capacity must be a power of two");
+    const sab = buffer ?? new SharedArrayBuffer(ringBytes(capacity, recordLen));
+    const ctrl = new Int32Array(sab, 0, RING.CTRL_BYTES / 4);
+    const data = new Float64Array(sab, RING.CTRL_BYTES, capacity * recordLen);
+    const mask = capacity - 1;
+
+    return {
+        buffer: sab,
+        capacity,
+        recordLen,
+        ctrl,
+
+        // Producer: copy rec (recordLen numbers) in; false (and DROPPED + 1) when full.
+        push(rec) {
+            const head = Atomics.load(ctrl, RING.HEAD);
+            if (((head - Atomics.load(ctrl, RING.TAIL)) | 0) >= capacity) {
+                Atomics.add(ctrl, RING.DROPPED, 1);
+                return false;
+            }
+            data.set(rec.length === recordLen ? rec : rec.subarray(0, recordLen), (head & mask) * recordLen);
+            Atomics.store(ctrl, RING.HEAD, (head + 1) | 0);
+            Atomics.notify(ctrl, RING.HEAD);
+            return true;
+        },
+
+        // Consumer: copy the oldest record into out; false when empty.
+        pop(out) {
+            const tail = Atomics.load(ctrl, RING.TAIL);
+            if (tail === Atomics.load(ctrl, RING.HEAD)) return false;
+            const at = (tail & mask) * recordLen;
+            out.set(data.subarray(at, at + recordLen));
+            Atomics.store(ctrl, RING.TAIL, (tail + 1) | 0);
+            Atomics.notify(ctrl, RING.TAIL);
+            return true;
+        },
+
+        size() {
+            return (Atomics.load(ctrl, RING.HEAD) - Atomics.load(ctrl, RING.TAIL)) | 0;
+        },
+
+        dropped() {
+            return Atomics.load(ctrl, RING.DROPPED);
+        },
+
+        // Consumer, off the browser main thread only (Atomics.wait blocks): sleep until
+        // HEAD moves past seenHead or timeoutMs passes.
+        waitForPush(seenHead, timeoutMs) {
+            return Atomics.wait(ctrl, RING.HEAD, seenHead, timeoutMs);
+        },
+
+        // Producer, same restriction: sleep until TAIL moves past seenTail (room freed).
+        waitForPop(seenTail, timeoutMs) {
+            return Atomics.wait(ctrl, RING.TAIL, seenTail, timeoutMs);
+        },
+
+        head() {
+            return Atomics.load(ctrl, RING.HEAD);
+        },
+
+        tail() {
+            return Atomics.load(ctrl, RING.TAIL);
+        },
+    };
+}
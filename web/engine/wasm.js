@@ -2,6 +2,11 @@ console.log("init: engine/wasm.js");
 
 import createModule from "../doubleswing.js";
 
+import { FRAME, STATS } from "./layout.js";
+
+// FRAME / STATS live in layout.js so the physics worker can share them without the module
+export { FRAME, STATS };
+
 export async function initEngine(params) {
     const mod = await createModule();
 
@@ -58,6 +63,20 @@ export async function initEngine(params) {
     const ds_pe = mod.cwrap("ds_pe", "number", ["number"]);
     const ds_energy = mod.cwrap("ds_energy", "number", ["number"]);
 
+    // one-call-per-frame API
+    const ds_frame = mod.cwrap("ds_frame", "number", ["number", "number", "number", "number", "number", "number"]); // h,dt,now,mode,mx,my
+    const ds_frame_buffer = mod.cwrap("ds_frame_buffer", "number", ["number"]);
+    const ds_frame_reset = mod.cwrap("ds_frame_reset", null, ["number"]);
+    const ds_snapshot = mod.cwrap("ds_snapshot", null, ["number"]);
+
+    // ds_frame split into a pointer sample and a step (pointer events, the physics worker)
+    const ds_pointer = mod.cwrap("ds_pointer", null, ["number", "number", "number", "number", "number"]); // h,mode,mx,my,t
+    const ds_advance = mod.cwrap("ds_advance", "number", ["number", "number", "number"]); // h,dt,now
+
+    // instrumentation counters (a build with -DDOUBLESWING_STATS=ON fills them)
+    const ds_stats = mod.cwrap("ds_stats", "number", []);
+    const ds_stats_reset = mod.cwrap("ds_stats_reset", null, []);
+
     const h = ds_create(
         params.l1,
         params.l2,
@@ -71,9 +90,46 @@ export async function initEngine(params) {
         params.w2
     );
 
+    // View onto the handle's output array; rebuilt if memory growth replaced the heap.
+    let outView = null;
+
+    function frameOut() {
+        if (!outView || outView.buffer !== mod.HEAPF64.buffer) {
+            outView = new Float64Array(mod.HEAPF64.buffer, ds_frame_buffer(h), FRAME.LEN);
+        }
+        return outView;
+    }
+
+    // Current positions, angles, omegas and energies in FRAME layout.
+    function snapshot() {
+        ds_snapshot(h);
+        return frameOut();
+    }
+
     return {
         mod,
         h,
+        // per frame: frame(dt, dragMode, mx, my, now) -> FRAME view
+        frame: (dt, dragMode, mx, my, now = performance.now() / 1000) => {
+            ds_frame(h, dt, now, dragMode, mx, my);
+            return frameOut();
+        },
+        // pointer(dragMode, mx, my, t) is one pointer sample taken at t; advance(dt, now)
+        // steps the frame ending at now -> FRAME view. Times in seconds on one clock
+        // (performance.now() / 1000 on the page).
+        pointer: (dragMode, mx, my, t) => ds_pointer(h, dragMode, mx, my, t),
+        advance: (dt, now) => {
+            ds_advance(h, dt, now);
+            return frameOut();
+        },
+        resetFrame: () => ds_frame_reset(h),
+        // stats() -> view in STATS layout, or null when the build has no counters
+        stats: () => {
+            const view = new Float64Array(mod.HEAPF64.buffer, ds_stats(), STATS.LEN);
+            return view[STATS.ENABLED] ? view : null;
+        },
+        resetStats: () => ds_stats_reset(),
+        snapshot,
         // core
         ds_create,
         ds_destroy,
@@ -0,0 +1,156 @@
+console.log("init: engine/worker_engine.js");
+
+// Main-thread side of the physics worker: the same object shape as initEngine()
+// (ds_set_*, ds_reset, snapshot, resetFrame, stats, ...) so controls and the drag
+// controller work unchanged, plus render() for the frame loop. Setters become
+// timestamped commands in the input ring; render() drains the output ring and
+// interpolates between the two samples around (now - RENDER_DELAY_MS), so drawing is
+// smooth at any refresh rate and never steps physics itself.
+
+import { createRing } from "./ring.js";
+import { FRAME, STATS } from "./layout.js";
+import {
+    CMD, SAMPLE, CONTROL, FIXED_DT, INPUT_CAPACITY, OUTPUT_CAPACITY, createChannels, epochMs,
+} from "./physics_loop.js";
+
+// draw one to two steps in the past so there is nearly always a sample on each side
+const RENDER_DELAY_MS = 2 * FIXED_DT * 1000;
+const HISTORY = 8; // samples kept for interpolation
+
+// null when SharedArrayBuffer is unavailable (no cross-origin isolation) or the
+// worker cannot run this build; the caller falls back to initEngine().
+export async function initWorkerEngine(params) {
+    if (!globalThis.crossOriginIsolated || typeof SharedArrayBuffer === "undefined" || typeof Worker === "undefined") {
+        return null;
+    }
+
+    const channels = createChannels();
+    const input = createRing(INPUT_CAPACITY, CMD.LEN, channels.input);
+    const output = createRing(OUTPUT_CAPACITY, SAMPLE.LEN, channels.output);
+    const control = new Int32Array(channels.control);
+    const sharedStats = new Float64Array(channels.stats);
+
+    const worker = new Worker(new URL("./physics_worker.js", import.meta.url), { type: "module" });
+    const started = await new Promise((resolve) => {
+        worker.onmessage = (e) => resolve(e.data);
+        worker.onerror = (e) => resolve({ ok: false, error: e.message });
+        worker.postMessage({ channels, params: { ...params } });
+    });
+    if (!started.ok) {
+        console.warn(`physics worker unavailable (${started.error}); stepping on the main thread`);
+        worker.terminate();
+        return null;
+    }
+
+    // commands that found the ring full wait here, in order
+    const backlog = [];
+    function send(kind, a = 0, b = 0, c = 0, d = 0) {
+        sendAt(epochMs(), kind, a, b, c, d);
+    }
+    function sendAt(wallMs, kind, a = 0, b = 0, c = 0, d = 0) {
+        backlog.push(Float64Array.of(kind, wallMs, a, b, c, d));
+        flush();
+    }
+    function flush() {
+        while (backlog.length && input.push(backlog[0])) backlog.shift();
+    }
+
+    // latest params, so each setter can send the group it belongs to
+    const p = { ...params };
+    const setParam = (key) => (_h, v) => {
+        p[key] = v;
+        if (key === "g" || key === "damping") send(CMD.PARAMS2, p.g, p.damping);
+        else send(CMD.PARAMS, p.l1, p.l2, p.m1, p.m2);
+    };
+
+    const history = Array.from({ length: HISTORY }, () => new Float64Array(SAMPLE.LEN));
+    let count = 0; // samples received so far (history[(count - 1) % HISTORY] is newest)
+    const scratch = new Float64Array(SAMPLE.LEN);
+    const out = new Float64Array(FRAME.LEN);
+
+    function drain() {
+        let n = 0;
+        while (output.pop(scratch)) {
+            history[count % HISTORY].set(scratch);
+            ++count;
+            ++n;
+        }
+        return n;
+    }
+
+    function newest() {
+        return count ? history[(count - 1) % HISTORY] : null;
+    }
+
+    // angle b moved by whole turns to sit next to a
+    function unwrap(a, b) {
+        return a + Math.atan2(Math.sin(b - a), Math.cos(b - a));
+    }
+
+    function interpolate(renderWall) {
+        const m = Math.min(count, HISTORY);
+        let b = newest();
+        let a = b;
+        for (let i = 1; i < m; ++i) {
+            const s = history[(count - 1 - i) % HISTORY];
+            a = s;
+            if (s[SAMPLE.WALL] <= renderWall) break;
+            b = s;
+        }
+        const span = b[SAMPLE.WALL] - a[SAMPLE.WALL];
+        const u = span > 0 ? Math.min(1, Math.max(0, (renderWall - a[SAMPLE.WALL]) / span)) : 1;
+        for (let i = 0; i < FRAME.LEN; ++i) out[i] = a[i] + u * (b[i] - a[i]);
+        for (const i of [FRAME.TH1, FRAME.TH2]) {
+            const th = a[i] + u * (unwrap(a[i], b[i]) - a[i]);
+            out[i] = Math.atan2(Math.sin(th), Math.cos(th));
+        }
+        return out;
+    }
+
+    function snapshot() {
+        drain();
+        const s = newest();
+        if (s) out.set(s.subarray(0, FRAME.LEN));
+        return out;
+    }
+
+    return {
+        h: 0,
+        worker: true,
+        frame: null,
+
+        // one pointer sample taken at t (performance.now() / 1000, e.g. an event's
+        // timeStamp), stamped on the shared wall clock so the worker applies it in order
+        pointer(dragMode, mx, my, t) {
+            sendAt(performance.timeOrigin + t * 1000, CMD.POINTER, dragMode, mx, my);
+        },
+
+        // per rendered frame: the state to draw (physics keeps its own clock)
+        render() {
+            flush();
+            const n = drain();
+            if (!count) return out;
+            const o = interpolate(epochMs() - RENDER_DELAY_MS);
+            o[FRAME.STEPS] = n;
+            return o;
+        },
+
+        resetFrame: () => send(CMD.FRAME_RESET),
+        stats: () => (sharedStats[STATS.ENABLED] ? sharedStats : null),
+        resetStats: () => send(CMD.STATS_RESET),
+        skippedSteps: () => Atomics.load(control, CONTROL.SKIPPED),
+        snapshot,
+
+        ds_destroy() {
+            Atomics.store(control, CONTROL.STOP, 1);
+            Atomics.notify(input.ctrl, 0);
+        },
+        ds_reset: (_h, th1, w1, th2, w2) => send(CMD.RESET, th1, w1, th2, w2),
+        ds_set_l1: setParam("l1"),
+        ds_set_l2: setParam("l2"),
+        ds_set_m1: setParam("m1"),
+        ds_set_m2: setParam("m2"),
+        ds_set_g: setParam("g"),
+        ds_set_damping: setParam("damping"),
+    };
+}
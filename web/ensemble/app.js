@@ -0,0 +1,78 @@
+console.log("init: ensemble/app.js");
+
+// "Thousand pendulums" page: one ensemble of slightly perturbed pendulums, stepped in
+// WASM across the pthread pool, with every bob 2 drawn as a dot coloured by member.
+// Query string: ?n=4096&spread=1e-9
+
+import { loadEnsembleModule, createEnsemble } from "./wasm.js";
+import { makeParams } from "../engine/params.js";
+
+const FIXED_DT = 1 / 240;
+const MAX_FRAME = 1 / 15;
+const MAX_STEPS = 8;
+
+const canvas = document.getElementById("c");
+const ctx = canvas.getContext("2d");
+const statusEl = document.getElementById("status");
+
+const query = new URLSearchParams(location.search);
+const n = Math.max(1, Number(query.get("n") ?? 4096));
+const spread = Number(query.get("spread") ?? 1e-9);
+
+if (!globalThis.crossOriginIsolated) {
+    statusEl.textContent = "SharedArrayBuffer unavailable: serve with COOP/COEP headers (web/ensemble/serve.py).";
+    throw new Error("not cross-origin isolated");
+}
+
+const params = { ...makeParams(), th1: 2.0, th2: 2.5, damping: 0.0 };
+const mod = await loadEnsembleModule();
+const ens = createEnsemble(mod, params, { n, spread });
+
+// one colour per member, precomputed
+const colors = Array.from({ length: n }, (_, i) => `hsl(${(360 * i) / n}, 80%, 60%)`);
+
+function resize() {
+    canvas.width = Math.floor(innerWidth * devicePixelRatio);
+    canvas.height = Math.floor(innerHeight * devicePixelRatio);
+}
+addEventListener("resize", resize);
+resize();
+
+let last = performance.now();
+let acc = 0;
+let stepMs = 0;
+
+function frame(t) {
+    acc = Math.min(acc + Math.min((t - last) / 1000, MAX_FRAME), MAX_STEPS * FIXED_DT);
+    last = t;
+
+    const steps = Math.floor(acc / FIXED_DT);
+    if (steps > 0) {
+        const t0 = performance.now();
+        ens.step(FIXED_DT, steps);
+        stepMs = 0.9 * stepMs + 0.1 * (performance.now() - t0);
+        acc -= steps * FIXED_DT;
+    }
+
+    const w = canvas.width, h = canvas.height;
+    const ox = w * 0.5, oy = h * 0.5;
+    const ppm = (Math.min(w, h) * 0.45) / (params.l1 + params.l2);
+
+    ctx.fillStyle = "rgba(11, 13, 18, 0.35)"; // fade = short trails
+    ctx.fillRect(0, 0, w, h);
+
+    const pos = ens.positions;
+    const r = Math.max(1, devicePixelRatio);
+    for (let i = 0; i < n; i++) {
+        ctx.fillStyle = colors[i];
+        ctx.fillRect(ox + pos[4 * i + 2] * ppm - r, oy + pos[4 * i + 3] * ppm - r, 2 * r, 2 * r);
+    }
+
+    statusEl.textContent =
+        `${n} pendulums, Δθ₂ = ${spread} rad apart\n` +
+        `${ens.backend} on ${ens.threads} threads, ${stepMs.toFixed(2)} ms per frame of physics`;
+
+    requestAnimationFrame(frame);
+}
+
+requestAnimationFrame(frame);
@@ -0,0 +1,73 @@
+// Headless check of the ensemble module under Node:
+//   node web/ensemble/node_check.mjs [members] [seconds]
+//
+// Runs the same ensemble three ways (scalar on one thread, SIMD on one thread, SIMD on
+// every pool worker) and compares bob positions. SIMD must track scalar to ~1e-5 m
+// over a short horizon; thread count must not change the result at all. Also checks
+// that dse_state and dse_set_backend reject out-of-range arguments.
+// Exits non-zero on failure.
+
+import { loadEnsembleModule, createEnsemble } from "./wasm.js";
+
+const members = Number(process.argv[2] ?? 4096);
+const seconds = Number(process.argv[3] ?? 1);
+const FIXED_DT = 1 / 240;
+const STEPS_PER_CALL = 4;
+const TOL = 1e-5;
+
+const params = { l1: 1, l2: 1, m1: 1, m2: 1, g: 9.80665, damping: 0, th1: 2.0, w1: 0, th2: 2.5, w2: 0 };
+
+const mod = await loadEnsembleModule(new URL("../doubleswing_ensemble.mjs", import.meta.url).href);
+
+// handles run one at a time: they share the module's pthread pool
+function run(opts) {
+    const e = createEnsemble(mod, params, { n: members, ...opts });
+    const calls = Math.round(seconds / (FIXED_DT * STEPS_PER_CALL));
+    const t0 = performance.now();
+    for (let i = 0; i < calls; i++) e.step(FIXED_DT, STEPS_PER_CALL);
+    const ms = performance.now() - t0;
+    const out = { pos: Float32Array.from(e.positions), threads: e.threads, backend: e.backend, ms };
+    e.destroy();
+    const rate = (members * calls * STEPS_PER_CALL) / (ms / 1000);
+    console.log(`${out.backend.padEnd(8)} threads=${out.threads}  ${ms.toFixed(1)} ms  ${(rate / 1e6).toFixed(2)} M member-steps/s`);
+    return out;
+}
+
+function maxDiff(a, b) {
+    let d = 0;
+    for (let i = 0; i < a.length; i++) d = Math.max(d, Math.abs(a[i] - b[i]));
+    return d;
+}
+
+const scalar = run({ threads: 1, backend: "scalar" });
+const simd1 = run({ threads: 1 });
+const simdN = run({ threads: 0 });
+
+let ok = true;
+const check = (name, pass, detail) => {
+    ok &&= pass;
+    console.log(`${name.padEnd(28)} ${detail}  ${pass ? "ok" : "FAIL"}`);
+};
+
+check("finite positions", simdN.pos.every(Number.isFinite), "");
+check("simd vs scalar", maxDiff(simd1.pos, scalar.pos) <= TOL, `max |dx| ${maxDiff(simd1.pos, scalar.pos).toExponential(2)}`);
+check("1 thread vs pool", maxDiff(simd1.pos, simdN.pos) === 0, `max |dx| ${maxDiff(simd1.pos, simdN.pos)}`);
+check("backend", simd1.backend === "wasm128", simd1.backend);
+
+// argument checks on a small handle
+{
+    const e = createEnsemble(mod, params, { n: 5, threads: 1 });
+    const h = mod.cwrap("dse_create", "number", Array(13).fill("number"))(5, 1, 1, 1, 1, 1, 9.80665, 0, 2.0, 0, 2.5, 0, 0);
+    const setBackend = mod.cwrap("dse_set_backend", "number", ["number", "number"]);
+    const backendNow = mod.cwrap("dse_backend", "number", ["number"]);
+    const before = backendNow(h);
+    const rejected = setBackend(h, 99) === -1 && setBackend(h, -1) === -1 && backendNow(h) === before;
+    mod.cwrap("dse_destroy", null, ["number"])(h);
+    check("dse_set_backend range", rejected, "99 and -1 rejected, backend unchanged");
+    const s = e.state(4);
+    check("dse_state range", e.state(5) === null && e.state(-1) === null && !!s && s[0] === 2.0,
+          `state(4) = [${s?.map((v) => v.toFixed(3)).join(", ")}]`);
+    e.destroy();
+}
+
+process.exit(ok ? 0 : 1); // pool workers would otherwise keep Node alive
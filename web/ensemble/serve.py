@@ -0,0 +1,33 @@
+"""Static server for web/ with the headers the threaded module needs.
+
+SharedArrayBuffer (and so WASM pthreads) is only available to cross-origin isolated
+pages, which takes COOP/COEP headers that `python -m http.server` does not send.
+
+    python web/ensemble/serve.py [port]      then open http://localhost:8000/ensemble.html
+"""
+import functools
+import http.server
+import os
+import sys
+
+
+class Handler(http.server.SimpleHTTPRequestHandler):
+    extensions_map = {
+        **http.server.SimpleHTTPRequestHandler.extensions_map,
+        ".js": "text/javascript",
+        ".mjs": "text/javascript",
+        ".wasm": "application/wasm",
+    }
+
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        self.send_header("Cross-Origin-Embedder-Policy", "require-corp")
+        super().end_headers()
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    handler = functools.partial(Handler, directory=root)
+    print(f"serving {root} on http://localhost:{port}/ensemble.html")
+    http.server.ThreadingHTTPServer(("", port), handler).serve_forever()
@@ -0,0 +1,62 @@
+console.log("init: ensemble/wasm.js");
+
+// Loader for the SIMD128 + pthreads ensemble module (doubleswing_ensemble.mjs, built with
+// -DDOUBLESWING_WEB_THREADS=ON). Works in browsers with cross-origin isolation
+// (SharedArrayBuffer) and under Node.
+
+export const BACKEND = { auto: 0, scalar: 1, avx2: 2, avx512: 3, wasm128: 4 };
+
+export async function loadEnsembleModule(url = "../doubleswing_ensemble.mjs") {
+    const { default: createModule } = await import(url);
+    return createModule();
+}
+
+// n pendulums starting at params' state, member i with th2 offset by i * spread.
+export function createEnsemble(mod, params, { n, spread = 1e-9, threads = 0, backend = "auto" }) {
+    const dse_create = mod.cwrap("dse_create", "number", [
+        "number", "number",                                         // n, threads
+        "number", "number", "number", "number", "number", "number", // l1, l2, m1, m2, g, damping
+        "number", "number", "number", "number",                     // th1, w1, th2, w2
+        "number",                                                   // spread
+    ]);
+    const dse_destroy = mod.cwrap("dse_destroy", null, ["number"]);
+    const dse_step = mod.cwrap("dse_step", null, ["number", "number", "number"]);
+    const dse_positions = mod.cwrap("dse_positions", "number", ["number"]);
+    const dse_set_backend = mod.cwrap("dse_set_backend", "number", ["number", "number"]);
+    const dse_threads = mod.cwrap("dse_threads", "number", ["number"]);
+    const dse_state = mod.cwrap("dse_state", "number", ["number", "number", "number"]);
+
+    if (!(backend in BACKEND)) throw new Error(`unknown backend "${backend}"`);
+
+    const h = dse_create(
+        n, threads,
+        params.l1, params.l2, params.m1, params.m2, params.g, params.damping,
+        params.th1, params.w1, params.th2, params.w2,
+        spread
+    );
+    if (!h) throw new Error("dse_create failed");
+
+    const backendInUse = dse_set_backend(h, BACKEND[backend]);
+
+    // The module has a fixed heap, so this view stays valid for the handle's lifetime.
+    // Layout: x1, y1, x2, y2 per member (metres, +y down).
+    const positions = new Float32Array(mod.HEAPF32.buffer, dse_positions(h), 4 * n);
+
+    return {
+        n,
+        positions,
+        threads: dse_threads(h),
+        backend: Object.keys(BACKEND).find((k) => BACKEND[k] === backendInUse),
+        step: (dt, steps = 1) => dse_step(h, dt, steps),
+        // member i's [th1, w1, th2, w2], or null if i is out of range
+        state: (i) => {
+            const out = mod._malloc(4 * 8);
+            try {
+                return dse_state(h, i, out) ? Array.from(new Float64Array(mod.HEAPF64.buffer, out, 4)) : null;
+            } finally {
+                mod._free(out);
+            }
+        },
+        destroy: () => dse_destroy(h),
+    };
+}
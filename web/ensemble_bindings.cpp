@@ -0,0 +1,99 @@
+// Batched engine for the "many pendulums" web mode (DOUBLESWING_WEB_THREADS build).
+// One EnsembleEngine stepped across a pthread pool; bob positions for every member are
+// written to a float32 array that JS views directly on the heap.
+#include <doubleswing/ensemble.hpp>
+#include <doubleswing/thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// members per task; a multiple of every SIMD width so blocks never straddle tasks
+constexpr std::size_t TASK_MEMBERS = 256;
+
+// Size of the pthread pool the module is linked with (PTHREAD_POOL_SIZE). Asking for
+// more threads than that would wait on workers that can only start asynchronously.
+#if !defined(DS_WEB_WORKERS)
+#define DS_WEB_WORKERS 4
+#endif
+
+} // namespace
+
+extern "C" {
+
+    struct EnsembleHandle {
+        ds::EnsembleEngine ens;
+        ds::ThreadPool pool;
+        std::vector<float> pos; // x1, y1, x2, y2 per member (metres, +y down)
+
+        EnsembleHandle(const ds::Params& p, std::size_t n, unsigned threads)
+            : ens(p, n), pool(threads), pos(4 * n) {}
+
+        void update_positions(std::size_t b, std::size_t e) {
+            const double l1 = ens.p.l1, l2 = ens.p.l2;
+            for (std::size_t i = b; i < e; ++i) {
+                const double x1 = l1 * std::sin(ens.th1[i]);
+                const double y1 = l1 * std::cos(ens.th1[i]);
+                pos[4 * i + 0] = float(x1);
+                pos[4 * i + 1] = float(y1);
+                pos[4 * i + 2] = float(x1 + l2 * std::sin(ens.th2[i]));
+                pos[4 * i + 3] = float(y1 + l2 * std::cos(ens.th2[i]));
+            }
+        }
+    };
+
+    // n members starting at (th1, w1, th2, w2); member i has th2 offset by i * spread.
+    // threads == 0 uses every worker in the pthread pool. The pool is shared, so keep
+    // the threads of all live handles within DS_WEB_WORKERS.
+    EnsembleHandle* dse_create(int n, int threads,
+                               double l1, double l2, double m1, double m2, double g, double damping,
+                               double th1, double w1, double th2, double w2, double spread) {
+        if (n <= 0) return nullptr;
+        const ds::Params p{l1, l2, m1, m2, g, damping};
+        const int t = threads <= 0 ? DS_WEB_WORKERS : std::min(threads, DS_WEB_WORKERS);
+        auto* h = new EnsembleHandle(p, std::size_t(n), unsigned(t));
+        for (int i = 0; i < n; ++i)
+            h->ens.set_state(std::size_t(i), ds::State{th1, w1, th2 + spread * i, w2});
+        h->update_positions(0, h->ens.size());
+        return h;
+    }
+
+    void dse_destroy(EnsembleHandle* h) { delete h; }
+
+    int dse_size(EnsembleHandle* h) { return int(h->ens.size()); }
+    int dse_threads(EnsembleHandle* h) { return int(h->pool.size()); }
+
+    // 0 auto, 1 scalar, 4 wasm128 (SimdBackend order); returns the backend in use, or
+    // -1 (backend unchanged) for a value that is not a SimdBackend
+    int dse_set_backend(EnsembleHandle* h, int b) {
+        if (b < int(ds::SimdBackend::Auto) || b > int(ds::SimdBackend::Wasm128)) return -1;
+        h->ens.set_backend(static_cast<ds::SimdBackend>(b));
+        return int(h->ens.backend());
+    }
+    int dse_backend(EnsembleHandle* h) { return int(h->ens.backend()); }
+
+    // Heap address of the position array (4 * dse_size floats).
+    float* dse_positions(EnsembleHandle* h) { return h->pos.data(); }
+
+    // Runs `steps` fixed steps of dt, then refreshes the positions; both split across the pool.
+    void dse_step(EnsembleHandle* h, double dt, int steps) {
+        const std::size_t n = h->ens.size();
+        const std::size_t tasks = (n + TASK_MEMBERS - 1) / TASK_MEMBERS;
+        h->pool.parallel_for(tasks, [&](std::size_t t, unsigned) {
+            const std::size_t b = t * TASK_MEMBERS, e = std::min(n, b + TASK_MEMBERS);
+            for (int k = 0; k < steps; ++k) h->ens.step(dt, b, e);
+            h->update_positions(b, e);
+        });
+    }
+
+    // Member i's state into out[0..3] = th1, w1, th2, w2. Returns 0 (out untouched) if
+    // i is not in [0, dse_size) or out is null, 1 otherwise.
+    int dse_state(EnsembleHandle* h, int i, double* out) {
+        if (!out || i < 0 || std::size_t(i) >= h->ens.size()) return 0;
+        const ds::State s = h->ens.state(std::size_t(i));
+        out[0] = s.th1; out[1] = s.w1;
+        out[2] = s.th2; out[3] = s.w2;
+        return 1;
+    }
+}
@@ -3,6 +3,7 @@ console.log("init: gfx/draw.js");
 import { THEME } from "../theme.js";
 import { clamp } from "../utils/math.js";
 import { imageReady, tryRetrySprite } from "./sprites.js";
+import { FRAME } from "../engine/wasm.js";
 
 export function filledCircle(ctx, p, r, fill, outline = THEME.outline()) {
     ctx.beginPath();
@@ -33,8 +34,14 @@ export function drawSpriteOrFallback(ctx, sprite, p, r, angleRad, fallbackFill)
     filledCircle(ctx, p, r, fallbackFill);
 }
 
-export function makeDrawer({ ctx, viewW, viewH, params, engine, sprites }) {
-    return function draw(x1, y1, x2, y2) {
+export function makeDrawer({ ctx, viewW, viewH, params, sprites }) {
+    // out: frame output in FRAME layout (engine.frame / engine.snapshot)
+    return function draw(out) {
+        const x1 = out[FRAME.X1],
+            y1 = out[FRAME.Y1],
+            x2 = out[FRAME.X2],
+            y2 = out[FRAME.Y2];
+
         ctx.clearRect(0, 0, ctx.canvas.width, ctx.canvas.height);
 
         const ox = viewW() * 0.5;
@@ -67,8 +74,8 @@ export function makeDrawer({ ctx, viewW, viewH, params, engine, sprites }) {
         const r1 = clamp(6 + 5 * Math.sqrt(params.m1), 10, 40);
         const r2 = clamp(6 + 5 * Math.sqrt(params.m2), 10, 40);
 
-        const th1v = engine.ds_th1(engine.h);
-        const th2v = engine.ds_th2(engine.h);
+        const th1v = out[FRAME.TH1];
+        const th2v = out[FRAME.TH2];
 
         filledCircle(ctx, p0, 6, THEME.pivot());
         drawSpriteOrFallback(ctx, sprites.bob1, p1, r1, th1v, THEME.bob1());
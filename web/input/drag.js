@@ -1,38 +1,26 @@
 console.log("init: input/drag.js");
 
-import { clamp, thetaFromMouse, unwrapDelta } from "../utils/math.js";
+import { clamp } from "../utils/math.js";
 import { getCanvasPosFromClient } from "../gfx/viewport.js";
+import { FRAME } from "../engine/wasm.js";
 
 export function createDragController({ canvas, viewW, viewH, params, engine, shouldBlockDrag = null }) {
-    // Drag Filter
+    // The rod's angle, omega and alpha are estimated in WASM (ds::DragEstimator) from
+    // the samples collected here.
     let dragging = 0; // 0 none, 1 bob1, 2 bob2
-    let prevTh = 0;
-    let hasPrev = false;
-    let filtOmega = 0;
-
-    // ====FOR TUNING====
-    const ALPHA = 0.18;
-    const OMEGA_MAX = 15.0;
-
-    function updateFilteredOmega(th, dt) {
-        if (!hasPrev) {
-            prevTh = th;
-            filtOmega = 0;
-            hasPrev = true;
-            return 0;
-        }
-        const raw = unwrapDelta(th, prevTh) / dt;
-        prevTh = th;
-
-        const clamped = Math.max(-OMEGA_MAX, Math.min(OMEGA_MAX, raw));
-        filtOmega = ALPHA * clamped + (1 - ALPHA) * filtOmega;
-        return filtOmega;
-    }
 
     // Pointer Events
     let activePointerId = null;
     let lastPointerPos = null;
 
+    // pointer samples since the last takeSamples(): { mode, x, y, t } with canvas px
+    // and the event's own timeStamp (ms, performance.now() clock)
+    const samples = [];
+    function pushSample(mode, e) {
+        const p = getCanvasPosFromClient(canvas, e);
+        samples.push({ mode, x: p.x, y: p.y, t: e.timeStamp });
+    }
+
     function blocked(e) {
         try {
             if (typeof shouldBlockDrag === "function" && shouldBlockDrag(e)) return true;
@@ -70,11 +58,11 @@ export function createDragController({ canvas, viewW, viewH, params, engine, sho
             const denom = Math.max(0.1, params.l1 + params.l2); // prevent extreme scaling
             const ppm = (usable * 0.5) / denom;
 
-            engine.ds_update_positions(engine.h);
-            const x1 = engine.ds_x1(),
-                y1 = engine.ds_y1();
-            const x2 = engine.ds_x2(),
-                y2 = engine.ds_y2();
+            const out = engine.snapshot();
+            const x1 = out[FRAME.X1],
+                y1 = out[FRAME.Y1];
+            const x2 = out[FRAME.X2],
+                y2 = out[FRAME.Y2];
 
             const p1 = { x: ox + x1 * ppm, y: oy + y1 * ppm };
             const p2 = { x: ox + x2 * ppm, y: oy + y2 * ppm };
@@ -90,7 +78,7 @@ export function createDragController({ canvas, viewW, viewH, params, engine, sho
             else if (d1 <= GRAB1) dragging = 1;
             else dragging = 0;
 
-            hasPrev = false; // reset filter
+            if (dragging) pushSample(dragging, e);
             e.preventDefault();
         },
         { passive: false }
@@ -101,6 +89,8 @@ export function createDragController({ canvas, viewW, viewH, params, engine, sho
         (e) => {
             if (e.pointerId !== activePointerId) return;
             lastPointerPos = getCanvasPosFromClient(canvas, e);
+            // every sample the browser merged into this event, each at its own time
+            if (dragging) for (const c of e.getCoalescedEvents?.() ?? [e]) pushSample(dragging, c);
             e.preventDefault();
         },
         { passive: false }
@@ -108,10 +98,10 @@ export function createDragController({ canvas, viewW, viewH, params, engine, sho
 
     function endPointer(e) {
         if (e.pointerId !== activePointerId) return;
+        if (dragging) pushSample(0, e);
         dragging = 0;
         activePointerId = null;
         lastPointerPos = null;
-        hasPrev = false;
         try {
             canvas.releasePointerCapture(e.pointerId);
         } catch {}
@@ -125,15 +115,13 @@ export function createDragController({ canvas, viewW, viewH, params, engine, sho
     return {
         getDragging: () => dragging,
         getLastPointerPos: () => lastPointerPos,
-        resetFilter: () => {
-            hasPrev = false;
-        },
-        updateFilteredOmega,
+        // pointer samples since the last call, oldest first
+        takeSamples: () => samples.splice(0),
         cancelDrag: () => {
+            if (dragging) samples.push({ mode: 0, x: 0, y: 0, t: performance.now() });
             dragging = 0;
             activePointerId = null;
             lastPointerPos = null;
-            hasPrev = false;
         },
     };
 }
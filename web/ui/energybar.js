@@ -1,9 +1,11 @@
 console.log("init: ui/energybar.js");
 
-export function makeEnergyBarUpdater({ engine, els }) {
-    return function updateEnergyBar() {
-        const KE = engine.ds_ke(engine.h);
-        const PE = engine.ds_pe(engine.h);
+import { FRAME } from "../engine/wasm.js";
+
+export function makeEnergyBarUpdater({ els }) {
+    return function updateEnergyBar(out) {
+        const KE = out[FRAME.KE];
+        const PE = out[FRAME.PE];
 
         // Shift PE so "visual PE energy" is >= 0 (stable proportions)
         const E = KE + PE;
@@ -1,16 +1,26 @@
 console.log("init: ui/readout.js");
 
 import { rad2deg } from "../utils/math.js";
+import { FRAME, STATS } from "../engine/wasm.js";
 
-export function makeReadoutUpdater({ ui, params, engine, getDragging }) {
-    return function updateReadout() {
-        // positions already updated in frame()
-        const th1v = engine.ds_th1(engine.h), w1v = engine.ds_w1(engine.h);
-        const th2v = engine.ds_th2(engine.h), w2v = engine.ds_w2(engine.h);
-        const x1 = engine.ds_x1(), y1 = engine.ds_y1(), x2 = engine.ds_x2(), y2 = engine.ds_y2();
-        const ke = engine.ds_ke(engine.h), pe = engine.ds_pe(engine.h);
-        const E = engine.ds_energy(engine.h);
+// getStats (optional) returns the engine counters in STATS layout, or null
+export function makeReadoutUpdater({ ui, params, getDragging, getStats = () => null }) {
+    return function updateReadout(out) {
+        // out: this frame's output in FRAME layout
+        const th1v = out[FRAME.TH1], w1v = out[FRAME.W1];
+        const th2v = out[FRAME.TH2], w2v = out[FRAME.W2];
+        const x1 = out[FRAME.X1], y1 = out[FRAME.Y1], x2 = out[FRAME.X2], y2 = out[FRAME.Y2];
+        const ke = out[FRAME.KE], pe = out[FRAME.PE];
+        const E = out[FRAME.E];
         const dragging = getDragging();
+        const st = getStats();
+        const stats = st
+            ? `
+
+steps: ${st[STATS.STEPS]} (+${st[STATS.DRAG_STEPS]} dragged)  dt clamps: ${st[STATS.DT_CLAMPS]}
+denom clamps: ${st[STATS.DENOM_CLAMPS]}  drag saturations: ${st[STATS.DRAG_SATURATIONS]}/${st[STATS.DRAG_UPDATES]}
+energy drift: ${st[STATS.DRIFT_PER_S].toExponential(2)} J/s`
+            : "";
 
         ui.readout.innerHTML = `
 L1=${params.l1.toFixed(2)}  L2=${params.l2.toFixed(2)}  M1=${params.m1.toFixed(2)}  M2=${params.m2.toFixed(2)}
@@ -24,6 +34,6 @@ x2: ${x2.toFixed(3)}  y2: ${(-y2).toFixed(3)}
 
 Total Energy (J): ${E.toFixed(4)}
 KE (J): ${ke.toFixed(4)}  |  PE (J): ${pe.toFixed(4)}
-Currently dragging: ${dragging === 1 ? "Bob 1" : dragging === 2 ? "Bob 2" : "none"}`.trim();
+Currently dragging: ${dragging === 1 ? "Bob 1" : dragging === 2 ? "Bob 2" : "none"}${stats}`.trim();
     };
 }